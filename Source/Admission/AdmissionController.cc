@@ -0,0 +1,112 @@
+#include "AdmissionController.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace webserver::core {
+
+constexpr auto kDecreaseNumerator = 9;  // limit *= 0.9 on a late start
+constexpr auto kDecreaseDenominator = 10;
+
+AdmissionController::Permit::Permit(
+    AdmissionController &controller,
+    const Clock::time_point admittedAt) noexcept
+    : _controller{&controller}, _admittedAt{admittedAt} {
+}
+
+AdmissionController::Permit::Permit(Permit &&other) noexcept
+    : _controller{std::exchange(other._controller, nullptr)},
+      _admittedAt{other._admittedAt} {
+}
+
+AdmissionController::Permit::~Permit() {
+  if (_controller != nullptr) {
+    _controller->_release();
+  }
+}
+
+void AdmissionController::Permit::start(const Clock::time_point now) noexcept {
+  if (_controller != nullptr) {
+    _controller->_onStarted(now - _admittedAt, now);
+  }
+}
+
+AdmissionController::AdmissionController(const Options &options)
+    : _options{options}, _limit{options.maxLimit} {
+  if (options.minLimit == 0 || options.minLimit > options.maxLimit) {
+    throw std::invalid_argument(
+        "Admission limits must satisfy 0 < minLimit <= maxLimit");
+  }
+}
+
+std::optional<AdmissionController::Permit> AdmissionController::tryAcquire(
+    const Clock::time_point now) noexcept {
+  const auto inFlight{_inFlight.fetch_add(1, std::memory_order_relaxed)};
+
+  if (_options.enabled && inFlight >= _limit.load(std::memory_order_relaxed)) {
+    _inFlight.fetch_sub(1, std::memory_order_relaxed);
+    _shed.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  return Permit{*this, now};
+}
+
+std::size_t AdmissionController::limit() const noexcept {
+  return _limit.load(std::memory_order_relaxed);
+}
+
+std::size_t AdmissionController::inFlight() const noexcept {
+  return _inFlight.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AdmissionController::shedCount() const noexcept {
+  return _shed.load(std::memory_order_relaxed);
+}
+
+void AdmissionController::_onStarted(const Clock::duration queueDelay,
+                                     const Clock::time_point now) noexcept {
+  if (!_options.enabled) {
+    return;
+  }
+
+  auto limit{_limit.load(std::memory_order_relaxed)};
+
+  if (queueDelay > _options.targetDelay) {
+    auto nextDecrease{_nextDecrease.load(std::memory_order_relaxed)};
+    const auto nowTicks{now.time_since_epoch().count()};
+
+    // Only the first late start of an interval backs off.
+    if (nowTicks < nextDecrease ||
+        !_nextDecrease.compare_exchange_strong(
+            nextDecrease,
+            nowTicks + std::chrono::duration_cast<Clock::duration>(
+                           _options.targetDelay)
+                           .count(),
+            std::memory_order_relaxed)) {
+      return;
+    }
+
+    while (!_limit.compare_exchange_weak(
+        limit,
+        std::max(_options.minLimit,
+                 limit * kDecreaseNumerator / kDecreaseDenominator),
+        std::memory_order_relaxed)) {
+    }
+    return;
+  }
+
+  // Growing an idle limit would only let the next spike in unchecked.
+  while (limit < _options.maxLimit &&
+         _inFlight.load(std::memory_order_relaxed) * 2 >= limit &&
+         !_limit.compare_exchange_weak(limit, limit + 1,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void AdmissionController::_release() noexcept {
+  _inFlight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}  // namespace webserver::core
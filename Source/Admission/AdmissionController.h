@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace webserver::core {
+
+// Overload protection in front of a worker pool. Work is admitted only while
+// fewer than `limit()` items are queued or running; everything beyond that
+// is shed right away instead of waiting in an unbounded queue.
+//
+// The limit adapts AIMD-style to the queueing delay observed when a worker
+// picks an item up: a delay above the target shrinks it multiplicatively (at
+// most once per target interval, so one burst of late items does not
+// collapse it), an on-time start grows it by one while the limit is actually
+// being used. It stays within [minLimit, maxLimit]; minLimit is normally the
+// worker count, so the queue is what gets trimmed.
+class AdmissionController {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    bool enabled{true};
+    std::size_t minLimit{1};
+    std::size_t maxLimit{1024};
+    std::chrono::milliseconds targetDelay{100};
+  };
+
+  // Slot of admitted work. start() is called by the worker that picks the
+  // work up; the slot is given back when the permit is destroyed.
+  class Permit {
+   public:
+    Permit(const Permit &) = delete;
+    Permit(Permit &&other) noexcept;
+    Permit &operator=(const Permit &) = delete;
+    Permit &operator=(Permit &&other) = delete;
+    ~Permit();
+
+    void start(Clock::time_point now = Clock::now()) noexcept;
+
+   private:
+    friend class AdmissionController;
+
+    Permit(AdmissionController &controller,
+           Clock::time_point admittedAt) noexcept;
+
+    AdmissionController *_controller;
+    Clock::time_point _admittedAt;
+  };
+
+  explicit AdmissionController(const Options &options);
+  AdmissionController(const AdmissionController &) = delete;
+  AdmissionController(AdmissionController &&) = delete;
+  AdmissionController &operator=(const AdmissionController &) = delete;
+  AdmissionController &operator=(AdmissionController &&) = delete;
+  ~AdmissionController() = default;
+
+  // std::nullopt means the work has to be shed.
+  [[nodiscard]] std::optional<Permit> tryAcquire(
+      Clock::time_point now = Clock::now()) noexcept;
+
+  [[nodiscard]] std::size_t limit() const noexcept;
+  [[nodiscard]] std::size_t inFlight() const noexcept;
+  [[nodiscard]] std::uint64_t shedCount() const noexcept;
+
+ private:
+  void _onStarted(Clock::duration queueDelay, Clock::time_point now) noexcept;
+  void _release() noexcept;
+
+  const Options _options;
+  std::atomic<std::size_t> _limit;
+  std::atomic<std::size_t> _inFlight{0};
+  std::atomic<Clock::rep> _nextDecrease{0};  // Clock ticks since epoch
+  std::atomic<std::uint64_t> _shed{0};
+};
+
+}  // namespace webserver::core
@@ -1,6 +1,10 @@
 #include "Config.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
 
 #include "FileSystemUtils.h"
 #include "IniParser.h"
@@ -18,12 +22,58 @@ Config::Config(const std::filesystem::path& configPath) {
   const auto configMap{iniParser.parse()};
 
   constexpr auto kPortKey{"server.port"};
+  constexpr auto kListenKey{"server.listen"};
   constexpr auto kWorkersKey{"server.workers"};
   constexpr auto kContentDirectoryKey{"server.content_dir"};
+  constexpr auto kServerModeKey{"server.mode"};
+  constexpr auto kSocketBackendKey{"server.socket_backend"};
+  constexpr auto kListenersKey{"server.listeners"};
+  constexpr auto kCpuLocalityKey{"server.cpu_locality"};
+  constexpr auto kWorkerCpusKey{"server.worker_cpus"};
+  constexpr auto kNumaKey{"server.numa"};
+  constexpr auto kStatsIntervalKey{"server.stats_interval"};
+  constexpr auto kZeroCopyThresholdKey{"server.zerocopy_threshold"};
+  constexpr auto kKeepAliveTimeoutKey{"timeouts.keep_alive_ms"};
+  constexpr auto kRequestTimeoutKey{"timeouts.request_ms"};
+  constexpr auto kSendTimeoutKey{"timeouts.send_ms"};
+  constexpr auto kMaxRequestLineKey{"limits.request_line"};
+  constexpr auto kMaxHeaderLineKey{"limits.header_line"};
+  constexpr auto kMaxHeadersSizeKey{"limits.headers_size"};
+  constexpr auto kMaxHeaderCountKey{"limits.header_count"};
+  constexpr auto kMaxBodySizeKey{"limits.body_size"};
+  constexpr auto kPoolMaxWorkersKey{"pool.max_workers"};
+  constexpr auto kPoolGrowDelayKey{"pool.grow_delay_ms"};
+  constexpr auto kPoolIdleTimeoutKey{"pool.idle_timeout_ms"};
+  constexpr auto kBulkPathsKey{"lanes.bulk_paths"};
+  constexpr auto kBulkMethodsKey{"lanes.bulk_methods"};
+  constexpr auto kBulkFileSizeKey{"lanes.bulk_file_size"};
+  constexpr auto kInteractiveWeightKey{"lanes.interactive_weight"};
+  constexpr auto kBulkWeightKey{"lanes.bulk_weight"};
+  constexpr auto kInteractiveReserveKey{"lanes.interactive_reserve"};
+  constexpr auto kAdmissionEnabledKey{"admission.enabled"};
+  constexpr auto kAdmissionMaxQueueKey{"admission.max_queue"};
+  constexpr auto kAdmissionTargetDelayKey{"admission.target_delay_ms"};
+  constexpr auto kRateLimitKey{"rate_limit.enabled"};
+  constexpr auto kRequestsPerSecKey{"rate_limit.requests_per_sec"};
+  constexpr auto kRequestBurstKey{"rate_limit.request_burst"};
+  constexpr auto kConnectionsPerSecKey{"rate_limit.connections_per_sec"};
+  constexpr auto kConnectionBurstKey{"rate_limit.connection_burst"};
+  constexpr auto kRateLimitClientsKey{"rate_limit.max_clients"};
+  constexpr auto kTlsKey{"tls.enabled"};
+  constexpr auto kTlsCertificateKey{"tls.certificate"};
+  constexpr auto kTlsPrivateKeyKey{"tls.private_key"};
+  constexpr auto kTlsKernelOffloadKey{"tls.ktls"};
+  constexpr auto kTlsSessionTicketsKey{"tls.session_tickets"};
+  constexpr auto kHandoffSocketKey{"handoff.socket"};
+  constexpr auto kDrainTimeoutKey{"handoff.drain_timeout_ms"};
+  constexpr std::string_view kAclPrefix{"acl."};
 
   if (configMap.contains(kPortKey)) {
     port = std::stoi(configMap.at(kPortKey));
   }
+  if (configMap.contains(kListenKey)) {
+    listenAddresses = _parseList(configMap.at(kListenKey));
+  }
   if (configMap.contains(kWorkersKey)) {
     threadsCount =
         static_cast<std::uint16_t>(std::stoull(configMap.at(kWorkersKey)));
@@ -31,6 +81,301 @@ Config::Config(const std::filesystem::path& configPath) {
   if (configMap.contains(kContentDirectoryKey)) {
     contentDirectory = configMap.at(kContentDirectoryKey);
   }
+  if (configMap.contains(kServerModeKey)) {
+    serverMode = _parseServerMode(configMap.at(kServerModeKey));
+  }
+  if (configMap.contains(kSocketBackendKey)) {
+    socketBackend = _parseSocketBackend(configMap.at(kSocketBackendKey));
+  }
+  if (configMap.contains(kListenersKey)) {
+    listenersCount = std::stoi(configMap.at(kListenersKey));
+
+    if (listenersCount < 1) {
+      throw std::invalid_argument("server.listeners must be at least 1");
+    }
+  }
+  if (configMap.contains(kCpuLocalityKey)) {
+    cpuLocality = _parseBool(kCpuLocalityKey, configMap.at(kCpuLocalityKey));
+  }
+  if (configMap.contains(kWorkerCpusKey)) {
+    workerCpus = utils::parseCpuList(configMap.at(kWorkerCpusKey));
+  }
+  if (configMap.contains(kNumaKey)) {
+    numaPlacement = _parseBool(kNumaKey, configMap.at(kNumaKey));
+  }
+  if (configMap.contains(kStatsIntervalKey)) {
+    statsIntervalSec = std::stoi(configMap.at(kStatsIntervalKey));
+
+    if (statsIntervalSec < 0) {
+      throw std::invalid_argument("server.stats_interval must not be negative");
+    }
+  }
+  if (configMap.contains(kZeroCopyThresholdKey)) {
+    zeroCopyThreshold = std::stoull(configMap.at(kZeroCopyThresholdKey));
+  }
+  if (configMap.contains(kKeepAliveTimeoutKey)) {
+    keepAliveTimeout = _parseTimeout(kKeepAliveTimeoutKey,
+                                     configMap.at(kKeepAliveTimeoutKey));
+  }
+  if (configMap.contains(kRequestTimeoutKey)) {
+    requestTimeout =
+        _parseTimeout(kRequestTimeoutKey, configMap.at(kRequestTimeoutKey));
+  }
+  if (configMap.contains(kSendTimeoutKey)) {
+    sendTimeout = _parseTimeout(kSendTimeoutKey, configMap.at(kSendTimeoutKey));
+  }
+  if (configMap.contains(kMaxRequestLineKey)) {
+    maxRequestLineSize =
+        _parseLimit(kMaxRequestLineKey, configMap.at(kMaxRequestLineKey));
+  }
+  if (configMap.contains(kMaxHeaderLineKey)) {
+    maxHeaderLineSize =
+        _parseLimit(kMaxHeaderLineKey, configMap.at(kMaxHeaderLineKey));
+  }
+  if (configMap.contains(kMaxHeadersSizeKey)) {
+    maxHeadersSize =
+        _parseLimit(kMaxHeadersSizeKey, configMap.at(kMaxHeadersSizeKey));
+  }
+  if (configMap.contains(kMaxHeaderCountKey)) {
+    maxHeaderCount =
+        _parseLimit(kMaxHeaderCountKey, configMap.at(kMaxHeaderCountKey));
+  }
+  if (configMap.contains(kMaxBodySizeKey)) {
+    maxBodySize = _parseLimit(kMaxBodySizeKey, configMap.at(kMaxBodySizeKey));
+  }
+  if (configMap.contains(kPoolMaxWorkersKey)) {
+    maxThreadsCount = std::stoi(configMap.at(kPoolMaxWorkersKey));
+
+    if (maxThreadsCount != 0 && maxThreadsCount < threadsCount) {
+      throw std::invalid_argument(
+          "pool.max_workers must be 0 or at least server.workers");
+    }
+  }
+  if (configMap.contains(kPoolGrowDelayKey)) {
+    poolGrowDelay =
+        _parseTimeout(kPoolGrowDelayKey, configMap.at(kPoolGrowDelayKey));
+  }
+  if (configMap.contains(kPoolIdleTimeoutKey)) {
+    poolIdleTimeout =
+        _parseTimeout(kPoolIdleTimeoutKey, configMap.at(kPoolIdleTimeoutKey));
+  }
+  if (configMap.contains(kBulkPathsKey)) {
+    bulkPaths = _parseList(configMap.at(kBulkPathsKey));
+
+    if (!std::ranges::all_of(bulkPaths, [](const std::string& path) {
+          return path.starts_with('/');
+        })) {
+      throw std::invalid_argument("lanes.bulk_paths must start with '/'");
+    }
+  }
+  if (configMap.contains(kBulkMethodsKey)) {
+    bulkMethods = _parseList(configMap.at(kBulkMethodsKey));
+  }
+  if (configMap.contains(kBulkFileSizeKey)) {
+    bulkFileSize = std::stoull(configMap.at(kBulkFileSizeKey));
+  }
+  if (configMap.contains(kInteractiveWeightKey)) {
+    interactiveWeight = static_cast<int>(_parseLimit(
+        kInteractiveWeightKey, configMap.at(kInteractiveWeightKey)));
+  }
+  if (configMap.contains(kBulkWeightKey)) {
+    bulkWeight = static_cast<int>(
+        _parseLimit(kBulkWeightKey, configMap.at(kBulkWeightKey)));
+  }
+  if (configMap.contains(kInteractiveReserveKey)) {
+    interactiveReserve = std::stoi(configMap.at(kInteractiveReserveKey));
+
+    if (interactiveReserve < 0) {
+      throw std::invalid_argument(
+          "lanes.interactive_reserve must not be negative");
+    }
+  }
+  if (configMap.contains(kAdmissionEnabledKey)) {
+    admissionControl =
+        _parseBool(kAdmissionEnabledKey, configMap.at(kAdmissionEnabledKey));
+  }
+  if (configMap.contains(kAdmissionMaxQueueKey)) {
+    admissionMaxQueue = std::stoull(configMap.at(kAdmissionMaxQueueKey));
+  }
+  if (configMap.contains(kAdmissionTargetDelayKey)) {
+    admissionTargetDelay = _parseTimeout(
+        kAdmissionTargetDelayKey, configMap.at(kAdmissionTargetDelayKey));
+  }
+  if (configMap.contains(kRateLimitKey)) {
+    rateLimit = _parseBool(kRateLimitKey, configMap.at(kRateLimitKey));
+  }
+  if (configMap.contains(kRequestsPerSecKey)) {
+    requestsPerSec =
+        _parseLimit(kRequestsPerSecKey, configMap.at(kRequestsPerSecKey));
+  }
+  if (configMap.contains(kRequestBurstKey)) {
+    requestBurst =
+        _parseLimit(kRequestBurstKey, configMap.at(kRequestBurstKey));
+  }
+  if (configMap.contains(kConnectionsPerSecKey)) {
+    connectionsPerSec = _parseLimit(kConnectionsPerSecKey,
+                                    configMap.at(kConnectionsPerSecKey));
+  }
+  if (configMap.contains(kConnectionBurstKey)) {
+    connectionBurst =
+        _parseLimit(kConnectionBurstKey, configMap.at(kConnectionBurstKey));
+  }
+  if (configMap.contains(kRateLimitClientsKey)) {
+    rateLimitClients =
+        _parseLimit(kRateLimitClientsKey, configMap.at(kRateLimitClientsKey));
+  }
+
+  if (configMap.contains(kTlsKey)) {
+    tls = _parseBool(kTlsKey, configMap.at(kTlsKey));
+  }
+  if (configMap.contains(kTlsCertificateKey)) {
+    tlsCertificate = configMap.at(kTlsCertificateKey);
+  }
+  if (configMap.contains(kTlsPrivateKeyKey)) {
+    tlsPrivateKey = configMap.at(kTlsPrivateKeyKey);
+  }
+  if (configMap.contains(kTlsKernelOffloadKey)) {
+    tlsKernelOffload =
+        _parseBool(kTlsKernelOffloadKey, configMap.at(kTlsKernelOffloadKey));
+  }
+  if (configMap.contains(kTlsSessionTicketsKey)) {
+    tlsSessionTickets =
+        _parseBool(kTlsSessionTicketsKey, configMap.at(kTlsSessionTicketsKey));
+  }
+  if (tls && (tlsCertificate.empty() || tlsPrivateKey.empty())) {
+    throw std::invalid_argument(
+        "tls.certificate and tls.private_key are required with TLS enabled");
+  }
+
+  if (configMap.contains(kHandoffSocketKey)) {
+    handoffSocket = configMap.at(kHandoffSocketKey);
+  }
+  if (configMap.contains(kDrainTimeoutKey)) {
+    drainTimeout =
+        _parseTimeout(kDrainTimeoutKey, configMap.at(kDrainTimeoutKey));
+  }
+
+  for (const auto& [key, value] : configMap) {
+    if (key.starts_with(kAclPrefix)) {
+      accessRules.push_back(
+          _parseAccessRule(key.substr(kAclPrefix.size()), value));
+    }
+  }
 };
 
+ServerMode Config::_parseServerMode(const std::string& mode) {
+  if (mode == "threads") {
+    return ServerMode::THREADS;
+  }
+  if (mode == "reactor") {
+    return ServerMode::REACTOR;
+  }
+
+  throw std::invalid_argument("server.mode must be 'threads' or 'reactor'");
+}
+
+SocketBackend Config::_parseSocketBackend(const std::string& backend) {
+  if (backend == "posix") {
+    return SocketBackend::POSIX;
+  }
+  if (backend == "io_uring") {
+    return SocketBackend::IO_URING;
+  }
+
+  throw std::invalid_argument(
+      "server.socket_backend must be 'posix' or 'io_uring'");
+}
+
+std::vector<std::string> Config::_parseList(const std::string& value) {
+  std::vector<std::string> entries;
+  std::istringstream stream{value};
+
+  for (std::string entry; std::getline(stream, entry, ',');) {
+    if (entry = utils::trim(entry); !entry.empty()) {
+      entries.push_back(std::move(entry));
+    }
+  }
+
+  return entries;
+}
+
+bool Config::_parseBool(const std::string& key, const std::string& value) {
+  if (value == "true" || value == "on" || value == "1") {
+    return true;
+  }
+  if (value == "false" || value == "off" || value == "0") {
+    return false;
+  }
+
+  throw std::invalid_argument(key + " must be 'true' or 'false'");
+}
+
+std::chrono::milliseconds Config::_parseTimeout(const std::string& key,
+                                                const std::string& value) {
+  const auto milliseconds{std::stoll(value)};
+
+  if (milliseconds <= 0) {
+    throw std::invalid_argument(key + " must be a positive number of ms");
+  }
+
+  return std::chrono::milliseconds{milliseconds};
+}
+
+std::size_t Config::_parseLimit(const std::string& key,
+                                const std::string& value) {
+  const auto limit{std::stoll(value)};
+
+  if (limit <= 0) {
+    throw std::invalid_argument(key + " must be positive");
+  }
+
+  return static_cast<std::size_t>(limit);
+}
+
+AccessRule Config::_parseAccessRule(std::string pathPrefix,
+                                    const std::string& value) {
+  if (!pathPrefix.starts_with('/')) {
+    throw std::invalid_argument("acl paths must start with '/': " +
+                                pathPrefix);
+  }
+
+  AccessRule rule{
+      .pathPrefix = std::move(pathPrefix), .allow = {}, .deny = {}};
+  std::vector<std::string>* target{nullptr};
+
+  std::string spec{value};
+  std::ranges::replace(spec, ',', ' ');
+  std::istringstream tokens{spec};
+
+  for (std::string token; tokens >> token;) {
+    if (token == "allow" || token == "deny") {
+      target = token == "allow" ? &rule.allow : &rule.deny;
+    } else if (target == nullptr) {
+      throw std::invalid_argument("acl." + rule.pathPrefix +
+                                  " must start with 'allow' or 'deny'");
+    } else if (token.starts_with('@')) {
+      const auto list{utils::readFile(token.substr(1))};
+
+      if (!list.has_value()) {
+        throw std::invalid_argument("Unable to read ACL file " +
+                                    token.substr(1));
+      }
+
+      std::istringstream lines{list.value()};
+
+      for (std::string line; std::getline(lines, line);) {
+        line = utils::trim(line);
+
+        if (!line.empty() && !line.starts_with('#')) {
+          target->push_back(std::move(line));
+        }
+      }
+    } else {
+      target->push_back(std::move(token));
+    }
+  }
+
+  return rule;
+}
+
 }  // namespace webserver::config
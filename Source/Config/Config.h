@@ -1,22 +1,184 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 #include "Utils.h"
 
 namespace webserver::config {
 
+// THREADS dedicates a pool worker to each connection for its whole lifetime;
+// REACTOR multiplexes connections on an epoll loop and only hands complete
+// requests to the pool.
+enum class ServerMode : std::uint8_t { THREADS, REACTOR };
+
+// POSIX issues one syscall per send/recv/sendfile; IO_URING batches them
+// through a per-thread ring (Linux only, falls back to POSIX if unavailable).
+enum class SocketBackend : std::uint8_t { POSIX, IO_URING };
+
 static constexpr auto kDefaultPort{8000};
 static const auto kDefaultThreadsCount{utils::getNativeThreadsCount()};
 static constexpr auto kDefaultContentDirectory{"public"};
+// One [acl] entry, `<path prefix> = allow <cidr>... deny <cidr>...`. Tokens
+// are separated by spaces or commas; `@file` pulls in one prefix per line
+// from a file, `all` stands for every address.
+struct AccessRule {
+  std::string pathPrefix;
+  std::vector<std::string> allow;
+  std::vector<std::string> deny;
+};
+
+static constexpr auto kDefaultServerMode{ServerMode::THREADS};
+static constexpr auto kDefaultSocketBackend{SocketBackend::POSIX};
+static constexpr auto kDefaultListenersCount{1};
+static constexpr auto kDefaultCpuLocality{false};
+static constexpr auto kDefaultNumaPlacement{false};
+static constexpr auto kDefaultStatsIntervalSec{0};
+static constexpr std::size_t kDefaultZeroCopyThreshold{0};
+static constexpr auto kDefaultKeepAliveTimeout{std::chrono::milliseconds{5000}};
+static constexpr auto kDefaultRequestTimeout{std::chrono::milliseconds{10000}};
+static constexpr auto kDefaultSendTimeout{std::chrono::milliseconds{5000}};
+static constexpr std::size_t kDefaultMaxRequestLineSize{8 * 1024};
+static constexpr std::size_t kDefaultMaxHeaderLineSize{8 * 1024};
+static constexpr std::size_t kDefaultMaxHeadersSize{32 * 1024};
+static constexpr std::size_t kDefaultMaxHeaderCount{100};
+static constexpr std::size_t kDefaultMaxBodySize{1024 * 1024};
+static constexpr auto kDefaultMaxThreadsCount{0};
+static constexpr auto kDefaultPoolGrowDelay{std::chrono::milliseconds{50}};
+static constexpr auto kDefaultPoolIdleTimeout{
+    std::chrono::milliseconds{30000}};
+static constexpr auto kDefaultInteractiveWeight{8};
+static constexpr auto kDefaultBulkWeight{1};
+static constexpr auto kDefaultInteractiveReserve{1};
+static constexpr auto kDefaultAdmissionControl{true};
+static constexpr std::size_t kDefaultAdmissionMaxQueue{1024};
+static constexpr auto kDefaultAdmissionTargetDelay{
+    std::chrono::milliseconds{100}};
+static constexpr auto kDefaultRateLimit{false};
+static constexpr std::size_t kDefaultRequestsPerSec{100};
+static constexpr std::size_t kDefaultRequestBurst{200};
+static constexpr std::size_t kDefaultConnectionsPerSec{20};
+static constexpr std::size_t kDefaultConnectionBurst{50};
+static constexpr std::size_t kDefaultRateLimitClients{65536};
+static constexpr auto kDefaultTls{false};
+static constexpr auto kDefaultTlsKernelOffload{true};
+static constexpr auto kDefaultTlsSessionTickets{true};
+static constexpr auto kDefaultDrainTimeout{std::chrono::milliseconds{30000}};
 
 class Config {
  public:
   explicit Config(const std::filesystem::path& configPath);
 
   std::uint16_t port{kDefaultPort};
+  // server.listen: comma-separated listen addresses (see net::Endpoint),
+  // e.g. "[::]:8000, unix:/run/webserver.sock". Empty means every address
+  // on `port`, IPv6 and IPv4.
+  std::vector<std::string> listenAddresses;
   int threadsCount{kDefaultThreadsCount};
   std::string contentDirectory{kDefaultContentDirectory};
+  ServerMode serverMode{kDefaultServerMode};
+  SocketBackend socketBackend{kDefaultSocketBackend};
+  int listenersCount{kDefaultListenersCount};
+  // Steer connections to the listener whose threads own the receiving CPU
+  // and pin each shard's threads to those CPUs.
+  bool cpuLocality{kDefaultCpuLocality};
+  // server.worker_cpus: CPU list ("0-7,16-23") the server's threads are
+  // pinned to. Empty means every CPU the process may run on.
+  std::vector<int> workerCpus;
+  // server.numa: give each shard the CPUs of one NUMA node, round-robin over
+  // the nodes, so its threads and the memory they touch stay on that node.
+  bool numaPlacement{kDefaultNumaPlacement};
+  // Period of the stats line printed to stdout, 0 disables it.
+  int statsIntervalSec{kDefaultStatsIntervalSec};
+  // In-memory bodies of at least this many bytes are sent with
+  // MSG_ZEROCOPY (Linux), 0 disables it.
+  std::size_t zeroCopyThreshold{kDefaultZeroCopyThreshold};
+  // [timeouts] section. An idle keep-alive connection is closed after
+  // keepAliveTimeout, a request must arrive in full within requestTimeout of
+  // its first byte, and a response write may stall for at most sendTimeout.
+  std::chrono::milliseconds keepAliveTimeout{kDefaultKeepAliveTimeout};
+  std::chrono::milliseconds requestTimeout{kDefaultRequestTimeout};
+  std::chrono::milliseconds sendTimeout{kDefaultSendTimeout};
+  // [limits] section, in bytes (header_count in headers). Requests crossing
+  // them are answered with 414, 431 or 413 and the connection is closed.
+  std::size_t maxRequestLineSize{kDefaultMaxRequestLineSize};
+  std::size_t maxHeaderLineSize{kDefaultMaxHeaderLineSize};
+  std::size_t maxHeadersSize{kDefaultMaxHeadersSize};
+  std::size_t maxHeaderCount{kDefaultMaxHeaderCount};
+  std::size_t maxBodySize{kDefaultMaxBodySize};
+  // [pool] section. With maxThreadsCount above threadsCount the worker pools
+  // are elastic: they start at threadsCount workers and add one whenever
+  // requests waited poolGrowDelay or longer to be picked up, up to
+  // maxThreadsCount, and retire one after workers sat idle for
+  // poolIdleTimeout. 0 keeps them at threadsCount.
+  int maxThreadsCount{kDefaultMaxThreadsCount};
+  std::chrono::milliseconds poolGrowDelay{kDefaultPoolGrowDelay};
+  std::chrono::milliseconds poolIdleTimeout{kDefaultPoolIdleTimeout};
+  // [lanes] section (reactor mode). Requests whose path starts with one of
+  // bulkPaths, whose method is one of bulkMethods, or that name a file of
+  // at least bulkFileSize bytes (0 disables that rule) are scheduled as bulk
+  // work. Workers take interactiveWeight other requests for every bulkWeight
+  // bulk ones, and bulk requests never occupy the last interactiveReserve
+  // workers of a shard.
+  std::vector<std::string> bulkPaths;
+  std::vector<std::string> bulkMethods;
+  std::size_t bulkFileSize{0};
+  int interactiveWeight{kDefaultInteractiveWeight};
+  int bulkWeight{kDefaultBulkWeight};
+  int interactiveReserve{kDefaultInteractiveReserve};
+  // [admission] section. Each shard admits at most workers + maxQueue
+  // connections (threads) or requests (reactor) at once and shrinks that
+  // towards the worker count while queued work waits longer than
+  // targetDelay; the rest is answered with 503.
+  bool admissionControl{kDefaultAdmissionControl};
+  std::size_t admissionMaxQueue{kDefaultAdmissionMaxQueue};
+  std::chrono::milliseconds admissionTargetDelay{kDefaultAdmissionTargetDelay};
+  // [rate_limit] section. Token buckets per client IP for new connections
+  // and for requests; clients over either rate get 429. Up to
+  // rateLimitClients addresses are tracked, least recently seen go first.
+  bool rateLimit{kDefaultRateLimit};
+  std::size_t requestsPerSec{kDefaultRequestsPerSec};
+  std::size_t requestBurst{kDefaultRequestBurst};
+  std::size_t connectionsPerSec{kDefaultConnectionsPerSec};
+  std::size_t connectionBurst{kDefaultConnectionBurst};
+  std::size_t rateLimitClients{kDefaultRateLimitClients};
+  // [acl] section, answered with 403 when a client is not allowed.
+  std::vector<AccessRule> accessRules;
+  // [tls] section. TCP listeners speak HTTPS with the PEM certificate chain
+  // and key, Unix domain listeners stay plaintext for local proxies.
+  // tlsKernelOffload moves established sessions into kernel TLS so files
+  // are still sent with sendfile(); tlsSessionTickets enables resumption
+  // through stateless tickets next to the server's session cache.
+  bool tls{kDefaultTls};
+  std::filesystem::path tlsCertificate;
+  std::filesystem::path tlsPrivateKey;
+  bool tlsKernelOffload{kDefaultTlsKernelOffload};
+  bool tlsSessionTickets{kDefaultTlsSessionTickets};
+  // [handoff] section. With a control socket path set, a new instance
+  // started with the same configuration takes over the listening sockets of
+  // the running one; the old instance then finishes in-flight requests for
+  // at most drainTimeout and exits.
+  std::filesystem::path handoffSocket;
+  std::chrono::milliseconds drainTimeout{kDefaultDrainTimeout};
+
+ private:
+  [[nodiscard]] static ServerMode _parseServerMode(const std::string& mode);
+  [[nodiscard]] static SocketBackend _parseSocketBackend(
+      const std::string& backend);
+  // Comma-separated entries, trimmed, empty ones dropped.
+  [[nodiscard]] static std::vector<std::string> _parseList(
+      const std::string& value);
+  [[nodiscard]] static bool _parseBool(const std::string& key,
+                                       const std::string& value);
+  [[nodiscard]] static std::chrono::milliseconds _parseTimeout(
+      const std::string& key, const std::string& value);
+  [[nodiscard]] static std::size_t _parseLimit(const std::string& key,
+                                               const std::string& value);
+  [[nodiscard]] static AccessRule _parseAccessRule(std::string pathPrefix,
+                                                   const std::string& value);
 };
 
 }  // namespace webserver::config
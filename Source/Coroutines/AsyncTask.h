@@ -0,0 +1,235 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace webserver::core {
+
+template <class T = void>
+class [[nodiscard]] AsyncTask;
+
+namespace detail {
+
+// Shared part of the AsyncTask promises: lazy start, and on completion a
+// symmetric transfer to whoever awaited the task, so awaiting chains of
+// tasks neither grows the stack nor bounces through a scheduler.
+class AsyncPromiseBase {
+ public:
+  struct FinalAwaiter {
+    [[nodiscard]] bool await_ready() const noexcept {
+      return false;
+    }
+
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) const noexcept {
+      const auto continuation{handle.promise()._continuation};
+      return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {
+    }
+  };
+
+  [[nodiscard]] std::suspend_always initial_suspend() const noexcept {
+    return {};
+  }
+  [[nodiscard]] FinalAwaiter final_suspend() const noexcept {
+    return {};
+  }
+  void unhandled_exception() noexcept {
+    _error = std::current_exception();
+  }
+
+  void setContinuation(const std::coroutine_handle<> continuation) noexcept {
+    _continuation = continuation;
+  }
+
+ protected:
+  void _rethrowIfFailed() const {
+    if (_error) {
+      std::rethrow_exception(_error);
+    }
+  }
+
+ private:
+  std::coroutine_handle<> _continuation;
+  std::exception_ptr _error;
+};
+
+template <class T>
+class AsyncPromise : public AsyncPromiseBase {
+ public:
+  [[nodiscard]] AsyncTask<T> get_return_object() noexcept;
+
+  void return_value(T value) {
+    _value.emplace(std::move(value));
+  }
+
+  [[nodiscard]] T result() {
+    _rethrowIfFailed();
+    return std::move(*_value);
+  }
+
+ private:
+  std::optional<T> _value;
+};
+
+template <>
+class AsyncPromise<void> : public AsyncPromiseBase {
+ public:
+  [[nodiscard]] AsyncTask<void> get_return_object() noexcept;
+
+  void return_void() const noexcept {
+  }
+
+  void result() const {
+    _rethrowIfFailed();
+  }
+};
+
+// Eagerly started, self-destroying coroutine at the root of a task chain.
+struct DetachedTask {
+  struct promise_type {
+    [[nodiscard]] DetachedTask get_return_object() const noexcept {
+      return {};
+    }
+    [[nodiscard]] std::suspend_never initial_suspend() const noexcept {
+      return {};
+    }
+    [[nodiscard]] std::suspend_never final_suspend() const noexcept {
+      return {};
+    }
+    void return_void() const noexcept {
+    }
+    [[noreturn]] void unhandled_exception() const noexcept {
+      std::terminate();
+    }
+  };
+};
+
+}  // namespace detail
+
+// Lazily started coroutine producing a T. Nothing runs until the task is
+// co_awaited (or handed to spawn()/syncWait()); the awaiting coroutine is
+// resumed on whichever thread finishes the task. Exceptions propagate to the
+// awaiter. A task is awaited at most once.
+template <class T>
+class [[nodiscard]] AsyncTask {
+ public:
+  using promise_type = detail::AsyncPromise<T>;
+
+  AsyncTask(const AsyncTask &) = delete;
+  AsyncTask(AsyncTask &&other) noexcept
+      : _handle{std::exchange(other._handle, nullptr)} {
+  }
+  AsyncTask &operator=(const AsyncTask &) = delete;
+  AsyncTask &operator=(AsyncTask &&other) noexcept {
+    if (this != &other) {
+      _destroy();
+      _handle = std::exchange(other._handle, nullptr);
+    }
+
+    return *this;
+  }
+  ~AsyncTask() {
+    _destroy();
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      [[nodiscard]] bool await_ready() const noexcept {
+        return handle.done();
+      }
+
+      std::coroutine_handle<> await_suspend(
+          const std::coroutine_handle<> awaiting) const noexcept {
+        handle.promise().setContinuation(awaiting);
+        return handle;
+      }
+
+      T await_resume() const {
+        return handle.promise().result();
+      }
+    };
+
+    return Awaiter{_handle};
+  }
+
+ private:
+  friend promise_type;
+
+  explicit AsyncTask(const std::coroutine_handle<promise_type> handle) noexcept
+      : _handle{handle} {
+  }
+
+  void _destroy() noexcept {
+    if (_handle) {
+      _handle.destroy();
+      _handle = nullptr;
+    }
+  }
+
+  std::coroutine_handle<promise_type> _handle;
+};
+
+namespace detail {
+
+template <class T>
+AsyncTask<T> AsyncPromise<T>::get_return_object() noexcept {
+  return AsyncTask<T>{std::coroutine_handle<AsyncPromise<T>>::from_promise(
+      *this)};
+}
+
+inline AsyncTask<void> AsyncPromise<void>::get_return_object() noexcept {
+  return AsyncTask<void>{
+      std::coroutine_handle<AsyncPromise<void>>::from_promise(*this)};
+}
+
+inline DetachedTask runDetached(AsyncTask<void> task) {
+  co_await std::move(task);
+}
+
+template <class T>
+DetachedTask runInto(AsyncTask<T> task, std::promise<T> result) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      result.set_value();
+    } else {
+      result.set_value(co_await std::move(task));
+    }
+  } catch (...) {
+    result.set_exception(std::current_exception());
+  }
+}
+
+}  // namespace detail
+
+// Starts `task` on the calling thread and returns at its first suspension
+// (or once it finished). Whoever resumes it carries it on; the frames are
+// freed when it completes. Nothing catches for the caller: an exception
+// escaping `task` terminates the process, as with ThreadPool::submit().
+inline void spawn(AsyncTask<void> task) {
+  detail::runDetached(std::move(task));
+}
+
+// Runs `task` and blocks the calling thread until it completes, possibly on
+// another thread; returns its result or rethrows its exception. A task that
+// never suspends runs entirely on the calling thread.
+template <class T>
+T syncWait(AsyncTask<T> task) {
+  std::promise<T> result;
+  auto future{result.get_future()};
+
+  detail::runInto(std::move(task), std::move(result));
+  return future.get();
+}
+
+}  // namespace webserver::core
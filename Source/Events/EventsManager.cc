@@ -13,6 +13,7 @@ void EventsManager::enableEventsHandlers() {
   #error "Unsupported platform for events handling"
 #endif
   _enableShutdownHandler();
+  _ignoreBrokenPipeSignal();
 }
 
 void EventsManager::_enableShutdownHandler() {
@@ -27,4 +28,14 @@ void EventsManager::_enableShutdownHandler() {
   sigaction(SIGINT, &signalData, nullptr);
 }
 
+void EventsManager::_ignoreBrokenPipeSignal() {
+  // Writing to a connection the peer has already closed must surface as an
+  // EPIPE error on that connection instead of terminating the process.
+  struct sigaction signalData = {};
+  signalData.sa_handler = SIG_IGN;
+
+  sigemptyset(&signalData.sa_mask);
+  sigaction(SIGPIPE, &signalData, nullptr);
+}
+
 }  // namespace webserver::core
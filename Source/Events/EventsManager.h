@@ -8,6 +8,7 @@ class EventsManager {
 
  private:
   static void _enableShutdownHandler();
+  static void _ignoreBrokenPipeSignal();
 };
 
 }  // namespace webserver::core
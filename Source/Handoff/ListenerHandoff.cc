@@ -0,0 +1,285 @@
+#include "ListenerHandoff.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace webserver::net {
+
+constexpr std::string_view kTakeOverMessage{"TAKEOVER"};
+constexpr std::string_view kListenerMessage{"LISTENER "};
+constexpr std::string_view kEndMessage{"END"};
+constexpr std::string_view kReadyMessage{"READY"};
+constexpr std::string_view kControlKey{"control"};
+constexpr std::size_t kMaxMessageSize = 512;
+// How long either side waits for the next message of an exchange. The
+// successor confirms only after creating its pools and listening.
+constexpr auto kReplyTimeout = std::chrono::milliseconds{10'000};
+constexpr auto kConfirmTimeout = std::chrono::milliseconds{30'000};
+
+namespace {
+
+sockaddr_un controlAddress(const std::filesystem::path &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+
+  if (path.native().size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument("Handoff socket path is too long: " +
+                                path.string());
+  }
+
+  std::memcpy(address.sun_path, path.c_str(), path.native().size());
+  return address;
+}
+
+int newControlSocket() {
+  const auto socketFd{::socket(AF_UNIX, SOCK_SEQPACKET, 0)};
+
+  if (socketFd < 0) {
+    throw std::runtime_error("Unable to create handoff socket");
+  }
+
+  ::fcntl(socketFd, F_SETFD, FD_CLOEXEC);
+  return socketFd;
+}
+
+}  // namespace
+
+ListenerHandoff::ListenerHandoff(std::filesystem::path controlPath)
+    : _path{std::move(controlPath)} {
+}
+
+ListenerHandoff::~ListenerHandoff() noexcept {
+  if (_predecessorFd >= 0) {
+    ::close(_predecessorFd);
+  }
+  if (_controlFd >= 0) {
+    ::close(_controlFd);
+  }
+}
+
+ListenerHandoff::Listeners ListenerHandoff::takeOver() {
+  Listeners listeners;
+  _predecessorFd = _connectToPredecessor();
+
+  if (_predecessorFd < 0) {
+    _controlFd = _bindControlSocket();
+    return listeners;
+  }
+
+  try {
+    _send(_predecessorFd, kTakeOverMessage);
+
+    while (true) {
+      auto message{_receive(_predecessorFd, kReplyTimeout)};
+
+      if (message.text == kEndMessage) {
+        break;
+      }
+
+      if (!message.text.starts_with(kListenerMessage) ||
+          message.descriptor < 0) {
+        if (message.descriptor >= 0) {
+          ::close(message.descriptor);
+        }
+        throw std::runtime_error("Malformed handoff message");
+      }
+
+      auto key{message.text.substr(kListenerMessage.size())};
+
+      if (key == kControlKey) {
+        _controlFd = message.descriptor;
+      } else {
+        listeners.insert_or_assign(std::move(key), message.descriptor);
+      }
+    }
+
+    if (_controlFd < 0) {
+      throw std::runtime_error("Handoff did not include the control socket");
+    }
+  } catch (...) {
+    closeAll(listeners);
+    throw;
+  }
+
+  return listeners;
+}
+
+void ListenerHandoff::confirmTakeOver() {
+  if (_predecessorFd < 0) {
+    return;
+  }
+
+  _send(_predecessorFd, kReadyMessage);
+  ::close(_predecessorFd);
+  _predecessorFd = -1;
+}
+
+bool ListenerHandoff::serve(const Listeners &listeners,
+                            const std::chrono::milliseconds timeout) {
+  pollfd pollData{.fd = _controlFd, .events = POLLIN, .revents = 0};
+
+  if (::poll(&pollData, 1, static_cast<int>(timeout.count())) <= 0) {
+    return false;
+  }
+
+  const auto successorFd{::accept(_controlFd, nullptr, nullptr)};
+
+  if (successorFd < 0) {
+    return false;
+  }
+
+  ::fcntl(successorFd, F_SETFD, FD_CLOEXEC);
+
+  // A successor that goes away or never confirms leaves this instance in
+  // charge; it holds copies of the descriptors, nothing was given up yet.
+  bool confirmed{false};
+
+  try {
+    if (_receive(successorFd, kReplyTimeout).text == kTakeOverMessage) {
+      for (const auto &[key, descriptor] : listeners) {
+        _send(successorFd, std::string{kListenerMessage} + key, descriptor);
+      }
+
+      _send(successorFd,
+            std::string{kListenerMessage} + std::string{kControlKey},
+            _controlFd);
+      _send(successorFd, kEndMessage);
+
+      confirmed = _receive(successorFd, kConfirmTimeout).text == kReadyMessage;
+    }
+  } catch (const std::exception &) {
+    confirmed = false;
+  }
+
+  ::close(successorFd);
+  return confirmed;
+}
+
+void ListenerHandoff::closeAll(Listeners &listeners) noexcept {
+  for (const auto &[key, descriptor] : listeners) {
+    ::close(descriptor);
+  }
+
+  listeners.clear();
+}
+
+int ListenerHandoff::_connectToPredecessor() const {
+  const auto address{controlAddress(_path)};
+  const auto socketFd{newControlSocket()};
+
+  if (::connect(socketFd, reinterpret_cast<const sockaddr *>(&address),
+                sizeof(address)) == 0) {
+    return socketFd;
+  }
+
+  const auto error{errno};
+  ::close(socketFd);
+
+  // No file, or a file nobody listens on: this is the first instance.
+  if (error == ENOENT || error == ECONNREFUSED) {
+    return -1;
+  }
+
+  throw std::runtime_error("Unable to reach handoff socket " + _path.string() +
+                           ": " + std::strerror(error));
+}
+
+int ListenerHandoff::_bindControlSocket() const {
+  const auto address{controlAddress(_path)};
+  const auto socketFd{newControlSocket()};
+
+  ::unlink(_path.c_str());  // stale, nobody answered on it
+
+  if (::bind(socketFd, reinterpret_cast<const sockaddr *>(&address),
+             sizeof(address)) < 0 ||
+      ::listen(socketFd, 1) < 0) {
+    ::close(socketFd);
+    throw std::runtime_error("Unable to bind handoff socket " +
+                             _path.string());
+  }
+
+  return socketFd;
+}
+
+void ListenerHandoff::_send(const int socketFd, const std::string_view text,
+                            const int descriptor) {
+  iovec payload{.iov_base = const_cast<char *>(text.data()),
+                .iov_len = text.size()};
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+
+  msghdr message{};
+  message.msg_iov = &payload;
+  message.msg_iovlen = 1;
+
+  if (descriptor >= 0) {
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    auto *header{CMSG_FIRSTHDR(&message)};
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header), &descriptor, sizeof(int));
+  }
+
+  if (::sendmsg(socketFd, &message, MSG_NOSIGNAL) !=
+      static_cast<ssize_t>(text.size())) {
+    throw std::runtime_error("Unable to send handoff message");
+  }
+}
+
+ListenerHandoff::Message ListenerHandoff::_receive(
+    const int socketFd, const std::chrono::milliseconds timeout) {
+  pollfd pollData{.fd = socketFd, .events = POLLIN, .revents = 0};
+
+  if (::poll(&pollData, 1, static_cast<int>(timeout.count())) <= 0) {
+    throw std::runtime_error("Timed out waiting for handoff peer");
+  }
+
+  std::array<char, kMaxMessageSize> buffer{};
+  iovec payload{.iov_base = buffer.data(), .iov_len = buffer.size()};
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+
+  msghdr message{};
+  message.msg_iov = &payload;
+  message.msg_iovlen = 1;
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+
+  const auto bytesReceived{::recvmsg(socketFd, &message, 0)};
+
+  if (bytesReceived <= 0) {
+    throw std::runtime_error("Handoff peer closed the connection");
+  }
+
+  Message result{.text = std::string(buffer.data(),
+                                     static_cast<std::size_t>(bytesReceived)),
+                 .descriptor = -1};
+
+  for (auto *header{CMSG_FIRSTHDR(&message)}; header != nullptr;
+       header = CMSG_NXTHDR(&message, header)) {
+    if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+      std::memcpy(&result.descriptor, CMSG_DATA(header), sizeof(int));
+      ::fcntl(result.descriptor, F_SETFD, FD_CLOEXEC);
+    }
+  }
+
+  if ((message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+    if (result.descriptor >= 0) {
+      ::close(result.descriptor);
+    }
+    throw std::runtime_error("Oversized handoff message");
+  }
+
+  return result;
+}
+
+}  // namespace webserver::net
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace webserver::net {
+
+// Zero-downtime upgrades by passing listening sockets between processes.
+// The running server listens on a Unix domain control socket; a new
+// instance started with the same configuration connects to it and receives
+// every listening socket (and the control socket, for the next upgrade)
+// through SCM_RIGHTS, so the kernel accept queues survive the switch. The
+// old instance only lets go once the new one reports that it is listening;
+// then it drains in-flight requests and exits. If the new instance fails
+// before that, the old one keeps serving.
+//
+// Messages are SOCK_SEQPACKET datagrams:
+//   new -> old  TAKEOVER
+//   old -> new  LISTENER <key>   carrying one descriptor, once per socket
+//   old -> new  END
+//   new -> old  READY
+class ListenerHandoff {
+ public:
+  // Descriptors by key; the server names them "<shard> <endpoint>".
+  using Listeners = std::unordered_map<std::string, int>;
+
+  explicit ListenerHandoff(std::filesystem::path controlPath);
+
+  ListenerHandoff(const ListenerHandoff &) = delete;
+  ListenerHandoff(ListenerHandoff &&) = delete;
+  ListenerHandoff &operator=(const ListenerHandoff &) = delete;
+  ListenerHandoff &operator=(ListenerHandoff &&) = delete;
+  // Closes the control socket but leaves its file: a stale one is replaced
+  // by the next takeOver().
+  ~ListenerHandoff() noexcept;
+
+  // New instance, before binding anything: receives the listeners of the
+  // instance serving on the control socket, or binds the control socket
+  // when there is none (the result is empty then). Throws
+  // std::runtime_error if a predecessor answers but the exchange fails.
+  [[nodiscard]] Listeners takeOver();
+  // New instance, once all its listeners are listening: tells the
+  // predecessor to let go of them. No-op without a predecessor.
+  void confirmTakeOver();
+  // Running instance: waits up to `timeout` for a successor and hands it
+  // `listeners`. Returns true once the successor has confirmed; the caller
+  // must stop accepting then.
+  [[nodiscard]] bool serve(const Listeners &listeners,
+                           std::chrono::milliseconds timeout);
+
+  static void closeAll(Listeners &listeners) noexcept;
+
+ private:
+  struct Message {
+    std::string text;
+    int descriptor{-1};
+  };
+
+  [[nodiscard]] int _connectToPredecessor() const;
+  [[nodiscard]] int _bindControlSocket() const;
+  static void _send(int socketFd, std::string_view text, int descriptor = -1);
+  [[nodiscard]] static Message _receive(int socketFd,
+                                        std::chrono::milliseconds timeout);
+
+  std::filesystem::path _path;
+  int _controlFd{-1};      // listening control socket
+  int _predecessorFd{-1};  // open between takeOver() and confirmTakeOver()
+};
+
+}  // namespace webserver::net
@@ -45,6 +45,8 @@ using HeadersType = std::unordered_map<std::string, std::string>;
   X(414, URI_TOO_LONG, "URI Too Long")                                   \
   X(415, UNSUPPORTED_MEDIA_TYPE, "Unsupported Media Type")               \
   X(429, TOO_MANY_REQUESTS, "Too Many Requests")                         \
+  X(431, REQUEST_HEADER_FIELDS_TOO_LARGE,                                \
+    "Request Header Fields Too Large")                                   \
                                                                          \
   X(500, INTERNAL_SERVER_ERROR, "Internal Server Error")                 \
   X(501, NOT_IMPLEMENTED, "Not Implemented")                             \
@@ -68,7 +70,7 @@ using CodeToReasonMapType =
 
 #define X(numCode, status, reasonPhrase) \
   {StatusCode::HTTP_##numCode##_##status, reasonPhrase},
-inline CodeToReasonMapType getStatusCodeToReasonPhraseMap() {
+inline const CodeToReasonMapType &getStatusCodeToReasonPhraseMap() {
   static const CodeToReasonMapType statusCodeToReason = {
       LIST_OF_HTTP_STATUS_CODES};
 
@@ -92,7 +94,7 @@ enum class HttpMethod : std::uint8_t { LIST_OF_HTTP_METHODS };
 using StrToMethodMapType = std::unordered_map<std::string_view, HttpMethod>;
 
 #define X(method) {std::string_view(#method), HttpMethod::method},
-inline StrToMethodMapType getStrToMethodMap() {
+inline const StrToMethodMapType &getStrToMethodMap() {
   static const StrToMethodMapType strToMethod = {LIST_OF_HTTP_METHODS};
   return strToMethod;
 }
@@ -1,107 +1,80 @@
 #include <HttpHeadersParser.h>
 
+#include <stdexcept>
+#include <string>
 #include <utility>
 
+#include "HttpScanner.h"
 #include "ParsingUtils.h"
-#include <stdexcept>
 
 namespace webserver::http {
 
 #define INLINE __attribute__((always_inline)) inline
 
+constexpr std::string_view kCRLF = "\r\n";
+
 HttpHeadersParser::HttpHeadersParser(const std::string_view headers)
     : _headers{headers} {
 }
 
-constexpr char kCR = '\r';
-
-enum class HttpHeadersParsingState : std::uint8_t {
-  HEADER_NAME,
-  COLON,
-  SPACES_AFTER_COLON,
-  HEADER_VALUE,
-  SPACES_AFTER_HEADER_VALUE,
-};
-
-struct HeadersParsingContext {
-  HttpHeadersParsingState state{};
-  std::string nameBuffer;
-  std::string valueBuffer;
-  std::size_t chrIdx{};
-};
-
-void HttpHeadersParser::parse(HttpRequest &outRequest) const {
-  HeadersParsingContext parsingContext{
-      .state = HttpHeadersParsingState::HEADER_NAME,
-      .chrIdx = 0,
-  };
-
-  for (; std::cmp_less(parsingContext.chrIdx, _headers.length());
-       ++parsingContext.chrIdx) {
-    _processHeaderChar(parsingContext, outRequest);
+std::size_t HttpHeadersParser::parse(HttpRequest &outRequest) const {
+  std::size_t lineStart{0};
+
+  while (true) {
+    const auto lineLength{findCrlf(_headers.substr(lineStart))};
+
+    if (lineLength == std::string_view::npos) {
+      throw std::runtime_error(R"(Malformed HTTP request: missing \r\n\r\n)");
+    }
+    if (lineLength == 0) {
+      return lineStart + kCRLF.size();
+    }
+
+    _parseHeaderLine(_headers.substr(lineStart, lineLength), outRequest);
+    lineStart += lineLength + kCRLF.size();
   }
+}
 
-  if (!parsingContext.nameBuffer.empty() &&
-      !parsingContext.valueBuffer.empty()) {
-    outRequest.headers[std::move(parsingContext.nameBuffer)] =
-        std::move(parsingContext.valueBuffer);
+INLINE std::string_view trimSpacesAndTabs(std::string_view value) {
+  while (!value.empty() && utils::isSpaceOrTab(value.front())) {
+    value.remove_prefix(1);
   }
+  while (!value.empty() && utils::isSpaceOrTab(value.back())) {
+    value.remove_suffix(1);
+  }
+
+  return value;
 }
 
-INLINE void HttpHeadersParser::_processHeaderChar(
-    HeadersParsingContext &parsingContext, HttpRequest &outRequest) const {
-  const char chr = _headers.at(parsingContext.chrIdx);
-  switch (parsingContext.state) {
-    case HttpHeadersParsingState::HEADER_NAME:
-      if (utils::isSpaceOrTab(chr)) {
-        throw std::runtime_error("spaces are not allowed in header name");
-      }
-
-      if (chr == ':') {
-        parsingContext.state = HttpHeadersParsingState::COLON;
-        break;
-      }
-
-      parsingContext.nameBuffer +=
-          static_cast<char>(std::tolower(static_cast<std::uint8_t>(chr)));
-      break;
-    case HttpHeadersParsingState::COLON:
-      if (utils::isSpaceOrTab(chr)) {
-        parsingContext.state = HttpHeadersParsingState::SPACES_AFTER_COLON;
-      } else {
-        parsingContext.state = HttpHeadersParsingState::HEADER_VALUE;
-        goto header_value;
-      }
-    case HttpHeadersParsingState::SPACES_AFTER_COLON:
-      if (utils::isSpaceOrTab(chr)) {
-        break;
-      }
-    case HttpHeadersParsingState::HEADER_VALUE:
-    header_value:
-      if (utils::isSpaceOrTab(chr)) {
-        parsingContext.state =
-            HttpHeadersParsingState::SPACES_AFTER_HEADER_VALUE;
-        break;
-      }
-      if (chr == kCR) {
-        goto done;
-      }
-
-      parsingContext.valueBuffer += chr;
-      break;
-    case HttpHeadersParsingState::SPACES_AFTER_HEADER_VALUE:
-      if (utils::isSpaceOrTab(chr)) {
-        break;
-      }
-
-    done:
-      outRequest.headers[std::move(parsingContext.nameBuffer)] =
-          std::move(parsingContext.valueBuffer);
-      parsingContext.nameBuffer.clear();
-      parsingContext.valueBuffer.clear();
-      ++parsingContext.chrIdx;
-      parsingContext.state = HttpHeadersParsingState::HEADER_NAME;
+INLINE void HttpHeadersParser::_parseHeaderLine(const std::string_view line,
+                                                HttpRequest &outRequest) {
+  const auto nameEnd{findNonToken(line)};
+
+  if (nameEnd == line.size() || line[nameEnd] != ':') {
+    if (nameEnd < line.size() && utils::isSpaceOrTab(line[nameEnd])) {
+      throw std::runtime_error("spaces are not allowed in header name");
+    }
+    throw std::runtime_error("invalid character in header name");
+  }
+  if (nameEnd == 0) {
+    throw std::runtime_error("empty header name");
+  }
+
+  const auto value{trimSpacesAndTabs(line.substr(nameEnd + 1))};
+
+  if (findNonFieldValue(value) != value.size()) {
+    throw std::runtime_error("invalid character in header value");
   }
+
+  std::string name{line.substr(0, nameEnd)};
+
+  for (auto &chr : name) {
+    if (utils::isAsciiUppercase(chr)) {
+      chr = static_cast<char>(chr - 'A' + 'a');
+    }
+  }
+
+  outRequest.headers[std::move(name)] = value;
 }
 
 }  // namespace webserver::http
@@ -1,22 +1,23 @@
 #pragma once
 
+#include <cstddef>
 #include <string_view>
 
 #include "HttpRequest.h"
 
 namespace webserver::http {
 
-struct HeadersParsingContext;
-
 class HttpHeadersParser {
  public:
+  // `headers` starts right after the request line and runs at least up to
+  // the empty line ending the headers.
   explicit HttpHeadersParser(std::string_view headers);
 
-  void parse(HttpRequest &outRequest) const;
+  // Returns the offset in `headers` where the body starts.
+  std::size_t parse(HttpRequest &outRequest) const;
 
  private:
-  void _processHeaderChar(HeadersParsingContext &parsingContext,
-                          HttpRequest &outRequest) const;
+  static void _parseHeaderLine(std::string_view line, HttpRequest &outRequest);
 
   std::string_view _headers;
 };
@@ -6,27 +6,36 @@
 
 #include "HttpHeadersParser.h"
 #include "HttpRequestLineParser.h"
+#include "HttpScanner.h"
+#include "ParsingUtils.h"
 
 namespace webserver::http {
 
-constexpr char kCR = '\r';
 constexpr std::string_view kCRLF = "\r\n";
-constexpr std::string_view kDoubleCRLF = "\r\n\r\n";
 
 #define INLINE __attribute__((always_inline)) inline
 
+// One pass over the request: the request line ends at the first CRLF, the
+// headers parser continues from there and reports where the body starts.
 HttpRequest HttpParser::parse() const {
   HttpRequest result;
 
-  HttpRequestLineParser{_getRequestLine()}.parse(result);
-  HttpHeadersParser{_getHeaders()}.parse(result);
-  _parseBody(result);
+  const auto requestLine{_getRequestLine()};
+  HttpRequestLineParser{requestLine}.parse(result);
+
+  const auto headersStart{requestLine.size() + kCRLF.size()};
+  const std::string_view headers{_request.data() + headersStart,
+                                 _request.size() - headersStart};
+  const auto bodyStart{headersStart +
+                       HttpHeadersParser{headers}.parse(result)};
+
+  _parseBody(result, bodyStart);
 
   return result;
 }
 
 INLINE std::string_view HttpParser::_getRequestLine() const {
-  const std::size_t endOfRequestLine = _request.find(kCRLF);
+  const std::size_t endOfRequestLine = findCrlf(_request);
 
   if (endOfRequestLine == std::string::npos) {
     throw std::runtime_error("Expected \\r\\n after request line");
@@ -41,33 +50,16 @@ INLINE std::string_view HttpParser::_getRequestLine() const {
   return requestLine;
 }
 
-INLINE std::string_view HttpParser::_getHeaders() const {
-  auto start = _request.find(kCRLF);
-
-  if (start == std::string::npos) {
-    throw std::runtime_error("Malformed HTTP request: missing CRLF");
-  }
-
-  start += kCRLF.size();
-
-  auto end = _request.find(kDoubleCRLF, start);
-
-  if (end == std::string::npos) {
-    throw std::runtime_error(R"(Malformed HTTP request: missing \r\n\r\n)");
-  }
-
-  return {_request.data() + start, end - start};
-}
-
-void HttpParser::_parseBody(HttpRequest &outRequest) const {
-  const auto bodyStartPosition = _request.find(kDoubleCRLF);
+void HttpParser::_parseBody(HttpRequest &outRequest,
+                            const std::size_t bodyStart) const {
+  const auto contentLength{outRequest.headers.find("content-length")};
 
-  if (bodyStartPosition == std::string::npos) {
-    throw std::runtime_error{R"(Expected \r\n\r\n before body)"};
+  if (contentLength == outRequest.headers.end()) {
+    return;  // no body; anything after the headers is the next request
   }
 
-  const std::size_t bodyPos = bodyStartPosition + kDoubleCRLF.size();
-  outRequest.body = _request.substr(bodyPos);
+  outRequest.body = _request.substr(
+      bodyStart, utils::parseContentLength(contentLength->second));
 }
 
 }  // namespace webserver::http
@@ -16,8 +16,7 @@ class HttpParser {
 
  private:
   [[nodiscard]] std::string_view _getRequestLine() const;
-  [[nodiscard]] std::string_view _getHeaders() const;
-  void _parseBody(HttpRequest &outRequest) const;
+  void _parseBody(HttpRequest &outRequest, std::size_t bodyStart) const;
 
   const std::string _request;
 };
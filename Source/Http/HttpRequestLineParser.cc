@@ -3,8 +3,11 @@
 #include <fmt/core.h>
 
 #include <array>
+#include <bit>
+#include <cstring>
 
 #include "HttpRequest.h"
+#include "HttpScanner.h"
 #include "ParsingUtils.h"
 
 namespace webserver::http {
@@ -77,11 +80,42 @@ enum class StepResult : std::uint8_t { CONTINUE, BREAK };
 
 constexpr auto kPreallocationSize = 128;
 
+// The fast path compares the method and version as whole words; both sides
+// use the host byte order, so no swapping is needed.
+template <class Word, std::size_t Size>
+consteval Word wordOf(const char (&text)[Size]) {
+  static_assert(Size - 1 == sizeof(Word));
+  std::array<char, sizeof(Word)> bytes{};
+
+  for (std::size_t i = 0; i < sizeof(Word); ++i) {
+    bytes[i] = text[i];
+  }
+
+  return std::bit_cast<Word>(bytes);
+}
+
+template <class Word>
+INLINE Word loadWord(const char *data) {
+  Word word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+constexpr auto kGetWord{wordOf<std::uint32_t>("GET ")};
+constexpr auto kHeadWord{wordOf<std::uint32_t>("HEAD")};
+constexpr auto kHttp11Word{wordOf<std::uint64_t>("HTTP/1.1")};
+constexpr std::size_t kVersionSize{sizeof(kHttp11Word)};
+constexpr std::size_t kHeadSize{4};
+
 HttpRequestLineParser::HttpRequestLineParser(const std::string_view requestLine)
     : _requestLine(requestLine) {
 }
 
 void HttpRequestLineParser::parse(HttpRequest &outRequest) {
+  if (_parseCommonForm(outRequest)) {
+    return;
+  }
+
   _context = {
       .state = HttpRequestLineParsingState::METHOD,
   };
@@ -96,6 +130,50 @@ void HttpRequestLineParser::parse(HttpRequest &outRequest) {
   outRequest.httpVersion = _getHttpVersion();
 }
 
+INLINE bool HttpRequestLineParser::_parseCommonForm(
+    HttpRequest &outRequest) const {
+  // Shortest match: "GET / HTTP/1.1".
+  if (_requestLine.size() < sizeof(kGetWord) + 1 + 1 + kVersionSize) {
+    return false;
+  }
+
+  const auto *data{_requestLine.data()};
+  const auto methodWord{loadWord<std::uint32_t>(data)};
+  std::size_t uriStart{0};
+  HttpMethod method{};
+
+  if (methodWord == kGetWord) {
+    uriStart = sizeof(kGetWord);
+    method = HttpMethod::GET;
+  } else if (methodWord == kHeadWord && data[kHeadSize] == ' ') {
+    uriStart = kHeadSize + 1;
+    method = HttpMethod::HEAD;
+  } else {
+    return false;
+  }
+
+  const auto versionStart{_requestLine.size() - kVersionSize};
+
+  if (loadWord<std::uint64_t>(data + versionStart) != kHttp11Word ||
+      data[versionStart - 1] != ' ' || versionStart - 1 <= uriStart) {
+    return false;
+  }
+
+  const auto uri{_requestLine.substr(uriStart, versionStart - 1 - uriStart)};
+
+  // Spaces, tabs and bad bytes all stop here; the state machine then
+  // either accepts the extra whitespace or reports the error.
+  if (findNonUriChar(uri) != uri.size()) {
+    return false;
+  }
+
+  outRequest.method = method;
+  outRequest.uri = uri;
+  outRequest.httpVersion = HttpVersion::HTTP_1_1;
+
+  return true;
+}
+
 INLINE void HttpRequestLineParser::_processChar(HttpRequest &outRequest) {
   switch (_context.state) {
     case HttpRequestLineParsingState::METHOD:
@@ -208,7 +286,7 @@ INLINE StepResult HttpRequestLineParser::_parseUri(HttpRequest &outRequest) {
     return StepResult::BREAK;
   }
 
-  if (!uriSymbolsTable[_context.chr]) {
+  if (!uriSymbolsTable[static_cast<std::uint8_t>(_context.chr)]) {
     throw std::runtime_error("invalid character in uri");
   }
 
@@ -29,6 +29,10 @@ class HttpRequestLineParser {
   void parse(HttpRequest &outRequest);
 
  private:
+  // Handles "GET|HEAD <uri> HTTP/1.1" without the state machine. Returns
+  // false, leaving outRequest untouched, for anything else.
+  [[nodiscard]] bool _parseCommonForm(HttpRequest &outRequest) const;
+
   void _processChar(HttpRequest &outRequest);
 
   StepResult _parseMethod(HttpRequest &outRequest);
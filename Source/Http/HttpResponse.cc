@@ -6,15 +6,41 @@
 
 namespace webserver::http {
 
+const std::string& HttpResponse::prebuilt(const StatusCode statusCode) {
+  using PrebuiltMapType =
+      std::unordered_map<StatusCode, std::string, StatusCodeHash>;
+
+  // No Date header: the bytes are reused for the lifetime of the process.
+  static const PrebuiltMapType responses{[] {
+    PrebuiltMapType result;
+
+    for (const auto& [code, reasonPhrase] : getStatusCodeToReasonPhraseMap()) {
+      result.emplace(
+          code, fmt::format("{} {} {}\r\nContent-Length: 0\r\n"
+                            "Connection: close\r\n\r\n",
+                            kDefaultHttpVersion,
+                            static_cast<std::uint16_t>(code), reasonPhrase));
+    }
+
+    return result;
+  }()};
+
+  return responses.at(statusCode);
+}
+
 std::string HttpResponse::serialize() const {
-  return fmt::format("{}\r\n{}\r\n{}", _generateStatusLine(),
-                     _generateHeadersString(), body.value_or(""));
+  return serializeHead() + body.value_or("");
+}
+
+std::string HttpResponse::serializeHead() const {
+  return fmt::format("{}\r\n{}\r\n", _generateStatusLine(),
+                     _generateHeadersString());
 }
 
 std::string HttpResponse::_generateStatusLine() const {
   return fmt::format("{} {} {}", httpVersion,
                      static_cast<std::uint16_t>(statusCode),
-                     getStatusCodeToReasonPhraseMap()[statusCode]);
+                     getStatusCodeToReasonPhraseMap().at(statusCode));
 }
 
 std::string HttpResponse::_generateHeadersString() const {
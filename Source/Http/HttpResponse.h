@@ -29,7 +29,15 @@ struct HttpResponse {
     return response;
   }
 
+  // Complete, body-less response with "Connection: close" for rejecting a
+  // request. Serialized once per status and shared, so answering abusive
+  // clients costs no formatting or allocation.
+  [[nodiscard]] static const std::string &prebuilt(StatusCode statusCode);
+
   [[nodiscard]] std::string serialize() const;
+  // Status line and headers up to the empty line; the body is sent
+  // separately (writev or a file), Content-Length must then be set by hand.
+  [[nodiscard]] std::string serializeHead() const;
 
   StatusCode statusCode{StatusCode::HTTP_200_OK};
   std::optional<std::string> body;
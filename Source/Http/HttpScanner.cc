@@ -0,0 +1,320 @@
+#include "HttpScanner.h"
+
+#include <array>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  define WEBSERVER_SCAN_X86
+#  include <immintrin.h>
+#endif
+
+namespace webserver::http {
+
+namespace {
+
+// A set of bytes in the form the vector code tests membership with: two
+// shuffles pick a bit mask by each byte's low and high nibble, and the byte
+// is in the set if the masks share a bit. That covers ASCII; all bytes from
+// 0x80 up are either in the set or not.
+struct ByteClass {
+  std::array<std::uint8_t, 16> low{};   // bit h: (h << 4 | index) is in
+  std::array<std::uint8_t, 16> high{};  // 1 << index for ASCII nibbles
+  bool nonAscii{false};
+  std::array<bool, 256> contains{};  // for the scalar code
+};
+
+template <class Predicate>
+consteval ByteClass makeByteClass(const Predicate isMember) {
+  ByteClass result;
+
+  for (unsigned high = 0; high < 8; ++high) {
+    result.high.at(high) = static_cast<std::uint8_t>(1U << high);
+
+    for (unsigned low = 0; low < 16; ++low) {
+      if (isMember((high << 4) | low)) {
+        result.low.at(low) |= static_cast<std::uint8_t>(1U << high);
+      }
+    }
+  }
+
+  result.nonAscii = isMember(0x80);
+
+  for (unsigned chr = 0; chr < 256; ++chr) {
+    result.contains.at(chr) = isMember(chr);
+  }
+
+  return result;
+}
+
+constexpr bool isTokenChar(const unsigned chr) {
+  constexpr std::string_view kTokenSymbols{"!#$%&'*+-.^_`|~"};
+
+  return (chr >= '0' && chr <= '9') || (chr >= 'a' && chr <= 'z') ||
+         (chr >= 'A' && chr <= 'Z') ||
+         (chr < 0x80 && kTokenSymbols.find(static_cast<char>(chr)) !=
+                            std::string_view::npos);
+}
+
+constexpr bool isFieldValueChar(const unsigned chr) {
+  return chr == '\t' || (chr >= 0x20 && chr != 0x7F);
+}
+
+// Unreserved and reserved characters minus '#', '%', '[' and ']', as in
+// the request-line parser's uriSymbolsTable.
+constexpr bool isUriChar(const unsigned chr) {
+  constexpr std::string_view kUriSymbols{"-._~!$&'()*+,;=:@/?"};
+
+  return (chr >= '0' && chr <= '9') || (chr >= 'a' && chr <= 'z') ||
+         (chr >= 'A' && chr <= 'Z') ||
+         (chr < 0x80 && kUriSymbols.find(static_cast<char>(chr)) !=
+                            std::string_view::npos);
+}
+
+constexpr auto kTokenClass{makeByteClass(isTokenChar)};
+constexpr auto kFieldValueClass{makeByteClass(isFieldValueChar)};
+constexpr auto kUriClass{makeByteClass(isUriChar)};
+
+std::size_t findCrlfFrom(const std::string_view data,
+                         const std::size_t from) noexcept {
+  for (auto position{data.find('\r', from)}; position != std::string_view::npos;
+       position = data.find('\r', position + 1)) {
+    if (position + 1 < data.size() && data[position + 1] == '\n') {
+      return position;
+    }
+  }
+
+  return std::string_view::npos;
+}
+
+std::size_t findOutsideScalar(const ByteClass &byteClass,
+                              const std::string_view data,
+                              const std::size_t from = 0) noexcept {
+  for (auto position{from}; position < data.size(); ++position) {
+    if (!byteClass.contains[static_cast<std::uint8_t>(data[position])]) {
+      return position;
+    }
+  }
+
+  return data.size();
+}
+
+std::size_t findCrlfScalar(const std::string_view data) noexcept {
+  return findCrlfFrom(data, 0);
+}
+
+std::size_t findNonTokenScalar(const std::string_view data) noexcept {
+  return findOutsideScalar(kTokenClass, data);
+}
+
+std::size_t findNonFieldValueScalar(const std::string_view data) noexcept {
+  return findOutsideScalar(kFieldValueClass, data);
+}
+
+std::size_t findNonUriCharScalar(const std::string_view data) noexcept {
+  return findOutsideScalar(kUriClass, data);
+}
+
+#ifdef WEBSERVER_SCAN_X86
+
+// The vector functions are compiled for their instruction set only and
+// called through the Scanner table once the CPU is known to support it.
+// Each step needs one byte past the block for the "\n" of a "\r\n"; the
+// last bytes go to the scalar code.
+
+__attribute__((target("sse4.2"))) std::size_t findCrlfSse42(
+    const std::string_view data) noexcept {
+  constexpr std::size_t kStep{16};
+  const auto carriageReturn{_mm_set1_epi8('\r')};
+  const auto lineFeed{_mm_set1_epi8('\n')};
+  std::size_t position{0};
+
+  for (; position + kStep < data.size(); position += kStep) {
+    const auto *bytes{data.data() + position};
+    const auto block{_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes))};
+    const auto next{
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + 1))};
+    const auto matches{static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(block, carriageReturn),
+                      _mm_cmpeq_epi8(next, lineFeed))))};
+
+    if (matches != 0) {
+      return position + std::countr_zero(matches);
+    }
+  }
+
+  return findCrlfFrom(data, position);
+}
+
+__attribute__((target("sse4.2"))) std::size_t findOutsideSse42(
+    const ByteClass &byteClass, const std::string_view data) noexcept {
+  constexpr std::size_t kStep{16};
+  const auto low{
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(byteClass.low.data()))};
+  const auto high{_mm_loadu_si128(
+      reinterpret_cast<const __m128i *>(byteClass.high.data()))};
+  const auto nibble{_mm_set1_epi8(0x0F)};
+  std::size_t position{0};
+
+  for (; position + kStep <= data.size(); position += kStep) {
+    const auto block{_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(data.data() + position))};
+    const auto bits{_mm_and_si128(
+        _mm_shuffle_epi8(low, _mm_and_si128(block, nibble)),
+        _mm_shuffle_epi8(high,
+                         _mm_and_si128(_mm_srli_epi16(block, 4), nibble)))};
+    auto outside{static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(bits, _mm_setzero_si128())))};
+
+    if (byteClass.nonAscii) {
+      outside &= ~static_cast<unsigned>(_mm_movemask_epi8(block));
+    }
+    if (outside != 0) {
+      return position + std::countr_zero(outside);
+    }
+  }
+
+  return findOutsideScalar(byteClass, data, position);
+}
+
+std::size_t findNonTokenSse42(const std::string_view data) noexcept {
+  return findOutsideSse42(kTokenClass, data);
+}
+
+std::size_t findNonFieldValueSse42(const std::string_view data) noexcept {
+  return findOutsideSse42(kFieldValueClass, data);
+}
+
+std::size_t findNonUriCharSse42(const std::string_view data) noexcept {
+  return findOutsideSse42(kUriClass, data);
+}
+
+__attribute__((target("avx2"))) std::size_t findCrlfAvx2(
+    const std::string_view data) noexcept {
+  constexpr std::size_t kStep{32};
+  const auto carriageReturn{_mm256_set1_epi8('\r')};
+  const auto lineFeed{_mm256_set1_epi8('\n')};
+  std::size_t position{0};
+
+  for (; position + kStep < data.size(); position += kStep) {
+    const auto *bytes{data.data() + position};
+    const auto block{
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes))};
+    const auto next{
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + 1))};
+    const auto matches{static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(block, carriageReturn),
+                         _mm256_cmpeq_epi8(next, lineFeed))))};
+
+    if (matches != 0) {
+      return position + std::countr_zero(matches);
+    }
+  }
+
+  return findCrlfFrom(data, position);
+}
+
+__attribute__((target("avx2"))) std::size_t findOutsideAvx2(
+    const ByteClass &byteClass, const std::string_view data) noexcept {
+  constexpr std::size_t kStep{32};
+  // Shuffles stay within 128-bit lanes, so both lanes get the tables.
+  const auto low{_mm256_broadcastsi128_si256(_mm_loadu_si128(
+      reinterpret_cast<const __m128i *>(byteClass.low.data())))};
+  const auto high{_mm256_broadcastsi128_si256(_mm_loadu_si128(
+      reinterpret_cast<const __m128i *>(byteClass.high.data())))};
+  const auto nibble{_mm256_set1_epi8(0x0F)};
+  std::size_t position{0};
+
+  for (; position + kStep <= data.size(); position += kStep) {
+    const auto block{_mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(data.data() + position))};
+    const auto bits{_mm256_and_si256(
+        _mm256_shuffle_epi8(low, _mm256_and_si256(block, nibble)),
+        _mm256_shuffle_epi8(
+            high, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble)))};
+    auto outside{static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(bits, _mm256_setzero_si256())))};
+
+    if (byteClass.nonAscii) {
+      outside &= ~static_cast<unsigned>(_mm256_movemask_epi8(block));
+    }
+    if (outside != 0) {
+      return position + std::countr_zero(outside);
+    }
+  }
+
+  return findOutsideScalar(byteClass, data, position);
+}
+
+std::size_t findNonTokenAvx2(const std::string_view data) noexcept {
+  return findOutsideAvx2(kTokenClass, data);
+}
+
+std::size_t findNonFieldValueAvx2(const std::string_view data) noexcept {
+  return findOutsideAvx2(kFieldValueClass, data);
+}
+
+std::size_t findNonUriCharAvx2(const std::string_view data) noexcept {
+  return findOutsideAvx2(kUriClass, data);
+}
+
+#endif  // WEBSERVER_SCAN_X86
+
+ScanLevel detectScanLevel() noexcept {
+#ifdef WEBSERVER_SCAN_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    return ScanLevel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return ScanLevel::SSE42;
+  }
+#endif
+
+  return ScanLevel::SCALAR;
+}
+
+constexpr Scanner kScalarScanner{.findCrlf = findCrlfScalar,
+                                 .findNonToken = findNonTokenScalar,
+                                 .findNonFieldValue = findNonFieldValueScalar,
+                                 .findNonUriChar = findNonUriCharScalar};
+
+}  // namespace
+
+ScanLevel supportedScanLevel() noexcept {
+  static const auto level{detectScanLevel()};
+  return level;
+}
+
+const Scanner &scannerFor(const ScanLevel level) noexcept {
+#ifdef WEBSERVER_SCAN_X86
+  static constexpr Scanner kSse42Scanner{
+      .findCrlf = findCrlfSse42,
+      .findNonToken = findNonTokenSse42,
+      .findNonFieldValue = findNonFieldValueSse42,
+      .findNonUriChar = findNonUriCharSse42};
+  static constexpr Scanner kAvx2Scanner{
+      .findCrlf = findCrlfAvx2,
+      .findNonToken = findNonTokenAvx2,
+      .findNonFieldValue = findNonFieldValueAvx2,
+      .findNonUriChar = findNonUriCharAvx2};
+
+  switch (level) {
+    case ScanLevel::AVX2:
+      return kAvx2Scanner;
+    case ScanLevel::SSE42:
+      return kSse42Scanner;
+    case ScanLevel::SCALAR:
+      break;
+  }
+#endif
+
+  return kScalarScanner;
+}
+
+const Scanner &scanner() noexcept {
+  static const auto &current{scannerFor(supportedScanLevel())};
+  return current;
+}
+
+}  // namespace webserver::http
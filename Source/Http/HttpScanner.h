@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace webserver::http {
+
+// Instruction set the scanning functions below run on. The best one the CPU
+// supports is picked on first use; SSE4.2 and AVX2 check 16 and 32 bytes per
+// step, the scalar code runs everywhere else.
+enum class ScanLevel : std::uint8_t { SCALAR, SSE42, AVX2 };
+
+// Delimiter and character-class searches over request bytes. Positions are
+// indices into `data`; "not found" is std::string_view::npos for findCrlf()
+// and data.size() for the character-class checks.
+struct Scanner {
+  // First "\r\n".
+  std::size_t (*findCrlf)(std::string_view data) noexcept;
+  // First byte that is not a token character (RFC 9110 tchar), e.g. the
+  // ':' ending a header name.
+  std::size_t (*findNonToken)(std::string_view data) noexcept;
+  // First byte not allowed in a field value: controls other than HTAB.
+  std::size_t (*findNonFieldValue)(std::string_view data) noexcept;
+  // First byte the request-line parser does not accept in a URI.
+  std::size_t (*findNonUriChar)(std::string_view data) noexcept;
+};
+
+[[nodiscard]] ScanLevel supportedScanLevel() noexcept;
+// Implementation for `level`, which must not exceed supportedScanLevel().
+[[nodiscard]] const Scanner &scannerFor(ScanLevel level) noexcept;
+[[nodiscard]] const Scanner &scanner() noexcept;
+
+[[nodiscard]] inline std::size_t findCrlf(
+    const std::string_view data) noexcept {
+  return scanner().findCrlf(data);
+}
+[[nodiscard]] inline std::size_t findNonToken(
+    const std::string_view data) noexcept {
+  return scanner().findNonToken(data);
+}
+[[nodiscard]] inline std::size_t findNonFieldValue(
+    const std::string_view data) noexcept {
+  return scanner().findNonFieldValue(data);
+}
+[[nodiscard]] inline std::size_t findNonUriChar(
+    const std::string_view data) noexcept {
+  return scanner().findNonUriChar(data);
+}
+
+}  // namespace webserver::http
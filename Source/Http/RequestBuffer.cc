@@ -0,0 +1,324 @@
+#include "RequestBuffer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+#include "ParsingUtils.h"
+
+namespace webserver::http {
+
+constexpr std::string_view kEndOfHeaders = "\r\n\r\n";
+constexpr std::string_view kCRLF = "\r\n";
+constexpr std::string_view kContentLength = "content-length";
+constexpr std::string_view kTransferEncoding = "transfer-encoding";
+
+// True if `line` is a header field called `name` (given in lowercase).
+static bool isHeaderLine(const std::string_view line,
+                         const std::string_view name) {
+  return line.size() > name.size() && line.at(name.size()) == ':' &&
+         std::ranges::equal(line.substr(0, name.size()), name,
+                            [](const char lhs, const char rhs) {
+                              return std::tolower(
+                                         static_cast<unsigned char>(lhs)) ==
+                                     rhs;
+                            });
+}
+
+RequestRejected::RequestRejected(const StatusCode statusCode,
+                                 const char *reason)
+    : std::runtime_error{reason}, _statusCode{statusCode} {
+}
+
+StatusCode RequestRejected::statusCode() const noexcept {
+  return _statusCode;
+}
+
+RequestBuffer::RequestBuffer(utils::BufferPool &pool) noexcept : _pool{pool} {
+}
+
+RequestBuffer::~RequestBuffer() {
+  _size = 0;
+  release();
+}
+
+std::span<char> RequestBuffer::prepareWrite(const std::size_t minSize) {
+  if (_capacity - _size < minSize) {
+    _grow(_size + minSize);
+  }
+
+  return {_storage.get() + _size, _capacity - _size};
+}
+
+void RequestBuffer::commitWrite(const std::size_t bytes) noexcept {
+  _size += std::min(bytes, _capacity - _size);
+}
+
+void RequestBuffer::append(const std::string_view data) {
+  const auto space{prepareWrite(data.size())};
+  std::memcpy(space.data(), data.data(), data.size());
+  commitWrite(data.size());
+}
+
+void RequestBuffer::setLimits(const RequestLimits &limits) noexcept {
+  _limits = limits;
+}
+
+std::size_t RequestBuffer::maxBufferedSize() const noexcept {
+  return _limits.maxHeadersSize + _limits.maxBodySize;
+}
+
+bool RequestBuffer::hasCompleteHeaders() noexcept {
+  if (_headersEnd.has_value()) {
+    return true;
+  }
+
+  if (_rejection.has_value()) {
+    return false;
+  }
+
+  const auto data{view()};
+
+  // Walk the lines that arrived since the last call; every byte is looked at
+  // once and each line is checked against the limits as soon as it ends.
+  while (_scanPosition < _size) {
+    const auto *newline{static_cast<const char *>(std::memchr(
+        data.data() + _scanPosition, '\n', _size - _scanPosition))};
+
+    if (newline == nullptr) {
+      _scanPosition = _size;
+      break;
+    }
+
+    const auto lineEnd{static_cast<std::size_t>(newline - data.data()) + 1};
+    _scanPosition = lineEnd;
+
+    if (lineEnd >= kEndOfHeaders.size() &&
+        data.substr(lineEnd - kEndOfHeaders.size(), kEndOfHeaders.size()) ==
+            kEndOfHeaders) {
+      if (lineEnd > _limits.maxHeadersSize) {
+        _reject(StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE,
+                "request headers too large");
+        return false;
+      }
+
+      _headersEnd = lineEnd;
+      return true;
+    }
+
+    _checkLine(lineEnd - _lineStart, true);
+    _lineStart = lineEnd;
+
+    if (_rejection.has_value()) {
+      return false;
+    }
+  }
+
+  // The line still being received counts too: a client that never sends a
+  // newline is cut off once it crosses the limit.
+  _checkLine(_size - _lineStart, false);
+
+  if (!_rejection.has_value() && _size > _limits.maxHeadersSize) {
+    _reject(StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE,
+            "request headers too large");
+  }
+
+  return false;
+}
+
+bool RequestBuffer::hasCompleteRequest() {
+  if (!hasCompleteHeaders()) {
+    return _rejection.has_value();
+  }
+
+  if (!_requestEnd.has_value()) {
+    const auto headers{view().substr(0, _headersEnd.value())};
+
+    // Only Content-Length framing is implemented. Guessing the end of a
+    // transfer-coded body would let its bytes pass for the next pipelined
+    // request, so such requests are refused and the connection closed
+    // (RFC 9112, section 6.1).
+    if (_hasHeader(headers, kTransferEncoding)) {
+      _reject(StatusCode::HTTP_501_NOT_IMPLEMENTED,
+              "transfer codings are not supported");
+      return true;
+    }
+
+    const auto contentLength{_findContentLength(headers)};
+
+    if (contentLength > _limits.maxBodySize) {
+      _reject(StatusCode::HTTP_413_PAYLOAD_TOO_LARGE, "request body too large");
+      return true;
+    }
+
+    _requestEnd = _headersEnd.value() + contentLength;
+  }
+
+  return _size >= _requestEnd.value();
+}
+
+std::optional<StatusCode> RequestBuffer::rejection() const noexcept {
+  return _rejection;
+}
+
+std::string RequestBuffer::takeRequest() {
+  if (hasCompleteRequest() && _rejection.has_value()) {
+    const RequestRejected rejected{_rejection.value(), _rejectionReason};
+    _reset();
+    throw rejected;
+  }
+
+  if (!hasCompleteRequest()) {
+    std::string request{view()};
+    _reset();
+    return request;
+  }
+
+  const auto requestSize{_requestEnd.value()};
+  std::string request{view().substr(0, requestSize)};
+
+  // Keep the pipelined remainder at the front of the buffer.
+  const auto leftover{_size - requestSize};
+  std::memmove(_storage.get(), _storage.get() + requestSize, leftover);
+
+  _reset();
+  _size = leftover;
+  return request;
+}
+
+void RequestBuffer::release() {
+  if (_size != 0 || _storage == nullptr) {
+    return;
+  }
+
+  if (_pooled) {
+    _pool.release(std::move(_storage));
+  }
+
+  _storage.reset();
+  _capacity = 0;
+  _pooled = false;
+  _reset();
+}
+
+bool RequestBuffer::empty() const noexcept {
+  return _size == 0;
+}
+
+std::size_t RequestBuffer::size() const noexcept {
+  return _size;
+}
+
+std::size_t RequestBuffer::capacity() const noexcept {
+  return _capacity;
+}
+
+std::string_view RequestBuffer::view() const noexcept {
+  return {_storage.get(), _size};
+}
+
+void RequestBuffer::_grow(const std::size_t minCapacity) {
+  if (_storage == nullptr && minCapacity <= _pool.bufferSize()) {
+    _storage = _pool.acquire();
+    _capacity = _pool.bufferSize();
+    _pooled = true;
+    return;
+  }
+
+  const auto newCapacity{std::max(minCapacity, _capacity * 2)};
+  auto newStorage{std::make_unique_for_overwrite<char[]>(newCapacity)};  // NOLINT
+
+  if (_size != 0) {
+    std::memcpy(newStorage.get(), _storage.get(), _size);
+  }
+
+  if (_pooled) {
+    _pool.release(std::move(_storage));
+  }
+
+  _storage = std::move(newStorage);
+  _capacity = newCapacity;
+  _pooled = false;
+}
+
+void RequestBuffer::_reset() noexcept {
+  _size = 0;
+  _scanPosition = 0;
+  _lineStart = 0;
+  _headerCount = 0;
+  _headersEnd.reset();
+  _requestEnd.reset();
+  _rejection.reset();
+  _rejectionReason = nullptr;
+}
+
+void RequestBuffer::_checkLine(const std::size_t lineSize,
+                               const bool isComplete) noexcept {
+  if (_lineStart == 0) {
+    if (lineSize > _limits.maxRequestLineSize) {
+      _reject(StatusCode::HTTP_414_URI_TOO_LONG, "request line too long");
+    }
+    return;
+  }
+
+  if (lineSize > _limits.maxHeaderLineSize) {
+    _reject(StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE,
+            "header line too long");
+  } else if (isComplete && ++_headerCount > _limits.maxHeaderCount) {
+    _reject(StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE,
+            "too many headers");
+  }
+}
+
+void RequestBuffer::_reject(const StatusCode statusCode,
+                            const char *reason) noexcept {
+  _rejection = statusCode;
+  _rejectionReason = reason;
+}
+
+bool RequestBuffer::_hasHeader(const std::string_view headers,
+                               const std::string_view name) {
+  auto lineStart{headers.find(kCRLF)};  // skip the request line
+
+  while (lineStart != std::string_view::npos) {
+    lineStart += kCRLF.size();
+    const auto lineEnd{headers.find(kCRLF, lineStart)};
+
+    if (isHeaderLine(headers.substr(lineStart, lineEnd - lineStart), name)) {
+      return true;
+    }
+
+    lineStart = lineEnd;
+  }
+
+  return false;
+}
+
+std::size_t RequestBuffer::_findContentLength(const std::string_view headers) {
+  std::optional<std::size_t> contentLength;
+  auto lineStart{headers.find(kCRLF)};  // skip the request line
+
+  while (lineStart != std::string_view::npos) {
+    lineStart += kCRLF.size();
+    const auto lineEnd{headers.find(kCRLF, lineStart)};
+    const auto line{headers.substr(lineStart, lineEnd - lineStart)};
+
+    if (isHeaderLine(line, kContentLength)) {
+      const auto value{utils::parseContentLength(
+          line.substr(kContentLength.size() + 1))};
+
+      if (contentLength.has_value() && contentLength.value() != value) {
+        throw std::runtime_error("conflicting Content-Length headers");
+      }
+
+      contentLength = value;
+    }
+
+    lineStart = lineEnd;
+  }
+
+  return contentLength.value_or(0);
+}
+
+}  // namespace webserver::http
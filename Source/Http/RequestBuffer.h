@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "BufferPool.h"
+#include "HttpBase.h"
+
+namespace webserver::http {
+
+// Upper bounds on what a single request may occupy in a RequestBuffer. Sizes
+// are in bytes and include the line terminators.
+struct RequestLimits {
+  std::size_t maxRequestLineSize{8 * 1024};
+  std::size_t maxHeaderLineSize{8 * 1024};
+  std::size_t maxHeadersSize{32 * 1024};  // request line + headers
+  std::size_t maxHeaderCount{100};
+  std::size_t maxBodySize{1024 * 1024};
+};
+
+// A request that broke a RequestLimits bound or missed its deadline. Carries
+// the status it should be answered with before the connection is closed.
+class RequestRejected : public std::runtime_error {
+ public:
+  RequestRejected(StatusCode statusCode, const char *reason);
+
+  [[nodiscard]] StatusCode statusCode() const noexcept;
+
+ private:
+  StatusCode _statusCode;
+};
+
+// Receive buffer of one connection. Storage is taken from a BufferPool on the
+// first read and handed back by release() once the connection is idle, so
+// keep-alive connections waiting for their next request hold no memory.
+// Requests larger than a pool buffer grow into a private heap block.
+//
+// The end-of-headers search resumes where the previous one stopped, so every
+// received byte is scanned once no matter how many reads a request takes.
+// Requests are framed by Content-Length: bytes past the end of a request stay
+// buffered as the start of the next (pipelined) one. Requests with a
+// Transfer-Encoding are rejected with 501.
+//
+// The same scan enforces the RequestLimits line by line while the head is
+// still arriving, so an oversized request is rejected as soon as it crosses a
+// bound instead of after it has been buffered in full.
+class RequestBuffer {
+ public:
+  static constexpr std::size_t kMinReadSize = 2048;
+
+  explicit RequestBuffer(
+      utils::BufferPool &pool = utils::BufferPool::shared()) noexcept;
+  RequestBuffer(const RequestBuffer &) = delete;
+  RequestBuffer(RequestBuffer &&) = delete;
+  RequestBuffer &operator=(const RequestBuffer &) = delete;
+  RequestBuffer &operator=(RequestBuffer &&) = delete;
+  ~RequestBuffer();
+
+  // Free space for the next read, at least `minSize` bytes. Data written
+  // there becomes part of the buffer with commitWrite().
+  [[nodiscard]] std::span<char> prepareWrite(
+      std::size_t minSize = kMinReadSize);
+  void commitWrite(std::size_t bytes) noexcept;
+  void append(std::string_view data);
+
+  void setLimits(const RequestLimits &limits) noexcept;
+  // Largest amount a reader should keep buffered: one request at the head
+  // and body limits.
+  [[nodiscard]] std::size_t maxBufferedSize() const noexcept;
+
+  // True once "\r\n\r\n" has been received.
+  [[nodiscard]] bool hasCompleteHeaders() noexcept;
+  // True once the headers and Content-Length bytes of body have been
+  // received, or the request has been rejected (a limit or a
+  // Transfer-Encoding). Throws on a malformed or conflicting Content-Length.
+  [[nodiscard]] bool hasCompleteRequest();
+  // Status the current request was rejected with, if it broke a limit.
+  [[nodiscard]] std::optional<StatusCode> rejection() const noexcept;
+  // Removes and returns the first complete request, or everything received
+  // so far if the request is incomplete (peer closed or timed out). Throws
+  // RequestRejected, dropping the buffered data, if the request broke a
+  // limit.
+  [[nodiscard]] std::string takeRequest();
+
+  // Returns the storage to the pool if no data is buffered.
+  void release();
+
+  [[nodiscard]] bool empty() const noexcept;
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] std::size_t capacity() const noexcept;
+  [[nodiscard]] std::string_view view() const noexcept;
+
+ private:
+  void _grow(std::size_t minCapacity);
+  void _reset() noexcept;
+  void _checkLine(std::size_t lineSize, bool isComplete) noexcept;
+  void _reject(StatusCode statusCode, const char *reason) noexcept;
+  [[nodiscard]] static bool _hasHeader(std::string_view headers,
+                                       std::string_view name);
+  [[nodiscard]] static std::size_t _findContentLength(std::string_view headers);
+
+  utils::BufferPool &_pool;
+  utils::BufferPool::Buffer _storage;
+  std::size_t _capacity{0};
+  std::size_t _size{0};
+  bool _pooled{false};  // _storage came from _pool
+
+  RequestLimits _limits;
+  std::size_t _scanPosition{0};
+  std::size_t _lineStart{0};  // start of the head line being received
+  std::size_t _headerCount{0};
+  std::optional<std::size_t> _headersEnd;
+  std::optional<std::size_t> _requestEnd;
+  std::optional<StatusCode> _rejection;
+  const char *_rejectionReason{nullptr};
+};
+
+}  // namespace webserver::http
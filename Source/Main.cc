@@ -1,5 +1,6 @@
 #include <print>
 
+#include "AccessControl.h"
 #include "Config.h"
 #include "EventsManager.h"
 #include "HttpServer.h"
@@ -13,7 +14,9 @@ int main() {
   try {
     constexpr auto kDefaultConfigFile{"config.ini"};
     config::Config serverConfig{kDefaultConfigFile};
-    const http::StaticFileHandler handler{serverConfig.contentDirectory};
+    const http::StaticFileHandler handler{
+        serverConfig.contentDirectory,
+        core::AccessControl{serverConfig.accessRules}};
     net::HttpServer server{std::move(serverConfig), handler};
     server.startServerLoop();
   } catch (const std::exception &e) {
@@ -0,0 +1,166 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace webserver::net {
+
+Connection::Connection(std::unique_ptr<ISocket> socket)
+    : _socket{std::move(socket)} {
+}
+
+void Connection::send(const std::string &data) {
+  _output.pushBuffer(data);
+}
+
+std::string Connection::receive() {
+  auto request{_input.takeRequest()};
+  _input.release();
+  return request;
+}
+
+void Connection::sendZeroCopyFile(std::filesystem::path filePath) {
+  _output.pushFile(filePath);
+}
+
+void Connection::sendVectored(const std::span<const std::string_view> parts) {
+  for (const auto part : parts) {
+    _output.pushBuffer(std::string{part});
+  }
+}
+
+void Connection::sendFileWithHead(const std::string_view head,
+                                  std::filesystem::path filePath) {
+  _output.pushBuffer(std::string{head});
+  _output.pushFile(filePath);
+}
+
+void Connection::close() {
+  _socket->close();
+}
+
+void Connection::setTimeouts(const SocketTimeouts &timeouts) {
+  _socket->setTimeouts(timeouts);
+}
+
+void Connection::setRequestLimits(const http::RequestLimits &limits) {
+  _input.setLimits(limits);
+  _socket->setRequestLimits(limits);
+}
+
+int Connection::nativeHandle() const noexcept {
+  return _socket->nativeHandle();
+}
+
+void Connection::setNonBlocking() {
+  _socket->setNonBlocking();
+}
+
+std::optional<std::size_t> Connection::receiveSome(std::span<char> buffer) {
+  return _socket->receiveSome(buffer);
+}
+
+std::optional<std::size_t> Connection::sendSome(std::span<const char> data,
+                                                const bool moreFollows) {
+  return _socket->sendSome(data, moreFollows);
+}
+
+std::optional<std::size_t> Connection::sendFileSome(const int fileFd,
+                                           std::int64_t &offset,
+                                           const std::size_t count) {
+  return _socket->sendFileSome(fileFd, offset, count);
+}
+
+std::uint32_t Connection::zeroCopyIssued() const noexcept {
+  return _socket->zeroCopyIssued();
+}
+
+std::uint32_t Connection::reapZeroCopyCompletions() {
+  return _socket->reapZeroCopyCompletions();
+}
+
+std::optional<int> Connection::incomingCpu() const noexcept {
+  return _socket->incomingCpu();
+}
+
+std::optional<IpAddress> Connection::peerAddress() const noexcept {
+  return _socket->peerAddress();
+}
+
+ReadStatus Connection::readAvailable() {
+  // Reading stops at the first complete request, so a client streaming
+  // pipelined requests cannot grow the buffer or hold the reactor thread;
+  // pendingRead brings the reactor back for the rest after dispatch.
+  if (hasCompleteRequest()) {
+    pendingRead = true;
+    return ReadStatus::REQUEST_READY;
+  }
+
+  while (true) {
+    // An incomplete request never fills the cap without breaking a limit
+    // first, so hitting it means the limits changed under a full buffer.
+    if (_input.size() >= _input.maxBufferedSize()) {
+      return ReadStatus::CLOSED;
+    }
+
+    const auto space{_input.prepareWrite()};
+    const auto room{_input.maxBufferedSize() - _input.size()};
+    const auto bytesReceived{
+        _socket->receiveSome(space.first(std::min(space.size(), room)))};
+
+    if (!bytesReceived.has_value()) {
+      break;  // socket drained
+    }
+
+    if (bytesReceived.value() == 0) {
+      return ReadStatus::CLOSED;
+    }
+
+    _input.commitWrite(bytesReceived.value());
+
+    // A request that broke a limit is answered and the connection closed,
+    // so there is nothing more to read for it.
+    if (hasCompleteRequest()) {
+      pendingRead = !_input.rejection().has_value();
+      return ReadStatus::REQUEST_READY;
+    }
+  }
+
+  _input.release();  // only if idle, keeps a partial request
+  return ReadStatus::NEED_MORE;
+}
+
+bool Connection::hasCompleteRequest() noexcept {
+  try {
+    return _input.hasCompleteRequest();
+  } catch (const std::exception &) {
+    return true;  // bad framing, receive() reports it to the handler
+  }
+}
+
+bool Connection::hasBufferedInput() const noexcept {
+  return !_input.empty();
+}
+
+std::string_view Connection::bufferedInput() const noexcept {
+  return _input.view();
+}
+
+bool Connection::flushOutput() {
+  return _output.flush(*_socket);
+}
+
+bool Connection::hasPendingOutput() const noexcept {
+  return !_output.empty();
+}
+
+std::size_t Connection::bufferedOutputBytes() const noexcept {
+  return _output.bufferedBytes();
+}
+
+bool Connection::discardOutput() {
+  _output.clear();
+  return _output.releaseCompleted(*_socket);
+}
+
+}  // namespace webserver::net
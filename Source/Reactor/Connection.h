@@ -0,0 +1,103 @@
+#pragma once
+
+#include <coroutine>
+#include <memory>
+#include <string>
+
+#include "AsyncSocket.h"
+#include "Lane.h"
+#include "RequestBuffer.h"
+#include "Socket.h"
+#include "TimerWheel.h"
+#include "WriteQueue.h"
+
+namespace webserver::net {
+
+enum class ReadStatus : std::uint8_t { REQUEST_READY, NEED_MORE, CLOSED };
+
+// Which deadline the connection's timer currently tracks. RELEASE bounds
+// the wait of a closed connection for its zero-copy completions.
+enum class Deadline : std::uint8_t { NONE, IDLE, REQUEST, SEND, RELEASE };
+
+// Client connection owned by the reactor. The reactor fills the input buffer
+// while the socket is readable; once a full request has arrived the
+// connection is handed to a worker, which sees it as an ordinary ISocket whose
+// receive() returns the buffered request instead of touching the network and
+// whose send()/sendZeroCopyFile() only queue the response. The reactor
+// flushes that queue once the worker is done and whenever the socket becomes
+// writable again. The connection is also the node of its deadline timer in
+// the reactor's timer wheel.
+class Connection final : public ISocket, public core::TimerNode {
+ public:
+  explicit Connection(std::unique_ptr<ISocket> socket);
+
+  Connection(const Connection &) = delete;
+  Connection(Connection &&) = delete;
+  Connection &operator=(const Connection &) = delete;
+  Connection &operator=(Connection &&) = delete;
+  ~Connection() override = default;
+
+  void send(const std::string &data) override;
+  [[nodiscard]] std::string receive() override;
+  void sendZeroCopyFile(std::filesystem::path filePath) override;
+  void sendVectored(std::span<const std::string_view> parts) override;
+  void sendFileWithHead(std::string_view head,
+                        std::filesystem::path filePath) override;
+  void close() override;
+  void setTimeouts(const SocketTimeouts &timeouts) override;
+  void setRequestLimits(const http::RequestLimits &limits) override;
+
+  [[nodiscard]] int nativeHandle() const noexcept override;
+  void setNonBlocking() override;
+  [[nodiscard]] std::optional<std::size_t> receiveSome(
+      std::span<char> buffer) override;
+  [[nodiscard]] std::optional<std::size_t> sendSome(
+      std::span<const char> data, bool moreFollows) override;
+  [[nodiscard]] std::optional<std::size_t> sendFileSome(
+      int fileFd, std::int64_t &offset, std::size_t count) override;
+
+  [[nodiscard]] std::uint32_t zeroCopyIssued() const noexcept override;
+  [[nodiscard]] std::uint32_t reapZeroCopyCompletions() override;
+  [[nodiscard]] std::optional<int> incomingCpu() const noexcept override;
+  [[nodiscard]] std::optional<IpAddress> peerAddress()
+      const noexcept override;
+
+  // Drains the socket until it would block (edge-triggered contract) or a
+  // complete request is buffered; in the latter case pendingRead is set so
+  // the rest is read after that request is dispatched.
+  [[nodiscard]] ReadStatus readAvailable();
+  [[nodiscard]] bool hasCompleteRequest() noexcept;
+  [[nodiscard]] bool hasBufferedInput() const noexcept;
+  // What has been received and not yet taken, starting with the next
+  // request.
+  [[nodiscard]] std::string_view bufferedInput() const noexcept;
+  // Writes queued output without blocking; true once nothing is left.
+  [[nodiscard]] bool flushOutput();
+  [[nodiscard]] bool hasPendingOutput() const noexcept;
+  [[nodiscard]] std::size_t bufferedOutputBytes() const noexcept;
+  // Drops unsent output; true once no zero-copy send still reads a buffer
+  // of the connection, i.e. it may be destroyed.
+  [[nodiscard]] bool discardOutput();
+
+  // Reactor-side bookkeeping, only touched from the reactor thread.
+  bool busy{false};
+  bool pendingRead{false};
+  bool closeAfterFlush{false};
+  bool served{false};  // at least one request was dispatched
+  Deadline deadline{Deadline::NONE};
+  core::Lane lane{core::Lane::INTERACTIVE};  // of the current dispatch
+  // Coroutine of the busy connection parked until `waitingFor` is done;
+  // `broken` tells it the connection failed or timed out meanwhile.
+  std::coroutine_handle<> waiter;
+  IoWait waitingFor{IoWait::REQUEST};
+  bool broken{false};
+
+ private:
+  // Destroyed after the socket is closed, which the reactor delays until the
+  // kernel no longer reads the buffers.
+  WriteQueue _output;
+  std::unique_ptr<ISocket> _socket;
+  http::RequestBuffer _input;
+};
+
+}  // namespace webserver::net
@@ -0,0 +1,707 @@
+#include "EpollReactor.h"
+
+#ifdef __linux__
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <sys/socket.h>
+  #include <unistd.h>
+
+  #include <algorithm>
+  #include <array>
+  #include <cerrno>
+  #include <chrono>
+  #include <cstdint>
+  #include <print>
+  #include <stdexcept>
+  #include <system_error>
+  #include <utility>
+
+  #include "HttpResponse.h"
+  #include "HttpServer.h"
+
+namespace webserver::net {
+
+constexpr auto kMaxEventsPerWait = 256;
+// Upper bound for noticing shutdownRequested when no events arrive.
+constexpr auto kWaitTimeoutMs = 500;
+// Deadline resolution; while timers are armed the loop wakes up at least
+// this often to expire them.
+constexpr auto kTimerTick = std::chrono::milliseconds{100};
+// EPOLLOUT is edge-triggered too, so it only fires when a socket whose buffer
+// filled up becomes writable again.
+constexpr std::uint32_t kClientEvents =
+    EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+// Requests served per dispatch before the connection goes back to the
+// reactor, so one pipelining client cannot hog a worker.
+constexpr auto kMaxPipelinedRequests = 16;
+constexpr std::uint32_t kReadEvents = EPOLLIN | EPOLLRDHUP | EPOLLHUP;
+// In-memory output a coroutine may queue before it is parked until the
+// client has taken it.
+constexpr std::size_t kFlushWatermark = 256 * 1024;
+// Pause of a listener that ran out of descriptors or memory while accepting.
+constexpr auto kAcceptBackoff = std::chrono::milliseconds{100};
+
+// Makes close() reset the connection and drop its unsent data, so the kernel
+// stops referencing the buffers of zero-copy sends that are still queued.
+static void discardOnClose(const int fd) {
+  const linger option{.l_onoff = 1, .l_linger = 0};
+  ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &option, sizeof(option));
+}
+
+// Errors of one pending connection that do not affect the rest of the
+// accept queue (see accept(2)).
+static bool isConnectionAcceptError(const std::error_code &error) {
+  constexpr std::array kErrors{
+      ECONNABORTED, EINTR,        EPROTO,     ENETDOWN,    ENOPROTOOPT,
+      EHOSTDOWN,    EHOSTUNREACH, EOPNOTSUPP, ENETUNREACH, ENONET,
+      EPERM};
+
+  return error.category() == std::generic_category() &&
+         std::ranges::find(kErrors, error.value()) != kErrors.end();
+}
+
+// Parks the coroutine serving one dispatched connection on the reactor.
+class EpollReactor::ConnectionIo final : public IAsyncIo {
+ public:
+  ConnectionIo(EpollReactor &reactor, Connection &connection) noexcept
+      : _reactor{reactor}, _connection{connection} {
+  }
+
+  bool mustWait(const IoWait wait) override {
+    return wait == IoWait::REQUEST
+               ? !_connection.hasCompleteRequest()
+               : _connection.bufferedOutputBytes() >= kFlushWatermark;
+  }
+
+  void suspend(const IoWait wait,
+               const std::coroutine_handle<> handle) override {
+    _reactor._complete({.fd = _connection.nativeHandle(),
+                        .connType = ConnType::KEEP_ALIVE,
+                        .waiter = handle,
+                        .wait = wait});
+  }
+
+  bool broken() const noexcept override {
+    return _connection.broken;
+  }
+
+ private:
+  EpollReactor &_reactor;
+  Connection &_connection;
+};
+
+EpollReactor::EpollReactor(std::vector<IListener *> listeners,
+                           core::ThreadPool &threadPool,
+                           core::AdmissionController &admission,
+                           const SocketTimeouts &timeouts,
+                           const http::RequestLimits &requestLimits,
+                           RequestCallback serveRequest,
+                           AcceptCallback onAccept,
+                           ClassifyCallback classify)
+    : _listeners{std::move(listeners)},
+      _threadPool{threadPool},
+      _admission{admission},
+      _serveRequest{std::move(serveRequest)},
+      _onAccept{std::move(onAccept)},
+      _classify{std::move(classify)},
+      _timeouts{timeouts},
+      _requestLimits{requestLimits},
+      _timers{kTimerTick} {
+  _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+
+  if (_epollFd < 0) {
+    throw std::runtime_error("Unable to create epoll instance");
+  }
+
+  _wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  if (_wakeFd < 0) {
+    ::close(_epollFd);
+    throw std::runtime_error("Unable to create eventfd");
+  }
+}
+
+EpollReactor::~EpollReactor() {
+  for (const auto &[fd, connection] : _connections) {
+    if (connection->hasPendingOutput()) {
+      discardOnClose(fd);
+    }
+  }
+
+  for (const auto &[fd, connection] : _closed) {
+    discardOnClose(fd);
+  }
+
+  _connections.clear();
+  _closed.clear();
+  ::close(_wakeFd);
+  ::close(_epollFd);
+}
+
+void EpollReactor::run() {
+  for (auto *listener : _listeners) {
+    listener->setNonBlocking();
+    _registerFd(listener->nativeHandle(), EPOLLIN | EPOLLET);
+  }
+  _registerFd(_wakeFd, EPOLLIN | EPOLLET);
+
+  while (!shutdownRequested.load()) {
+    _pollOnce();
+  }
+}
+
+void EpollReactor::drain(const std::chrono::milliseconds timeout) {
+  for (auto *listener : _listeners) {
+    ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, listener->nativeHandle(), nullptr);
+    listener->handOff();
+  }
+
+  _listeners.clear();
+  _pausedListeners.clear();
+  _draining = true;
+
+  // Busy connections are closed by _processCompletions() once their
+  // response is out. The others are read first: a request may already sit
+  // in the socket without an edge reported for it yet. Kept-alive ones with
+  // nothing buffered after that are idle and closed right away; clients
+  // retry on a new connection. A fresh connection has not sent its first
+  // request yet and keeps its idle deadline.
+  std::vector<int> waiting;
+
+  for (const auto &[fd, connection] : _connections) {
+    if (!connection->busy && !connection->hasPendingOutput()) {
+      waiting.push_back(fd);
+    }
+  }
+
+  for (const auto fd : waiting) {
+    _readFromConnection(*_connections.at(fd));
+
+    const auto connectionIt{_connections.find(fd)};
+
+    if (connectionIt == _connections.end()) {
+      continue;  // the peer had already closed it
+    }
+
+    const auto &connection{*connectionIt->second};
+
+    if (connection.served && !connection.busy &&
+        !connection.hasPendingOutput() && !connection.hasBufferedInput()) {
+      _closeConnection(fd);
+    }
+  }
+
+  const auto deadline{std::chrono::steady_clock::now() + timeout};
+
+  while (!_connections.empty() &&
+         std::chrono::steady_clock::now() < deadline) {
+    _pollOnce();
+  }
+}
+
+void EpollReactor::_pollOnce() {
+  std::array<epoll_event, kMaxEventsPerWait> events{};
+
+  const auto waitTimeoutMs{
+      _timers.empty() && _pausedListeners.empty()
+          ? kWaitTimeoutMs
+          : static_cast<int>(std::min(kTimerTick, kAcceptBackoff).count())};
+  const auto readyCount{::epoll_wait(_epollFd, events.data(),
+                                     kMaxEventsPerWait, waitTimeoutMs)};
+
+  if (readyCount < 0) {
+    if (errno == EINTR) {
+      return;
+    }
+
+    throw std::runtime_error("epoll_wait() failed");
+  }
+
+  for (int i = 0; i < readyCount; ++i) {
+    const auto fd{events.at(i).data.fd};
+    const auto listenerIt{
+        std::ranges::find(_listeners, fd, &IListener::nativeHandle)};
+
+    if (listenerIt != _listeners.end()) {
+      _acceptConnections(**listenerIt);
+    } else if (fd == _wakeFd) {
+      _drainWakeFd();
+    } else {
+      _onClientEvent(fd, events.at(i).events);
+    }
+  }
+
+  _processCompletions();
+  _expireDeadlines();
+  _resumeAccepting();
+}
+
+void EpollReactor::_acceptConnections(IListener &listener) {
+  while (true) {
+    std::unique_ptr<ISocket> clientSocket;
+
+    try {
+      clientSocket = listener.accept();
+    } catch (const std::system_error &e) {
+      std::println("Accept error: {}", e.what());
+
+      if (isConnectionAcceptError(e.code())) {
+        continue;  // only that connection is lost, the queue is not
+      }
+
+      // Out of descriptors or memory, or a broken listener. The backlog
+      // stays unread and no new edge may come for it, so the listener is
+      // disarmed and re-armed after a pause instead of being given up.
+      _pauseAccepting(listener);
+      return;
+    } catch (const std::exception &e) {
+      std::println("Accept error: {}", e.what());
+      continue;  // e.g. wrapping the accepted socket failed
+    }
+
+    if (clientSocket == nullptr) {
+      return;  // accept queue drained
+    }
+
+    if (_onAccept) {
+      clientSocket = _onAccept(std::move(clientSocket));
+
+      if (clientSocket == nullptr) {
+        continue;  // turned away
+      }
+    }
+
+    clientSocket->setNonBlocking();
+    const auto fd{clientSocket->nativeHandle()};
+
+    _registerFd(fd, kClientEvents);
+    const auto connectionIt{
+        _connections
+            .emplace(fd, std::make_unique<Connection>(std::move(clientSocket)))
+            .first};
+    connectionIt->second->setRequestLimits(_requestLimits);
+    _armDeadline(*connectionIt->second, Deadline::IDLE);
+  }
+}
+
+void EpollReactor::_pauseAccepting(IListener &listener) {
+  epoll_event event{};
+  event.data.fd = listener.nativeHandle();
+  ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, event.data.fd, &event);
+
+  _pausedListeners.push_back(
+      {.listener = &listener,
+       .resumeAt = std::chrono::steady_clock::now() + kAcceptBackoff});
+}
+
+void EpollReactor::_resumeAccepting() {
+  const auto now{std::chrono::steady_clock::now()};
+
+  // Re-arming an edge-triggered descriptor that is readable reports it
+  // again, so a backlog left behind is picked up by the next wait.
+  std::erase_if(_pausedListeners, [this, now](const PausedListener &paused) {
+    if (paused.resumeAt > now) {
+      return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = paused.listener->nativeHandle();
+    ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, event.data.fd, &event);
+    return true;
+  });
+}
+
+void EpollReactor::_onClientEvent(const int fd, const std::uint32_t events) {
+  const auto connectionIt{_connections.find(fd)};
+
+  if (connectionIt == _connections.end()) {
+    if (_closed.contains(fd)) {
+      _releaseClosed(fd, false);
+    }
+
+    return;
+  }
+
+  auto &connection{*connectionIt->second};
+
+  if ((events & kReadEvents) != 0) {
+    connection.pendingRead = true;
+  }
+
+  if (connection.busy) {
+    if (connection.waiter) {
+      _advanceWaiter(connection);
+    }
+
+    return;  // otherwise revisited once the worker is done
+  }
+
+  // Zero-copy completions are also signalled as EPOLLERR; flushing reaps
+  // them and surfaces a real socket error as a failed send.
+  if ((events & EPOLLERR) != 0 && !connection.hasPendingOutput()) {
+    _closeConnection(fd);
+    return;
+  }
+
+  _resume(connection);
+}
+
+void EpollReactor::_resume(Connection &connection) {
+  try {
+    if (!connection.flushOutput()) {
+      // Backpressure: no reads or new requests until the client has taken
+      // the previous response; EPOLLOUT brings us back here.
+      _armDeadline(connection, Deadline::SEND);
+      return;
+    }
+  } catch (const std::exception &e) {
+    std::println("Write error: {}", e.what());
+    _closeConnection(connection.nativeHandle());
+    return;
+  }
+
+  if (connection.closeAfterFlush) {
+    _closeConnection(connection.nativeHandle());
+    return;
+  }
+
+  if (connection.pendingRead) {
+    connection.pendingRead = false;
+    _readFromConnection(connection);
+  } else if (connection.hasCompleteRequest()) {
+    _dispatch(connection);
+  } else {
+    _armReadDeadline(connection);
+  }
+}
+
+void EpollReactor::_readFromConnection(Connection &connection) {
+  auto status{ReadStatus::CLOSED};
+
+  try {
+    status = connection.readAvailable();
+  } catch (const std::exception &e) {
+    std::println("Read error: {}", e.what());
+  }
+
+  switch (status) {
+    case ReadStatus::CLOSED:
+      _closeConnection(connection.nativeHandle());
+      break;
+    case ReadStatus::REQUEST_READY:
+      _dispatch(connection);
+      break;
+    case ReadStatus::NEED_MORE:
+      _armReadDeadline(connection);
+      break;
+  }
+}
+
+void EpollReactor::_dispatch(Connection &connection) {
+  auto permit{_admission.tryAcquire()};
+
+  if (!permit.has_value()) {
+    _rejectRequest(connection, http::StatusCode::HTTP_503_SERVICE_UNAVAILABLE);
+    return;
+  }
+
+  connection.busy = true;
+  connection.served = true;
+  connection.lane = _classify ? _classify(connection.bufferedInput())
+                              : core::Lane::INTERACTIVE;
+  _armDeadline(connection, Deadline::NONE);  // workers are not timed out
+
+  auto work{[this, &connection, permit = std::move(*permit)]() mutable {
+    permit.start();
+    core::spawn(_serveConnection(connection, std::move(permit)));
+  }};
+
+  // One dispatch per request: the task itself must not allocate, the
+  // coroutine frames are the only per-dispatch allocation.
+  static_assert(core::Task::storesInline<decltype(work)>());
+  _threadPool.submit(connection.lane, std::move(work));
+}
+
+// `permit` is moved into the coroutine frame and holds the admission slot
+// until the coroutine finishes.
+core::AsyncTask<> EpollReactor::_serveConnection(
+    Connection &connection,
+    [[maybe_unused]] core::AdmissionController::Permit permit) {
+  const auto fd{connection.nativeHandle()};
+  ConnectionIo io{*this, connection};
+  AsyncSocket socket{connection, &io};
+  auto connType{ConnType::CLOSE};
+
+  try {
+    // Pipelined requests that are already buffered are served back to back;
+    // their responses pile up in the write queue and leave together.
+    for (int served = 0; served < kMaxPipelinedRequests; ++served) {
+      connType = co_await _serveRequest(socket);
+
+      if (connType != ConnType::KEEP_ALIVE ||
+          !connection.hasCompleteRequest()) {
+        break;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::println("Serving error: {}", e.what());
+    connType = ConnType::CLOSE;
+  }
+
+  // The reactor may drop the connection right away; it is not touched past
+  // this point, and the permit is returned as the frame goes.
+  _complete({.fd = fd, .connType = connType});
+}
+
+void EpollReactor::_complete(const Completion &completion) {
+  {
+    std::lock_guard<std::mutex> lock{_completionsMutex};
+    _completions.push_back(completion);
+  }
+
+  _wake();
+}
+
+void EpollReactor::_processCompletions() {
+  std::vector<Completion> completions;
+
+  {
+    std::lock_guard<std::mutex> lock{_completionsMutex};
+    completions.swap(_completions);
+  }
+
+  for (const auto &[fd, connType, waiter, wait] : completions) {
+    const auto connectionIt{_connections.find(fd)};
+
+    if (connectionIt == _connections.end()) {
+      continue;
+    }
+
+    auto &connection{*connectionIt->second};
+
+    if (waiter) {
+      connection.waiter = waiter;
+      connection.waitingFor = wait;
+      _advanceWaiter(connection);
+      continue;
+    }
+
+    connection.busy = false;
+    connection.closeAfterFlush = connType == ConnType::CLOSE || _draining;
+
+    _resume(connection);
+  }
+}
+
+void EpollReactor::_advanceWaiter(Connection &connection) {
+  // The parked coroutine does not touch the connection, so the reads or
+  // writes it waits for happen here; it goes back to the pool once they are
+  // done. Busy connections are never closed under it: a failure only marks
+  // the connection broken, the coroutine sees that and finishes.
+  try {
+    if (connection.waitingFor == IoWait::FLUSH) {
+      if (!connection.flushOutput()) {
+        _armDeadline(connection, Deadline::SEND);
+        return;
+      }
+    } else if (!connection.hasCompleteRequest()) {
+      connection.pendingRead = false;
+
+      if (connection.readAvailable() == ReadStatus::NEED_MORE) {
+        _armReadDeadline(connection);
+        return;
+      }
+
+      connection.broken = !connection.hasCompleteRequest();
+    }
+  } catch (const std::exception &e) {
+    std::println("I/O error: {}", e.what());
+    connection.broken = true;
+  }
+
+  _resumeWaiter(connection);
+}
+
+void EpollReactor::_resumeWaiter(Connection &connection) {
+  _armDeadline(connection, Deadline::NONE);
+  _threadPool.submit(connection.lane,
+                     [waiter = std::exchange(connection.waiter, nullptr)] {
+                       waiter.resume();
+                     });
+}
+
+void EpollReactor::_closeConnection(const int fd) {
+  const auto connectionIt{_connections.find(fd)};
+
+  if (connectionIt == _connections.end()) {
+    return;
+  }
+
+  auto connection{std::move(connectionIt->second)};
+  _connections.erase(connectionIt);
+  _armDeadline(*connection, Deadline::NONE);
+
+  // Closing now would leave the kernel sending zero-copy buffers in the
+  // background after they are freed. The socket stays open instead, only
+  // watched for the completions, which come as EPOLLERR.
+  try {
+    if (!connection->discardOutput()) {
+      epoll_event event{};
+      event.events = EPOLLET;
+      event.data.fd = fd;
+      ::epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &event);
+
+      _armDeadline(*connection, Deadline::RELEASE);
+      _closed.emplace(fd, std::move(connection));
+      return;
+    }
+  } catch (const std::exception &e) {
+    std::println("Write error: {}", e.what());
+    discardOnClose(fd);
+  }
+
+  // The socket closes itself with the connection.
+  ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void EpollReactor::_releaseClosed(const int fd, const bool expired) {
+  auto released{false};
+  auto failed{false};
+
+  try {
+    released = _closed.at(fd)->discardOutput();
+  } catch (const std::exception &e) {
+    std::println("Write error: {}", e.what());
+    failed = true;
+  }
+
+  if (!released && !expired && !failed) {
+    return;
+  }
+
+  // Past the deadline the peer is not taking the data; resetting the
+  // connection releases the buffers before they are freed.
+  if (!released) {
+    discardOnClose(fd);
+  }
+
+  ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+  _closed.erase(fd);
+}
+
+void EpollReactor::_armDeadline(Connection &connection,
+                                const Deadline deadline) {
+  // Idle and request deadlines run from the moment the state was entered, so
+  // a client trickling in bytes does not push its request deadline back.
+  // The send deadline restarts whenever the socket drains, i.e. it bounds
+  // stalls rather than the whole transfer.
+  if (deadline == connection.deadline && deadline != Deadline::SEND) {
+    return;
+  }
+
+  connection.deadline = deadline;
+
+  switch (deadline) {
+    case Deadline::NONE:
+      _timers.cancel(connection);
+      break;
+    case Deadline::IDLE:
+      _timers.arm(connection, _timeouts.idle);
+      break;
+    case Deadline::REQUEST:
+      _timers.arm(connection, _timeouts.request);
+      break;
+    case Deadline::SEND:
+    case Deadline::RELEASE:
+      _timers.arm(connection, _timeouts.send);
+      break;
+  }
+}
+
+void EpollReactor::_armReadDeadline(Connection &connection) {
+  _armDeadline(connection, connection.hasBufferedInput() ? Deadline::REQUEST
+                                                         : Deadline::IDLE);
+}
+
+void EpollReactor::_expireDeadlines() {
+  struct Expired {
+    int fd;
+    Deadline deadline;
+  };
+
+  std::vector<Expired> expired;
+
+  _timers.advance(std::chrono::steady_clock::now(),
+                  [&expired](core::TimerNode &node) {
+                    auto &connection{static_cast<Connection &>(node)};
+                    expired.push_back({.fd = connection.nativeHandle(),
+                                       .deadline = connection.deadline});
+                    connection.deadline = Deadline::NONE;
+                  });
+
+  for (const auto &[fd, deadline] : expired) {
+    if (deadline == Deadline::RELEASE) {
+      _releaseClosed(fd, true);
+      continue;
+    }
+
+    const auto connectionIt{_connections.find(fd)};
+
+    if (connectionIt != _connections.end() && connectionIt->second->waiter) {
+      connectionIt->second->broken = true;
+      _resumeWaiter(*connectionIt->second);
+      continue;
+    }
+
+    if (deadline == Deadline::REQUEST && connectionIt != _connections.end()) {
+      _rejectRequest(*connectionIt->second,
+                     http::StatusCode::HTTP_408_REQUEST_TIMEOUT);
+    } else {
+      _closeConnection(fd);
+    }
+  }
+}
+
+void EpollReactor::_rejectRequest(Connection &connection,
+                                  const http::StatusCode statusCode) {
+  // Late (408) and shed (503) requests get a canned response before the
+  // connection goes; the send deadline bounds that write.
+  try {
+    connection.send(http::HttpResponse::prebuilt(statusCode));
+  } catch (const std::exception &e) {
+    std::println("Write error: {}", e.what());
+    _closeConnection(connection.nativeHandle());
+    return;
+  }
+
+  connection.pendingRead = false;
+  connection.closeAfterFlush = true;
+  _resume(connection);
+}
+
+void EpollReactor::_registerFd(const int fd, const std::uint32_t events) const {
+  epoll_event event{};
+  event.events = events;
+  event.data.fd = fd;
+
+  if (::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    throw std::runtime_error("Unable to register descriptor in epoll");
+  }
+}
+
+void EpollReactor::_wake() const {
+  constexpr std::uint64_t kIncrement = 1;
+  [[maybe_unused]] const auto written{
+      ::write(_wakeFd, &kIncrement, sizeof(kIncrement))};
+}
+
+void EpollReactor::_drainWakeFd() const {
+  std::uint64_t counter{};
+  [[maybe_unused]] const auto bytesRead{
+      ::read(_wakeFd, &counter, sizeof(counter))};
+}
+
+}  // namespace webserver::net
+
+#endif  // __linux__
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "AdmissionController.h"
+#include "AsyncSocket.h"
+#include "AsyncTask.h"
+#include "Connection.h"
+#include "Handler.h"
+#include "Socket.h"
+#include "ThreadPool.h"
+#include "TimerWheel.h"
+
+namespace webserver::net {
+
+using RequestCallback =
+    std::function<core::AsyncTask<ConnType>(AsyncSocket &)>;
+// Invoked on the reactor thread for every accepted connection. Returns the
+// socket to serve, or nullptr if the callback turned the connection away and
+// took care of closing it.
+using AcceptCallback =
+    std::function<std::unique_ptr<ISocket>(std::unique_ptr<ISocket>)>;
+// Invoked on the reactor thread with the buffered input of a connection
+// about to be dispatched; picks the pool lane its request is served in.
+using ClassifyCallback = std::function<core::Lane(std::string_view)>;
+
+// Edge-triggered epoll loop. Accepts from one or more listeners, reads and
+// keeps idle keep-alive connections on a single thread; pool workers only
+// run once a complete request has been buffered and report back through a
+// completion queue. Requests are served by coroutines: one that waits for
+// more input or for its output to drain is parked on its connection through
+// the same queue and resumed on the pool when the loop is done with it, so a
+// worker is only occupied while a handler actually runs. Connection
+// deadlines live in a timer wheel owned by the loop; expired connections are
+// closed in one batch per loop iteration.
+// Every dispatch needs a permit from the admission controller; without one
+// the request is answered with 503 on the reactor thread. A dispatch and
+// every resumption of its coroutine run in the lane its first request was
+// classified into.
+class EpollReactor {
+ public:
+  EpollReactor(std::vector<IListener *> listeners, core::ThreadPool &threadPool,
+               core::AdmissionController &admission,
+               const SocketTimeouts &timeouts,
+               const http::RequestLimits &requestLimits,
+               RequestCallback serveRequest, AcceptCallback onAccept = {},
+               ClassifyCallback classify = {});
+
+  EpollReactor(const EpollReactor &) = delete;
+  EpollReactor(EpollReactor &&) = delete;
+  EpollReactor &operator=(const EpollReactor &) = delete;
+  EpollReactor &operator=(EpollReactor &&) = delete;
+  ~EpollReactor();
+
+  // Runs until shutdownRequested is set.
+  void run();
+  // After run(), once the listeners were handed to another process: stops
+  // accepting, closes idle connections and serves the busy ones until they
+  // are done or `timeout` passes. Connections close after their current
+  // response.
+  void drain(std::chrono::milliseconds timeout);
+
+ private:
+  // A finished dispatch, or, with `waiter` set, a coroutine that suspended
+  // on its connection until `wait` is satisfied.
+  struct Completion {
+    int fd{-1};
+    ConnType connType{ConnType::CLOSE};
+    std::coroutine_handle<> waiter{};
+    IoWait wait{IoWait::REQUEST};
+  };
+
+  // Listener disarmed after a failed accept, until `resumeAt`.
+  struct PausedListener {
+    IListener *listener{nullptr};
+    std::chrono::steady_clock::time_point resumeAt{};
+  };
+
+  class ConnectionIo;
+
+  void _pollOnce();
+  void _acceptConnections(IListener &listener);
+  void _pauseAccepting(IListener &listener);
+  void _resumeAccepting();
+  void _onClientEvent(int fd, std::uint32_t events);
+  void _resume(Connection &connection);
+  void _readFromConnection(Connection &connection);
+  void _dispatch(Connection &connection);
+  [[nodiscard]] core::AsyncTask<> _serveConnection(
+      Connection &connection, core::AdmissionController::Permit permit);
+  void _complete(const Completion &completion);
+  void _processCompletions();
+  void _advanceWaiter(Connection &connection);
+  void _resumeWaiter(Connection &connection);
+  void _closeConnection(int fd);
+  void _releaseClosed(int fd, bool expired);
+  void _armDeadline(Connection &connection, Deadline deadline);
+  void _armReadDeadline(Connection &connection);
+  void _expireDeadlines();
+  void _rejectRequest(Connection &connection, http::StatusCode statusCode);
+  void _registerFd(int fd, std::uint32_t events) const;
+  void _wake() const;
+  void _drainWakeFd() const;
+
+  std::vector<IListener *> _listeners;
+  core::ThreadPool &_threadPool;
+  core::AdmissionController &_admission;
+  RequestCallback _serveRequest;
+  AcceptCallback _onAccept;
+  ClassifyCallback _classify;
+  const SocketTimeouts _timeouts;
+  const http::RequestLimits _requestLimits;
+
+  int _epollFd{-1};
+  int _wakeFd{-1};
+  core::TimerWheel _timers;  // must outlive the connections armed in it
+  std::unordered_map<int, std::unique_ptr<Connection>> _connections;
+  // Closed connections whose buffers a zero-copy send may still read. Their
+  // sockets stay open until the completions are in or RELEASE expires.
+  std::unordered_map<int, std::unique_ptr<Connection>> _closed;
+  std::vector<PausedListener> _pausedListeners;
+  bool _draining{false};
+
+  std::mutex _completionsMutex;
+  std::vector<Completion> _completions;
+};
+
+}  // namespace webserver::net
@@ -0,0 +1,187 @@
+#include "WriteQueue.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+namespace webserver::net {
+
+// Upper bound for one sendfile() call, keeps the reactor responsive.
+constexpr std::int64_t kMaxFileChunkSize = 1 << 20;
+
+WriteQueue::~WriteQueue() {
+  clear();
+}
+
+void WriteQueue::pushBuffer(std::string data) {
+  if (data.empty()) {
+    return;
+  }
+
+  _pendingBytes += data.size();
+  _bufferedBytes += data.size();
+
+  // Responses queued back to back (pipelining) share one buffer, and so one
+  // send(), unless a file sits between them. A buffer that is partly sent
+  // may be pinned by a zero-copy send, so it must not be reallocated.
+  if (!_segments.empty() && _segments.back().fileFd < 0 &&
+      _segments.back().offset == 0 &&
+      !_segments.back().zeroCopyId.has_value()) {
+    auto &last{_segments.back()};
+    last.data += data;
+    last.end = static_cast<std::int64_t>(last.data.size());
+    return;
+  }
+
+  const auto size{static_cast<std::int64_t>(data.size())};
+  _segments.push_back({.data = std::move(data), .end = size});
+}
+
+void WriteQueue::pushFile(const std::filesystem::path &filePath) {
+  if (filePath.empty()) {
+    throw std::runtime_error("Empty file path");
+  }
+
+  const int fileFd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fileFd < 0) {
+    throw std::runtime_error("Failed to open file");
+  }
+
+  struct stat stats{};
+  if (::fstat(fileFd, &stats) < 0) {
+    ::close(fileFd);
+    throw std::runtime_error("Failed to stat file");
+  }
+
+  if (stats.st_size == 0) {
+    ::close(fileFd);
+    return;
+  }
+
+  _pendingBytes += static_cast<std::size_t>(stats.st_size);
+  _segments.push_back({.fileFd = fileFd, .end = stats.st_size});
+}
+
+bool WriteQueue::flush(ISocket &socket) {
+  while (!_segments.empty()) {
+    auto &segment{_segments.front()};
+    const auto offsetBefore{segment.offset};
+    const auto zeroCopyBefore{socket.zeroCopyIssued()};
+    const auto finished{_flushSegment(socket, segment, _segments.size() > 1)};
+
+    const auto bytesSent{
+        static_cast<std::size_t>(segment.offset - offsetBefore)};
+    _pendingBytes -= bytesSent;
+
+    if (segment.fileFd < 0) {
+      _bufferedBytes -= bytesSent;
+    }
+
+    if (socket.zeroCopyIssued() != zeroCopyBefore) {
+      segment.zeroCopyId = socket.zeroCopyIssued();
+    }
+
+    if (!finished) {
+      return false;  // socket buffer is full
+    }
+
+    if (segment.zeroCopyId.has_value()) {
+      _pinned.push_back({.data = std::move(segment.data),
+                         .zeroCopyId = segment.zeroCopyId.value()});
+    }
+
+    _closeSegment(segment);
+    _segments.pop_front();
+  }
+
+  return releaseCompleted(socket);
+}
+
+bool WriteQueue::releaseCompleted(ISocket &socket) {
+  if (_pinned.empty()) {
+    return true;
+  }
+
+  const auto completed{socket.reapZeroCopyCompletions()};
+
+  while (!_pinned.empty() && _pinned.front().zeroCopyId <= completed) {
+    _pinned.pop_front();
+  }
+
+  return _pinned.empty();
+}
+
+bool WriteQueue::_flushSegment(ISocket &socket, Segment &segment,
+                               const bool moreFollows) {
+  while (segment.offset < segment.end) {
+    if (segment.fileFd < 0) {
+      const auto bytesSent{socket.sendSome(
+          std::span{segment.data}.subspan(
+              static_cast<std::size_t>(segment.offset)),
+          moreFollows)};
+
+      if (!bytesSent.has_value()) {
+        return false;
+      }
+
+      segment.offset += static_cast<std::int64_t>(bytesSent.value());
+      continue;
+    }
+
+    const auto chunkSize{std::min(segment.end - segment.offset,
+                                  kMaxFileChunkSize)};
+    const auto bytesSent{socket.sendFileSome(
+        segment.fileFd, segment.offset, static_cast<std::size_t>(chunkSize))};
+
+    if (!bytesSent.has_value()) {
+      return false;
+    }
+
+    if (bytesSent.value() == 0) {
+      throw std::runtime_error("File truncated while sending");
+    }
+  }
+
+  return true;
+}
+
+void WriteQueue::clear() noexcept {
+  for (auto &segment : _segments) {
+    _closeSegment(segment);
+
+    // A partly sent buffer may be read by a zero-copy send in flight.
+    if (segment.zeroCopyId.has_value()) {
+      _pinned.push_back({.data = std::move(segment.data),
+                         .zeroCopyId = segment.zeroCopyId.value()});
+    }
+  }
+
+  _segments.clear();
+  _pendingBytes = 0;
+  _bufferedBytes = 0;
+}
+
+bool WriteQueue::empty() const noexcept {
+  return _segments.empty() && _pinned.empty();
+}
+
+std::size_t WriteQueue::pendingBytes() const noexcept {
+  return _pendingBytes;
+}
+
+std::size_t WriteQueue::bufferedBytes() const noexcept {
+  return _bufferedBytes;
+}
+
+void WriteQueue::_closeSegment(Segment &segment) noexcept {
+  if (segment.fileFd >= 0) {
+    ::close(segment.fileFd);
+    segment.fileFd = -1;
+  }
+}
+
+}  // namespace webserver::net
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "Socket.h"
+
+namespace webserver::net {
+
+// Pending output of a connection: in-memory buffers and file ranges sent in
+// order. flush() writes as much as the socket accepts without blocking and
+// remembers where it stopped, so a short write only delays the rest of the
+// response until the socket is writable again. Buffers the socket sent with
+// MSG_ZEROCOPY are kept until the kernel reports it is done with them.
+class WriteQueue {
+ public:
+  WriteQueue() = default;
+  WriteQueue(const WriteQueue &) = delete;
+  WriteQueue(WriteQueue &&) = delete;
+  WriteQueue &operator=(const WriteQueue &) = delete;
+  WriteQueue &operator=(WriteQueue &&) = delete;
+  ~WriteQueue();
+
+  void pushBuffer(std::string data);
+  // Opens the file right away so that a missing file fails in the handler.
+  void pushFile(const std::filesystem::path &filePath);
+
+  // Returns true once everything queued has been written and no zero-copy
+  // send still references a buffer.
+  [[nodiscard]] bool flush(ISocket &socket);
+  // Frees the buffers the kernel is done with; true once none is left.
+  [[nodiscard]] bool releaseCompleted(ISocket &socket);
+  // Drops whatever is not sent yet. Buffers a zero-copy send may still read
+  // stay until releaseCompleted() frees them, or until the queue goes; the
+  // owner must not destroy it before the completions are in or the socket
+  // is closed with its unsent data discarded.
+  void clear() noexcept;
+
+  [[nodiscard]] bool empty() const noexcept;
+  [[nodiscard]] std::size_t pendingBytes() const noexcept;
+  // Part of pendingBytes() held in memory, i.e. not file ranges.
+  [[nodiscard]] std::size_t bufferedBytes() const noexcept;
+
+ private:
+  // Either a buffer (fileFd < 0) or an open file range; `offset` is the
+  // progress within the buffer or the file.
+  struct Segment {
+    std::string data{};
+    int fileFd{-1};
+    std::int64_t offset{0};
+    std::int64_t end{0};
+    std::optional<std::uint32_t> zeroCopyId{};  // last zero-copy send
+  };
+
+  // Fully sent buffer whose pages the kernel may still be reading.
+  struct PinnedBuffer {
+    std::string data;
+    std::uint32_t zeroCopyId;
+  };
+
+  // `moreFollows` corks a buffer that is followed by another segment, so a
+  // response head leaves together with the start of its file.
+  [[nodiscard]] static bool _flushSegment(ISocket &socket, Segment &segment,
+                                          bool moreFollows);
+  static void _closeSegment(Segment &segment) noexcept;
+
+  std::deque<Segment> _segments;
+  std::deque<PinnedBuffer> _pinned;
+  std::size_t _pendingBytes{0};
+  std::size_t _bufferedBytes{0};
+};
+
+}  // namespace webserver::net
@@ -0,0 +1,73 @@
+#include "RequestClassifier.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#include "HttpBase.h"
+
+namespace webserver::core {
+
+RequestClassifier::RequestClassifier(const Rules &rules)
+    : _pathPrefixes{rules.pathPrefixes},
+      _methods{rules.methods},
+      _minFileSize{rules.minFileSize},
+      _contentDirectory{rules.contentDirectory.string()} {
+  for (const auto &method : _methods) {
+    if (!http::getStrToMethodMap().contains(method)) {
+      throw std::invalid_argument("Unknown HTTP method in lanes: " + method);
+    }
+  }
+}
+
+Lane RequestClassifier::classify(const std::string_view request) const {
+  if (empty()) {
+    return Lane::INTERACTIVE;
+  }
+
+  const auto methodEnd{request.find(' ')};
+  const auto targetEnd{request.find_first_of(" \r\n", methodEnd + 1)};
+
+  if (methodEnd == std::string_view::npos ||
+      targetEnd == std::string_view::npos) {
+    return Lane::INTERACTIVE;
+  }
+
+  const auto method{request.substr(0, methodEnd)};
+
+  if (std::ranges::find(_methods, method) != _methods.end()) {
+    return Lane::BULK;
+  }
+
+  // Same normalisation as the access rules, so /./iso/ is still /iso/.
+  const auto target{request.substr(methodEnd + 1, targetEnd - methodEnd - 1)};
+  const auto path{std::filesystem::path{target.substr(0, target.find('?'))}
+                      .lexically_normal()
+                      .generic_string()};
+
+  const auto isBulkPath{
+      std::ranges::any_of(_pathPrefixes, [&path](const std::string &prefix) {
+        return path.starts_with(prefix);
+      })};
+
+  return isBulkPath || _isLargeFile(path) ? Lane::BULK : Lane::INTERACTIVE;
+}
+
+bool RequestClassifier::empty() const noexcept {
+  return _pathPrefixes.empty() && _methods.empty() && _minFileSize == 0;
+}
+
+bool RequestClassifier::_isLargeFile(const std::string &path) const {
+  if (_minFileSize == 0 || path.find("..") != std::string::npos) {
+    return false;
+  }
+
+  // One stat() on the dispatching thread; missing files are answered with
+  // 404 quickly anyway.
+  std::error_code error;
+  const auto size{std::filesystem::file_size(_contentDirectory + path, error)};
+
+  return !error && size >= _minFileSize;
+}
+
+}  // namespace webserver::core
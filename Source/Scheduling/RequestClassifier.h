@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Lane.h"
+
+namespace webserver::core {
+
+// Sorts requests into pool lanes before they are dispatched. A request is
+// bulk if any rule matches: its method is one of the bulk methods, its path
+// starts with a bulk prefix, or it names a file under the content directory
+// of at least minFileSize bytes (0 disables the size rule). Everything else
+// is interactive.
+class RequestClassifier {
+ public:
+  struct Rules {
+    std::vector<std::string> pathPrefixes{};
+    std::vector<std::string> methods{};
+    std::size_t minFileSize{0};
+    std::filesystem::path contentDirectory{};
+  };
+
+  // Throws std::invalid_argument for unknown methods.
+  explicit RequestClassifier(const Rules &rules);
+
+  // `request` is the start of a buffered request; only its request line is
+  // looked at. Malformed ones are left to the parser and stay interactive.
+  [[nodiscard]] Lane classify(std::string_view request) const;
+  [[nodiscard]] bool empty() const noexcept;
+
+ private:
+  [[nodiscard]] bool _isLargeFile(const std::string &path) const;
+
+  std::vector<std::string> _pathPrefixes;
+  std::vector<std::string> _methods;
+  std::size_t _minFileSize;
+  std::string _contentDirectory;
+};
+
+}  // namespace webserver::core
@@ -0,0 +1,105 @@
+#include "AccessControl.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+
+namespace webserver::core {
+
+constexpr unsigned kV4Length = 32;
+// IPv4 prefixes sit below ::ffff:0:0/96 in the 128-bit address space.
+constexpr unsigned kV4MappedOffset = PrefixTrie::kMaxLength - kV4Length;
+
+AccessControl::AccessControl(const std::vector<config::AccessRule> &rules) {
+  _rules.reserve(rules.size());
+
+  for (const auto &rule : rules) {
+    PathRule compiled{.pathPrefix = rule.pathPrefix,
+                      .prefixes = {},
+                      .allowUnmatched = rule.allow.empty()};
+
+    // Allow entries go in first so a prefix listed on both sides is denied.
+    for (const auto &text : rule.allow) {
+      const auto [address, length]{_parsePrefix(text)};
+      compiled.prefixes.insert(address, length, true);
+    }
+    for (const auto &text : rule.deny) {
+      const auto [address, length]{_parsePrefix(text)};
+      compiled.prefixes.insert(address, length, false);
+    }
+
+    _rules.push_back(std::move(compiled));
+  }
+
+  std::ranges::stable_sort(_rules, std::ranges::greater{},
+                           [](const PathRule &rule) {
+                             return rule.pathPrefix.size();
+                           });
+}
+
+bool AccessControl::isAllowed(const std::string_view uri,
+                              const std::optional<net::IpAddress> &peer) const {
+  if (_rules.empty() || !peer.has_value()) {
+    return true;
+  }
+
+  // Match the path the file lookup will end up using, so that spellings
+  // like /./internal/ or //internal/ cannot sidestep a rule.
+  const auto path{std::filesystem::path{uri.substr(0, uri.find('?'))}
+                      .lexically_normal()
+                      .generic_string()};
+
+  const auto ruleIt{std::ranges::find_if(_rules, [&path](const PathRule &rule) {
+    return path.starts_with(rule.pathPrefix);
+  })};
+
+  if (ruleIt == _rules.end()) {
+    return true;
+  }
+
+  return ruleIt->prefixes.match(*peer).value_or(ruleIt->allowUnmatched);
+}
+
+bool AccessControl::empty() const noexcept {
+  return _rules.empty();
+}
+
+AccessControl::Prefix AccessControl::_parsePrefix(const std::string &text) {
+  if (text == "all") {
+    return {.address = net::IpAddress{}, .length = 0};
+  }
+
+  const auto slash{text.find('/')};
+  const auto address{net::IpAddress::parse(text.substr(0, slash))};
+
+  if (!address.has_value()) {
+    throw std::invalid_argument("Invalid address in ACL: " + text);
+  }
+
+  // Lengths count from the notation used: ::ffff:10.0.0.0/104 and
+  // 10.0.0.0/8 are the same prefix.
+  const auto isV4Notation{text.find(':') == std::string::npos};
+  const auto maxLength{isV4Notation ? kV4Length : PrefixTrie::kMaxLength};
+  auto length{maxLength};
+
+  if (slash != std::string::npos) {
+    constexpr std::size_t kMaxLengthDigits{3};
+    const auto lengthText{text.substr(slash + 1)};
+
+    if (lengthText.empty() || lengthText.size() > kMaxLengthDigits ||
+        !std::ranges::all_of(lengthText, [](const unsigned char chr) {
+          return std::isdigit(chr) != 0;
+        }) ||
+        std::stoul(lengthText) > maxLength) {
+      throw std::invalid_argument("Invalid prefix length in ACL: " + text);
+    }
+
+    length = static_cast<unsigned>(std::stoul(lengthText));
+  }
+
+  return {.address = *address,
+          .length = isV4Notation ? kV4MappedOffset + length : length};
+}
+
+}  // namespace webserver::core
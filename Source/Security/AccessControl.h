@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Config.h"
+#include "IpAddress.h"
+#include "PrefixTrie.h"
+
+namespace webserver::core {
+
+// Per-path IP allow/deny lists. Every configured rule is compiled into its
+// own PrefixTrie at startup; a request is judged by the rule with the
+// longest matching path prefix, and within it by the most specific CIDR
+// prefix containing the client. Clients matching no prefix are denied if the
+// rule has allow entries (allowlist) and allowed otherwise (blocklist).
+class AccessControl {
+ public:
+  // Throws std::invalid_argument for malformed prefixes.
+  explicit AccessControl(const std::vector<config::AccessRule> &rules);
+
+  // `uri` is the request target as received; the query is ignored and the
+  // path normalised before matching. Peers without an IP address (e.g. local
+  // sockets) are always allowed.
+  [[nodiscard]] bool isAllowed(std::string_view uri,
+                               const std::optional<net::IpAddress> &peer) const;
+  [[nodiscard]] bool empty() const noexcept;
+
+ private:
+  struct PathRule {
+    std::string pathPrefix;
+    PrefixTrie prefixes;
+    bool allowUnmatched;
+  };
+
+  struct Prefix {
+    net::IpAddress address;
+    unsigned length;
+  };
+
+  // "10.0.0.0/8", "2001:db8::/32", a bare address, or "all".
+  [[nodiscard]] static Prefix _parsePrefix(const std::string &text);
+
+  std::vector<PathRule> _rules;  // longest path prefix first
+};
+
+}  // namespace webserver::core
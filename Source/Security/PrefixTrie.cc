@@ -0,0 +1,172 @@
+#include "PrefixTrie.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace webserver::core {
+
+constexpr unsigned kWordBits = 64;
+
+void PrefixTrie::insert(const net::IpAddress &address, const unsigned length,
+                        const bool allowed) {
+  if (length > kMaxLength) {
+    throw std::invalid_argument("Prefix length must not exceed 128");
+  }
+
+  const auto key{_truncate(_toKey(address), length)};
+  const auto value{allowed ? Value::ALLOW : Value::DENY};
+
+  if (_root == kNoNode) {
+    _root = _newNode(key, length, value);
+    ++_prefixes;
+    return;
+  }
+
+  // Indices rather than references: _newNode() may reallocate _nodes.
+  auto current{_root};
+  auto parent{kNoNode};
+  unsigned side{0};
+
+  while (true) {
+    const auto nodeKey{_nodes.at(current).key};
+    const unsigned nodeLength{_nodes.at(current).length};
+    const auto common{
+        _commonLength(key, nodeKey, std::min(length, nodeLength))};
+
+    if (common == nodeLength) {
+      if (length == nodeLength) {
+        _prefixes += _nodes.at(current).value == Value::NONE ? 1 : 0;
+        _nodes.at(current).value = value;
+        return;
+      }
+
+      const auto bit{_bitAt(key, nodeLength)};
+      const auto child{_nodes.at(current).children.at(bit)};
+
+      if (child == kNoNode) {
+        const auto leaf{_newNode(key, length, value)};
+        _nodes.at(current).children.at(bit) = leaf;
+        ++_prefixes;
+        return;
+      }
+
+      parent = current;
+      side = bit;
+      current = child;
+      continue;
+    }
+
+    // The new prefix leaves the node's path at bit `common`: either it ends
+    // there and becomes the node's parent, or a branch node is needed.
+    std::uint32_t replacement{kNoNode};
+
+    if (common == length) {
+      replacement = _newNode(key, length, value);
+      _nodes.at(replacement).children.at(_bitAt(nodeKey, length)) = current;
+    } else {
+      replacement = _newNode(_truncate(key, common), common, Value::NONE);
+      const auto leaf{_newNode(key, length, value)};
+      _nodes.at(replacement).children.at(_bitAt(key, common)) = leaf;
+      _nodes.at(replacement).children.at(_bitAt(nodeKey, common)) = current;
+    }
+
+    if (parent == kNoNode) {
+      _root = replacement;
+    } else {
+      _nodes.at(parent).children.at(side) = replacement;
+    }
+
+    ++_prefixes;
+    return;
+  }
+}
+
+std::optional<bool> PrefixTrie::match(
+    const net::IpAddress &address) const noexcept {
+  const auto key{_toKey(address)};
+  auto best{Value::NONE};
+  auto current{_root};
+
+  while (current != kNoNode) {
+    const auto &node{_nodes[current]};
+
+    if (_commonLength(key, node.key, node.length) < node.length) {
+      break;
+    }
+
+    if (node.value != Value::NONE) {
+      best = node.value;
+    }
+
+    if (node.length == kMaxLength) {
+      break;
+    }
+
+    current = node.children[_bitAt(key, node.length)];
+  }
+
+  if (best == Value::NONE) {
+    return std::nullopt;
+  }
+
+  return best == Value::ALLOW;
+}
+
+std::size_t PrefixTrie::size() const noexcept {
+  return _prefixes;
+}
+
+bool PrefixTrie::empty() const noexcept {
+  return _prefixes == 0;
+}
+
+PrefixTrie::Key PrefixTrie::_toKey(const net::IpAddress &address) noexcept {
+  Key key{.high = 0, .low = 0};
+  const auto &bytes{address.bytes()};
+
+  for (std::size_t i = 0; i < bytes.size() / 2; ++i) {
+    key.high = (key.high << 8U) | bytes.at(i);
+    key.low = (key.low << 8U) | bytes.at(i + (bytes.size() / 2));
+  }
+
+  return key;
+}
+
+PrefixTrie::Key PrefixTrie::_truncate(const Key &key,
+                                      const unsigned length) noexcept {
+  const auto mask{[](const unsigned bits) {
+    return bits == 0 ? std::uint64_t{0}
+                     : ~std::uint64_t{0} << (kWordBits - bits);
+  }};
+
+  return {.high = key.high & mask(std::min(length, kWordBits)),
+          .low = key.low &
+                 mask(length > kWordBits ? length - kWordBits : 0)};
+}
+
+unsigned PrefixTrie::_commonLength(const Key &lhs, const Key &rhs,
+                                   const unsigned limit) noexcept {
+  const auto highDiff{lhs.high ^ rhs.high};
+  const auto common{highDiff != 0
+                        ? static_cast<unsigned>(std::countl_zero(highDiff))
+                        : kWordBits + static_cast<unsigned>(std::countl_zero(
+                                          lhs.low ^ rhs.low))};
+  return std::min(common, limit);
+}
+
+unsigned PrefixTrie::_bitAt(const Key &key, const unsigned position) noexcept {
+  const auto word{position < kWordBits ? key.high : key.low};
+  return static_cast<unsigned>(
+      (word >> (kWordBits - 1 - (position % kWordBits))) & 1U);
+}
+
+std::uint32_t PrefixTrie::_newNode(const Key &key, const unsigned length,
+                                   const Value value) {
+  _nodes.push_back({.key = key,
+                    .length = static_cast<std::uint8_t>(length),
+                    .value = value});
+  return static_cast<std::uint32_t>(_nodes.size() - 1);
+}
+
+}  // namespace webserver::core
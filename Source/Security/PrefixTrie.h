@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "IpAddress.h"
+
+namespace webserver::core {
+
+// Longest-prefix match over IP prefixes: a path-compressed binary (Patricia)
+// trie on the 128-bit IpAddress form, so IPv4 prefixes are stored as /96+n
+// below ::ffff:0:0/96. Only nodes where prefixes diverge or end exist, so a
+// lookup visits a handful of nodes even for tens of thousands of prefixes;
+// the nodes sit in one contiguous array built once at startup.
+class PrefixTrie {
+ public:
+  static constexpr unsigned kMaxLength = 128;
+
+  PrefixTrie() = default;
+
+  // Maps `address/length` to `allowed`; re-inserting a prefix overwrites it.
+  // Throws std::invalid_argument for lengths above kMaxLength.
+  void insert(const net::IpAddress &address, unsigned length, bool allowed);
+
+  // Value of the longest prefix containing `address`, if any.
+  [[nodiscard]] std::optional<bool> match(
+      const net::IpAddress &address) const noexcept;
+
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+
+ private:
+  static constexpr std::uint32_t kNoNode = UINT32_MAX;
+
+  struct Key {
+    std::uint64_t high;
+    std::uint64_t low;
+  };
+
+  enum class Value : std::uint8_t { NONE, ALLOW, DENY };
+
+  // 32 bytes, two nodes per cache line.
+  struct Node {
+    Key key;  // bits past `length` are zero
+    std::array<std::uint32_t, 2> children{kNoNode, kNoNode};
+    std::uint8_t length;
+    Value value;
+  };
+
+  [[nodiscard]] static Key _toKey(const net::IpAddress &address) noexcept;
+  [[nodiscard]] static Key _truncate(const Key &key, unsigned length) noexcept;
+  [[nodiscard]] static unsigned _commonLength(const Key &lhs, const Key &rhs,
+                                              unsigned limit) noexcept;
+  [[nodiscard]] static unsigned _bitAt(const Key &key,
+                                       unsigned position) noexcept;
+  [[nodiscard]] std::uint32_t _newNode(const Key &key, unsigned length,
+                                       Value value);
+
+  std::vector<Node> _nodes;
+  std::uint32_t _root{kNoNode};
+  std::size_t _prefixes{0};
+};
+
+}  // namespace webserver::core
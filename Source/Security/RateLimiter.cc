@@ -0,0 +1,102 @@
+#include "RateLimiter.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace webserver::core {
+
+RateLimiter::RateLimiter(const Options &options)
+    : _options{options},
+      _shardCapacity{std::max<std::size_t>(1, options.maxClients / kShards)} {
+  if (options.ratePerSecond == 0 || options.burst == 0) {
+    throw std::invalid_argument("Rate limit and burst must be positive");
+  }
+}
+
+bool RateLimiter::tryAcquire(const net::IpAddress &client,
+                             const Clock::time_point now) {
+  if (!_options.enabled) {
+    return true;
+  }
+
+  auto &shard{_shards.at(net::IpAddressHash{}(client) % kShards)};
+
+  {
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto &bucket{_bucketFor(shard, client, now)};
+
+    if (bucket.tokens >= 1.0) {
+      bucket.tokens -= 1.0;
+      return true;
+    }
+  }
+
+  _rejected.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool RateLimiter::enabled() const noexcept {
+  return _options.enabled;
+}
+
+std::size_t RateLimiter::trackedClients() {
+  std::size_t count{0};
+
+  for (auto &shard : _shards) {
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    count += shard.index.size();
+  }
+
+  return count;
+}
+
+std::uint64_t RateLimiter::rejectedCount() const noexcept {
+  return _rejected.load(std::memory_order_relaxed);
+}
+
+RateLimiter::Bucket &RateLimiter::_bucketFor(Shard &shard,
+                                             const net::IpAddress &client,
+                                             const Clock::time_point now) {
+  const auto indexIt{shard.index.find(client)};
+
+  if (indexIt != shard.index.end()) {
+    shard.buckets.splice(shard.buckets.begin(), shard.buckets,
+                         indexIt->second);
+    _refill(shard.buckets.front(), now);
+    return shard.buckets.front();
+  }
+
+  const Bucket fresh{.client = client,
+                     .tokens = static_cast<double>(_options.burst),
+                     .updatedAt = now};
+
+  if (shard.index.size() < _shardCapacity) {
+    shard.buckets.push_front(fresh);
+  } else {
+    // Recycle the least recently seen bucket instead of allocating.
+    shard.index.erase(shard.buckets.back().client);
+    shard.buckets.splice(shard.buckets.begin(), shard.buckets,
+                         std::prev(shard.buckets.end()));
+    shard.buckets.front() = fresh;
+  }
+
+  shard.index.emplace(client, shard.buckets.begin());
+  return shard.buckets.front();
+}
+
+void RateLimiter::_refill(Bucket &bucket,
+                          const Clock::time_point now) const noexcept {
+  if (now <= bucket.updatedAt) {
+    return;
+  }
+
+  const std::chrono::duration<double> elapsed{now - bucket.updatedAt};
+  bucket.tokens =
+      std::min(static_cast<double>(_options.burst),
+               bucket.tokens + (elapsed.count() *
+                                static_cast<double>(_options.ratePerSecond)));
+  bucket.updatedAt = now;
+}
+
+}  // namespace webserver::core
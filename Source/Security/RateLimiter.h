@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "IpAddress.h"
+
+namespace webserver::core {
+
+// Per-client token buckets: every client address may spend `ratePerSecond`
+// tokens per second with bursts of up to `burst`. Buckets live in a table
+// striped over kShards independently locked shards, so threads checking
+// different clients rarely contend. Memory is bounded by `maxClients`; when
+// a shard is full its least recently seen client is evicted, which at worst
+// hands that client a fresh (full) bucket.
+class RateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    bool enabled{false};
+    std::size_t ratePerSecond{100};
+    std::size_t burst{200};
+    std::size_t maxClients{65536};
+  };
+
+  explicit RateLimiter(const Options &options);
+  RateLimiter(const RateLimiter &) = delete;
+  RateLimiter(RateLimiter &&) = delete;
+  RateLimiter &operator=(const RateLimiter &) = delete;
+  RateLimiter &operator=(RateLimiter &&) = delete;
+  ~RateLimiter() = default;
+
+  // Takes one token from the client's bucket; false means the client is over
+  // its rate. Always true when disabled.
+  [[nodiscard]] bool tryAcquire(const net::IpAddress &client,
+                                Clock::time_point now = Clock::now());
+
+  [[nodiscard]] bool enabled() const noexcept;
+  [[nodiscard]] std::size_t trackedClients();
+  [[nodiscard]] std::uint64_t rejectedCount() const noexcept;
+
+ private:
+  static constexpr std::size_t kShards = 64;
+
+  struct Bucket {
+    net::IpAddress client;
+    double tokens;
+    Clock::time_point updatedAt;
+  };
+
+  using LruList = std::list<Bucket>;
+
+  struct alignas(64) Shard {  // one cache line per lock
+    std::mutex mutex;
+    LruList buckets;  // most recently seen first
+    std::unordered_map<net::IpAddress, LruList::iterator, net::IpAddressHash>
+        index;
+  };
+
+  [[nodiscard]] Bucket &_bucketFor(Shard &shard, const net::IpAddress &client,
+                                   Clock::time_point now);
+  void _refill(Bucket &bucket, Clock::time_point now) const noexcept;
+
+  const Options _options;
+  const std::size_t _shardCapacity;
+  std::array<Shard, kShards> _shards;
+  std::atomic<std::uint64_t> _rejected{0};
+};
+
+}  // namespace webserver::core
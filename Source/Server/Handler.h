@@ -2,8 +2,9 @@
 
 #include <expected>
 
+#include "AsyncSocket.h"
+#include "AsyncTask.h"
 #include "HttpResponse.h"
-#include "Socket.h"
 
 namespace webserver::net {
 
@@ -11,9 +12,14 @@ enum class ConnType : std::uint8_t { CLOSE, KEEP_ALIVE };
 
 using HandlingResult = std::expected<ConnType, http::HttpError>;
 
+// Serves one request as a coroutine. It may suspend on the socket's
+// awaitable operations or on anything else it waits for (an upstream, a
+// disk read); the thread that ran it is free to serve other connections
+// until it is resumed.
 class IHandler {
  public:
-  [[nodiscard]] virtual HandlingResult handle(ISocket& clientSocket) const = 0;
+  [[nodiscard]] virtual core::AsyncTask<HandlingResult> handle(
+      AsyncSocket& clientSocket) const = 0;
 
   virtual ~IHandler() = default;
 };
@@ -1,27 +1,80 @@
 #include "HttpServer.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iterator>
 #include <print>
 #include <stdexcept>
+#include <thread>
+
+#include <fmt/core.h>
 
 #include "Config.h"
+#include "EpollReactor.h"
 #include "Handler.h"
 #include "HttpResponse.h"
 #include "SocketFactory.h"
+#include "Utils.h"
 
 namespace webserver::net {
 
 constexpr auto kMinPort{1};
 constexpr auto kMaxPort{65535};
+constexpr auto kStatsPollInterval{std::chrono::milliseconds{100}};
+// How often the handoff thread re-checks for shutdown between successors.
+constexpr auto kHandoffPollInterval{std::chrono::milliseconds{500}};
 
 using namespace http;
 
 HttpServer::HttpServer(config::Config config, const IHandler& handler)
     : _config{std::move(config)},
-      _threadPool{_config.threadsCount},
-      _handler{handler} {
-  _throwIfPortIsInvalid();
-  _serverSocket = SocketFactory::newSocket();
-  _serverSocket->bind(_config.port);
+      _endpoints{_parseEndpoints()},
+      _handler{handler},
+      _connectionLimiter{{.enabled = _config.rateLimit,
+                          .ratePerSecond = _config.connectionsPerSec,
+                          .burst = _config.connectionBurst,
+                          .maxClients = _config.rateLimitClients}},
+      _requestLimiter{{.enabled = _config.rateLimit,
+                       .ratePerSecond = _config.requestsPerSec,
+                       .burst = _config.requestBurst,
+                       .maxClients = _config.rateLimitClients}},
+      _classifier{{.pathPrefixes = _config.bulkPaths,
+                   .methods = _config.bulkMethods,
+                   .minFileSize = _config.bulkFileSize,
+                   .contentDirectory = _config.contentDirectory}},
+      _rejectedClients{LingeringCloser::Options{}} {
+  if (_config.tls) {
+    _tlsContext = std::make_shared<TlsContext>(
+        TlsContext::Options{.certificate = _config.tlsCertificate,
+                            .privateKey = _config.tlsPrivateKey,
+                            .kernelOffload = _config.tlsKernelOffload,
+                            .sessionTickets = _config.tlsSessionTickets});
+  }
+
+  if (!SocketFactory::isBackendSupported(_config.socketBackend)) {
+    std::println("Requested socket backend is unavailable, using POSIX");
+  }
+
+  if (!_config.handoffSocket.empty()) {
+    _handoff = std::make_unique<ListenerHandoff>(_config.handoffSocket);
+    _inheritedListeners = _handoff->takeOver();
+  }
+
+  try {
+    _createShards();
+  } catch (...) {
+    ListenerHandoff::closeAll(_inheritedListeners);
+    throw;
+  }
+
+  if (!_inheritedListeners.empty()) {
+    // The new configuration no longer listens there.
+    std::println("Closing {} inherited listeners not in use",
+                 _inheritedListeners.size());
+    ListenerHandoff::closeAll(_inheritedListeners);
+  }
 }
 
 void HttpServer::_throwIfPortIsInvalid() const {
@@ -30,24 +83,460 @@ void HttpServer::_throwIfPortIsInvalid() const {
   }
 }
 
+std::vector<Endpoint> HttpServer::_parseEndpoints() const {
+  if (_config.listenAddresses.empty()) {
+    _throwIfPortIsInvalid();
+    return {Endpoint::anyAddress(_config.port)};
+  }
+
+  std::vector<Endpoint> endpoints;
+  endpoints.reserve(_config.listenAddresses.size());
+
+  for (const auto& address : _config.listenAddresses) {
+    endpoints.push_back(Endpoint::parse(address));
+  }
+
+  return endpoints;
+}
+
+void HttpServer::_createShards() {
+  // Extra shards would have nothing to listen on with Unix sockets only.
+  const auto hasTcpEndpoint{std::ranges::any_of(
+      _endpoints, [](const Endpoint& endpoint) { return !endpoint.isUnix(); })};
+  const auto shardsCount{
+      hasTcpEndpoint ? static_cast<std::size_t>(_config.listenersCount) : 1};
+  const auto threadsCount{static_cast<std::size_t>(_config.threadsCount)};
+  const auto maxThreadsCount{std::max(
+      threadsCount, static_cast<std::size_t>(_config.maxThreadsCount))};
+
+  auto placement{_placeShards(shardsCount)};
+
+  _shards.reserve(shardsCount);
+
+  for (std::size_t i = 0; i < shardsCount; ++i) {
+    // Spread workers evenly, every shard gets at least one.
+    const auto split{[&](const std::size_t count) {
+      return std::max<std::size_t>(
+          1, (count / shardsCount) + (i < count % shardsCount ? 1 : 0));
+    }};
+    const auto shardThreads{split(threadsCount)};
+    const auto shardMaxThreads{split(maxThreadsCount)};
+
+    std::vector<Listener> listeners;
+
+    for (const auto& endpoint : _endpoints) {
+      if (endpoint.isUnix() && i > 0) {
+        continue;
+      }
+
+      listeners.push_back(
+          {.endpoint = endpoint,
+           .socket = _openListener(i, endpoint,
+                                   shardsCount > 1 && !endpoint.isUnix())});
+    }
+
+    auto cpus{std::move(placement.at(i))};
+    auto threadPool{std::make_unique<core::ThreadPool>(
+        core::ThreadPool::Options{
+            .minThreads = static_cast<int>(shardThreads),
+            .maxThreads = static_cast<int>(shardMaxThreads),
+            .growDelay = _config.poolGrowDelay,
+            .shrinkDelay = _config.poolIdleTimeout,
+            .interactiveWeight = _config.interactiveWeight,
+            .bulkWeight = _config.bulkWeight,
+            .interactiveReserve = _config.interactiveReserve},
+        [cpus](int /*workerIndex*/) { utils::pinCurrentThreadToCpus(cpus); })};
+
+    // Never shed below one request per worker; the queue on top of that is
+    // what the controller trims when requests start waiting too long. An
+    // elastic pool may grow, so its ceiling counts the workers it can reach.
+    auto admission{std::make_unique<core::AdmissionController>(
+        core::AdmissionController::Options{
+            .enabled = _config.admissionControl,
+            .minLimit = shardThreads,
+            .maxLimit = shardMaxThreads + _config.admissionMaxQueue,
+            .targetDelay = _config.admissionTargetDelay})};
+
+    _shards.push_back({.index = i,
+                       .cpus = std::move(cpus),
+                       .listeners = std::move(listeners),
+                       .threadPool = std::move(threadPool),
+                       .admission = std::move(admission)});
+  }
+}
+
+std::vector<std::vector<int>> HttpServer::_placeShards(
+    const std::size_t shardsCount) {
+  std::vector<std::vector<int>> placement(shardsCount);
+
+  if (!_config.cpuLocality && !_config.numaPlacement &&
+      _config.workerCpus.empty()) {
+    return placement;
+  }
+
+  auto cpus{utils::getAllowedCpus()};
+
+  if (cpus.empty()) {
+    return placement;  // affinity is not supported here
+  }
+  if (!_config.workerCpus.empty()) {
+    std::erase_if(cpus, [this](const int cpu) {
+      return !std::ranges::binary_search(_config.workerCpus, cpu);
+    });
+
+    if (cpus.empty()) {
+      throw std::invalid_argument(
+          "server.worker_cpus contains no CPU the process may run on");
+    }
+  }
+
+  if (_config.cpuLocality) {
+    _cpuOwners.resize(static_cast<std::size_t>(cpus.back()) + 1);
+
+    for (std::size_t cpu = 0; cpu < _cpuOwners.size(); ++cpu) {
+      _cpuOwners.at(cpu) = cpu % shardsCount;
+    }
+  }
+
+  // Shards are dealt round-robin over the groups; without NUMA placement
+  // (or topology) there is a single group.
+  std::vector<std::vector<int>> groups;
+
+  if (_config.numaPlacement) {
+    for (auto node : utils::getNumaNodes()) {
+      std::erase_if(node, [&cpus](const int cpu) {
+        return !std::ranges::binary_search(cpus, cpu);
+      });
+
+      if (!node.empty()) {
+        groups.push_back(std::move(node));
+      }
+    }
+  }
+  if (groups.empty()) {
+    groups.push_back(std::move(cpus));
+  }
+
+  for (std::size_t i = 0; i < shardsCount; ++i) {
+    const auto& group{groups.at(i % groups.size())};
+
+    if (!_config.cpuLocality) {
+      placement.at(i) = group;
+      continue;
+    }
+
+    // Under CPU locality the shards of a group split its CPUs, so every CPU
+    // has exactly one owner to steer its connections to.
+    const auto groupIndex{i % groups.size()};
+    const auto sharers{(shardsCount - groupIndex + groups.size() - 1) /
+                       groups.size()};
+
+    for (auto position{i / groups.size()}; position < group.size();
+         position += sharers) {
+      const auto cpu{group.at(position)};
+      _cpuOwners.at(static_cast<std::size_t>(cpu)) = i;
+      placement.at(i).push_back(cpu);
+    }
+
+    // More shards than CPUs in the group: share the group rather than run
+    // unpinned.
+    if (placement.at(i).empty()) {
+      placement.at(i) = group;
+    }
+  }
+
+  return placement;
+}
+
+std::unique_ptr<IListener> HttpServer::_openListener(
+    const std::size_t shardIndex, const Endpoint& endpoint,
+    const bool reusePort) {
+  // A listener inherited from the previous instance is already bound, and
+  // keeps the connections waiting in its accept queue.
+  const auto inherited{
+      _inheritedListeners.extract(_listenerKey(shardIndex, endpoint))};
+
+  auto serverSocket{
+      inherited.empty()
+          ? SocketFactory::newListener(_config.socketBackend)
+          : SocketFactory::adopt(inherited.mapped(), _config.socketBackend)};
+
+  if (_tlsContext != nullptr && !endpoint.isUnix()) {
+    serverSocket = SocketFactory::withTls(std::move(serverSocket), _tlsContext);
+  }
+
+  if (_config.zeroCopyThreshold > 0) {
+    serverSocket->enableZeroCopy(_config.zeroCopyThreshold);
+  }
+
+  if (inherited.empty()) {
+    if (reusePort) {
+      serverSocket->enableReusePort();
+    }
+
+    serverSocket->bind(endpoint);
+  }
+
+  return serverSocket;
+}
+
+std::string HttpServer::_listenerKey(const std::size_t shardIndex,
+                                     const Endpoint& endpoint) {
+  return fmt::format("{} {}", shardIndex, endpoint.toString());
+}
+
+void HttpServer::_enableCpuSteering() {
+  // A program is shared by a whole reuseport group, one group per TCP
+  // endpoint; the kernel indexes its listeners in listen() order, which
+  // matches the shard order. The first shard's sockets follow _endpoints.
+  try {
+    for (std::size_t i = 0; i < _endpoints.size(); ++i) {
+      if (!_endpoints.at(i).isUnix()) {
+        _shards.front().listeners.at(i).socket->enableCpuSteering(
+            _shards.size(), _cpuOwners);
+      }
+    }
+  } catch (const std::exception& e) {
+    std::println("CPU steering unavailable: {}", e.what());
+  }
+}
+
 void HttpServer::startServerLoop() {
   shutdownRequested.store(false);
-  _serverSocket->listen();
 
-  std::println("Listening on localhost:{}", _config.port);
+  for (const auto& shard : _shards) {
+    for (const auto& listener : shard.listeners) {
+      listener.socket->listen();
+    }
+  }
+
+  if (_handoff != nullptr) {
+    _handoff->confirmTakeOver();  // the previous instance starts draining
+  }
+
+  if (_config.cpuLocality && _shards.size() > 1) {
+    _enableCpuSteering();
+  }
+
+  for (const auto& endpoint : _endpoints) {
+    std::println("Listening on {}", endpoint.toString());
+  }
   std::println("Content directory: {}/", _config.contentDirectory);
 
+  if (_config.serverMode == config::ServerMode::REACTOR) {
+    std::println("Mode: epoll reactor");
+  }
+  if (!_classifier.empty() &&
+      _config.serverMode == config::ServerMode::REACTOR) {
+    std::println("Request lanes: interactive {} : bulk {}",
+                 _config.interactiveWeight, _config.bulkWeight);
+  } else if (!_classifier.empty()) {
+    std::println("Request lanes need server.mode = reactor, ignored");
+  }
+  if (_shards.size() > 1) {
+    std::println("Listeners: {} (SO_REUSEPORT{})", _shards.size(),
+                 _config.cpuLocality ? ", CPU locality" : "");
+  }
+  if (_config.maxThreadsCount > _config.threadsCount) {
+    std::println("Workers: elastic, {} to {}", _config.threadsCount,
+                 _config.maxThreadsCount);
+  }
+  if (!_shards.front().cpus.empty()) {
+    std::println("Workers pinned to CPUs{}",
+                 _config.numaPlacement ? " by NUMA node" : "");
+  }
+  if (_tlsContext != nullptr) {
+    std::println("TLS: enabled{}", _config.tlsKernelOffload
+                                       ? " (kernel offload when available)"
+                                       : "");
+  }
+
+  {
+    std::jthread statsReporter;
+
+    if (_config.statsIntervalSec > 0) {
+      statsReporter = std::jthread{
+          [this](const std::stop_token& stopToken) { _reportStats(stopToken); }};
+    }
+
+    std::jthread handoffServer;
+
+    if (_handoff != nullptr) {
+      handoffServer = std::jthread{[this](const std::stop_token& stopToken) {
+        _serveHandoff(stopToken);
+      }};
+    }
+
+    std::vector<std::jthread> acceptors;
+    acceptors.reserve(_shards.size() - 1);
+
+    for (std::size_t i = 1; i < _shards.size(); ++i) {
+      acceptors.emplace_back([this, i] { _runShard(_shards.at(i)); });
+    }
+
+    _runShard(_shards.front());
+  }
+
+  if (_config.statsIntervalSec > 0) {
+    std::println("Stats: {}", _formatStats());
+  }
+
+  if (_firstFailure != nullptr) {
+    std::rethrow_exception(_firstFailure);
+  }
+}
+
+void HttpServer::_serveHandoff(const std::stop_token& stopToken) {
+  ListenerHandoff::Listeners listeners;
+
+  for (const auto& shard : _shards) {
+    for (const auto& listener : shard.listeners) {
+      listeners.emplace(_listenerKey(shard.index, listener.endpoint),
+                        listener.socket->nativeHandle());
+    }
+  }
+
+  while (!stopToken.stop_requested() && !shutdownRequested.load()) {
+    try {
+      if (!_handoff->serve(listeners, kHandoffPollInterval)) {
+        continue;
+      }
+    } catch (const std::exception& e) {
+      std::println("Handoff error: {}", e.what());
+      continue;
+    }
+
+    std::println("Listeners handed over, draining connections");
+    _handedOff.store(true);
+    shutdownRequested.store(true);
+  }
+}
+
+void HttpServer::_reportStats(const std::stop_token& stopToken) const {
+  const auto interval{std::chrono::seconds{_config.statsIntervalSec}};
+  auto nextReport{std::chrono::steady_clock::now() + interval};
+
+  while (!stopToken.stop_requested() && !shutdownRequested.load()) {
+    std::this_thread::sleep_for(kStatsPollInterval);
+
+    if (std::chrono::steady_clock::now() >= nextReport) {
+      std::println("Stats: {}", _formatStats());
+      nextReport += interval;
+    }
+  }
+}
+
+std::string HttpServer::_formatStats() const {
+  std::uint64_t shed{0};
+  std::size_t limit{0};
+  std::size_t workers{0};
+  std::uint64_t grown{0};
+  std::uint64_t retired{0};
+
+  for (const auto& shard : _shards) {
+    shed += shard.admission->shedCount();
+    limit += shard.admission->limit();
+    workers += shard.threadPool->size();
+    grown += shard.threadPool->grownCount();
+    retired += shard.threadPool->retiredCount();
+  }
+
+  auto result{_stats.format()};
+
+  if (_config.maxThreadsCount > _config.threadsCount) {
+    result += fmt::format(" workers={} pool_grown={} pool_retired={}", workers,
+                          grown, retired);
+  }
+  if (_config.admissionControl) {
+    result += fmt::format(" shed={} admission_limit={}", shed, limit);
+  }
+  if (_config.rateLimit) {
+    result += fmt::format(" rate_limited={}",
+                          _connectionLimiter.rejectedCount() +
+                              _requestLimiter.rejectedCount());
+  }
+  if (_tlsContext != nullptr) {
+    const auto& counters{_tlsContext->counters()};
+    result += fmt::format(" tls_handshakes={} tls_resumed={} ktls={}",
+                          counters.handshakes.load(std::memory_order_relaxed),
+                          counters.resumed.load(std::memory_order_relaxed),
+                          counters.kernelOffloaded.load(
+                              std::memory_order_relaxed));
+  }
+
+  return result;
+}
+
+void HttpServer::_runShard(Shard& shard) {
+  utils::pinCurrentThreadToCpus(shard.cpus);
+
+  try {
+    if (_config.serverMode == config::ServerMode::REACTOR) {
+      _runReactorLoop(shard);
+    } else {
+      _runThreadedLoop(shard);
+    }
+  } catch (...) {
+    _recordFailure();
+  }
+
+  for (const auto& listener : shard.listeners) {
+    listener.socket->close();
+  }
+
+  shard.threadPool->stop();
+}
+
+void HttpServer::_recordFailure() {
+  {
+    std::lock_guard<std::mutex> lock{_failureMutex};
+
+    if (_firstFailure == nullptr) {
+      _firstFailure = std::current_exception();
+    }
+  }
+
+  shutdownRequested.store(true);  // bring the other shards down too
+}
+
+void HttpServer::_runThreadedLoop(Shard& shard) {
+  // One blocking accept loop per listening socket, all feeding the shard's
+  // pool. A failing loop stops the others through shutdownRequested.
+  const auto runAcceptLoop{[this, &shard](IListener& listener) {
+    try {
+      _acceptLoop(shard, listener);
+    } catch (...) {
+      _recordFailure();
+    }
+  }};
+
+  std::vector<std::jthread> acceptors;
+  acceptors.reserve(shard.listeners.size() - 1);
+
+  for (std::size_t i = 1; i < shard.listeners.size(); ++i) {
+    acceptors.emplace_back(runAcceptLoop,
+                           std::ref(*shard.listeners.at(i).socket));
+  }
+
+  runAcceptLoop(*shard.listeners.front().socket);
+}
+
+void HttpServer::_acceptLoop(Shard& shard, IListener& listener) {
   while (!shutdownRequested.load()) {
     try {
-      auto clientSocket{_serverSocket->accept()};
+      auto clientSocket{listener.accept()};
 
-      if (shutdownRequested.load()) {
+      // After a handoff the connection was taken from the queue the
+      // successor now serves, so it is served rather than dropped.
+      if (shutdownRequested.load() && !_handedOff.load()) {
         break;
       }
 
-      _threadPool.enqueue([client = std::move(clientSocket), this]() mutable {
-        _serveClient(std::move(client));
-      });
+      if (clientSocket == nullptr) {
+        continue;  // accept timed out or was interrupted
+      }
+
+      _dispatchClient(shard, std::move(clientSocket));
     } catch (const std::exception& e) {
       if (shutdownRequested.load()) {
         break;
@@ -57,31 +546,209 @@ void HttpServer::startServerLoop() {
     }
   }
 
-  _serverSocket->close();
-  _threadPool.stop();
+  if (_handedOff.load()) {
+    listener.handOff();
+
+    while (auto clientSocket{listener.accept()}) {
+      _dispatchClient(shard, std::move(clientSocket));
+    }
+  }
 }
 
-void HttpServer::_serveClient(std::unique_ptr<ISocket> clientSocket) const {
-  while (true) {
-    const auto handleResult = _handler.handle(*clientSocket);
+void HttpServer::_dispatchClient(Shard& shard,
+                                 std::unique_ptr<ISocket> clientSocket) {
+  _recordAccepted(shard, *clientSocket);
+
+  if (!_allowConnection(*clientSocket)) {
+    _rejectClient(std::move(clientSocket),
+                  StatusCode::HTTP_429_TOO_MANY_REQUESTS);
+    return;
+  }
+
+  auto permit{shard.admission->tryAcquire()};
 
-    if (!handleResult.has_value()) {
-      std::println("Handling error, message: {}, status code: {}",
-                   handleResult.error().message.value_or("null"),
-                   static_cast<int>(handleResult.error().statusCode));
+  if (!permit.has_value()) {
+    _rejectClient(std::move(clientSocket),
+                  StatusCode::HTTP_503_SERVICE_UNAVAILABLE);
+    return;
+  }
+
+  clientSocket->setTimeouts(_socketTimeouts());
+  clientSocket->setRequestLimits(_requestLimits());
 
-      const auto response{HttpResponse::fromError(handleResult.error())};
-      clientSocket->send(response.serialize());
-      break;
+  // The permit covers the whole connection and is released when the task
+  // is destroyed.
+  auto work{[client = std::move(clientSocket), permit = std::move(*permit),
+             this]() mutable {
+    permit.start();
+
+    try {
+      _serveClient(std::move(client));
+    } catch (const std::exception&) {
+      // Malformed request or broken connection: the client is dropped.
     }
+  }};
 
-    switch (handleResult.value()) {
-      case ConnType::CLOSE:
-        return;  // close connection
-      default:
-        break;
+  static_assert(core::Task::storesInline<decltype(work)>());
+  shard.threadPool->submit(std::move(work));
+}
+
+void HttpServer::_runReactorLoop(Shard& shard) {
+#ifdef __linux__
+  std::vector<IListener*> listeners;
+  std::ranges::transform(
+      shard.listeners, std::back_inserter(listeners),
+      [](const Listener& listener) { return listener.socket.get(); });
+
+  EpollReactor reactor{
+      std::move(listeners), *shard.threadPool, *shard.admission,
+      _socketTimeouts(), _requestLimits(),
+      [this](AsyncSocket& clientSocket) { return _serveRequest(clientSocket); },
+      [this, &shard](std::unique_ptr<ISocket> clientSocket) {
+        _recordAccepted(shard, *clientSocket);
+
+        if (!_allowConnection(*clientSocket)) {
+          _rejectClient(std::move(clientSocket),
+                        StatusCode::HTTP_429_TOO_MANY_REQUESTS);
+        }
+
+        return clientSocket;
+      },
+      _classifier.empty() ? ClassifyCallback{}
+                          : [this](const std::string_view request) {
+                              return _classifier.classify(request);
+                            }};
+  reactor.run();
+
+  if (_handedOff.load()) {
+    reactor.drain(_config.drainTimeout);
+  }
+
+  shard.threadPool->stop();  // in-flight requests still report to the reactor
+#else
+  std::println("Reactor mode requires epoll, falling back to threads");
+  _runThreadedLoop(shard);
+#endif
+}
+
+void HttpServer::_recordAccepted(const Shard& shard,
+                                 const ISocket& clientSocket) {
+  _stats.acceptedConnections.fetch_add(1, std::memory_order_relaxed);
+
+  const auto cpu{clientSocket.incomingCpu()};
+
+  if (!cpu.has_value()) {
+    return;
+  }
+
+  const auto cpuId{static_cast<std::size_t>(cpu.value())};
+  const auto owner{cpuId < _cpuOwners.size() ? _cpuOwners.at(cpuId)
+                                             : cpuId % _shards.size()};
+  auto& counter{owner == shard.index ? _stats.localityHits
+                                     : _stats.localityMisses};
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool HttpServer::_allowConnection(const ISocket& clientSocket) {
+  const auto peer{clientSocket.peerAddress()};
+  return !peer.has_value() || _connectionLimiter.tryAcquire(*peer);
+}
+
+bool HttpServer::_allowRequest(const ISocket& clientSocket) {
+  const auto peer{clientSocket.peerAddress()};
+  return !peer.has_value() || _requestLimiter.tryAcquire(*peer);
+}
+
+SocketTimeouts HttpServer::_socketTimeouts() const {
+  return {.idle = _config.keepAliveTimeout,
+          .request = _config.requestTimeout,
+          .send = _config.sendTimeout};
+}
+
+RequestLimits HttpServer::_requestLimits() const {
+  return {.maxRequestLineSize = _config.maxRequestLineSize,
+          .maxHeaderLineSize = _config.maxHeaderLineSize,
+          .maxHeadersSize = _config.maxHeadersSize,
+          .maxHeaderCount = _config.maxHeaderCount,
+          .maxBodySize = _config.maxBodySize};
+}
+
+void HttpServer::_rejectClient(std::unique_ptr<ISocket> clientSocket,
+                               const StatusCode statusCode) {
+  // Overloaded or over its rate: answer right away so the client can back
+  // off or retry elsewhere. The acceptor never waits for the client; the
+  // request is read and dropped in the background.
+  //
+  // Over TLS the answer would first need a handshake, which must not stall
+  // the acceptor; those clients are only disconnected. Only TCP listeners
+  // use TLS, and only their peers have an IP address.
+  if (_tlsContext != nullptr && clientSocket->peerAddress().has_value()) {
+    return;
+  }
+
+  _rejectedClients.close(std::move(clientSocket),
+                         HttpResponse::prebuilt(statusCode));
+}
+
+void HttpServer::_serveClient(std::unique_ptr<ISocket> clientSocket) {
+  // The worker owns the connection and its socket blocks, so the handler's
+  // coroutines run to completion on this thread.
+  AsyncSocket socket{*clientSocket};
+  auto connType{ConnType::KEEP_ALIVE};
+
+  while (connType == ConnType::KEEP_ALIVE) {
+    connType = core::syncWait(_serveRequest(socket));
+
+    if (_handedOff.load()) {
+      break;  // the successor serves whatever the client sends next
     }
   }
 }
 
+core::AsyncTask<ConnType> HttpServer::_serveRequest(AsyncSocket& clientSocket) {
+  auto rejection{StatusCode::HTTP_429_TOO_MANY_REQUESTS};
+
+  try {
+    if (!_allowRequest(clientSocket.socket())) {
+      // Read the request anyway: closing with it still unread would reset
+      // the connection under the 429.
+      static_cast<void>(co_await clientSocket.receive());
+      throw RequestRejected{StatusCode::HTTP_429_TOO_MANY_REQUESTS,
+                            "rate limit exceeded"};
+    }
+
+    co_return co_await _handleRequest(clientSocket);
+  } catch (const RequestRejected& rejected) {
+    rejection = rejected.statusCode();
+  }
+
+  // Oversized, late or rate-limited requests come from broken or abusive
+  // clients; they get a canned response and lose the connection.
+  const std::array<std::string_view, 1> parts{
+      HttpResponse::prebuilt(rejection)};
+  co_await clientSocket.sendVectored(parts);
+  co_return ConnType::CLOSE;
+}
+
+core::AsyncTask<ConnType> HttpServer::_handleRequest(
+    AsyncSocket& clientSocket) const {
+  const auto handleResult{co_await _handler.handle(clientSocket)};
+
+  if (!handleResult.has_value()) {
+    std::println("Handling error, message: {}, status code: {}",
+                 handleResult.error().message.value_or("null"),
+                 static_cast<int>(handleResult.error().statusCode));
+
+    const auto response{HttpResponse::fromError(handleResult.error())};
+    const auto head{response.serializeHead()};
+    const std::array<std::string_view, 2> parts{
+        head, response.body.has_value() ? std::string_view{*response.body}
+                                        : std::string_view{}};
+    co_await clientSocket.sendVectored(parts);
+    co_return ConnType::CLOSE;
+  }
+
+  co_return handleResult.value();
+}
+
 }  // namespace webserver::net
@@ -1,11 +1,27 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <vector>
 
+#include "AdmissionController.h"
+#include "AsyncSocket.h"
+#include "AsyncTask.h"
 #include "Config.h"
 #include "Handler.h"
+#include "LingeringCloser.h"
+#include "ListenerHandoff.h"
+#include "RateLimiter.h"
+#include "RequestClassifier.h"
+#include "ServerStats.h"
 #include "Socket.h"
 #include "ThreadPool.h"
+#include "TlsContext.h"
 
 inline std::atomic<bool> shutdownRequested{false};
 
@@ -26,13 +42,84 @@ class HttpServer {
   void startServerLoop();
 
  private:
-  void _serveClient(std::unique_ptr<ISocket> clientSocket) const;
+  // One accept loop with its own listening socket and worker pool. With
+  // several shards every listener binds the port with SO_REUSEPORT and the
+  // kernel spreads incoming connections across them. A shard's threads are
+  // pinned to its CPUs: with NUMA placement the CPUs of one node, shards on
+  // the same node splitting it under CPU locality, otherwise the configured
+  // worker CPUs, split between the shards under CPU locality.
+  // Work reaches the pool only through the shard's admission controller.
+  // The first shard listens on every endpoint, the others only on the TCP
+  // ones: a Unix socket path cannot be shared through SO_REUSEPORT.
+  struct Listener {
+    Endpoint endpoint;
+    std::unique_ptr<IListener> socket;
+  };
+
+  struct Shard {
+    std::size_t index;
+    std::vector<int> cpus;
+    std::vector<Listener> listeners;
+    std::unique_ptr<core::ThreadPool> threadPool;
+    std::unique_ptr<core::AdmissionController> admission;
+  };
+
+  [[nodiscard]] std::vector<Endpoint> _parseEndpoints() const;
+  void _createShards();
+  [[nodiscard]] std::vector<std::vector<int>> _placeShards(
+      std::size_t shardsCount);
+  [[nodiscard]] std::unique_ptr<IListener> _openListener(
+      std::size_t shardIndex, const Endpoint &endpoint, bool reusePort);
+  [[nodiscard]] static std::string _listenerKey(std::size_t shardIndex,
+                                                const Endpoint &endpoint);
+  void _serveHandoff(const std::stop_token &stopToken);
+  void _enableCpuSteering();
+  void _runShard(Shard &shard);
+  void _runThreadedLoop(Shard &shard);
+  void _acceptLoop(Shard &shard, IListener &listener);
+  void _dispatchClient(Shard &shard, std::unique_ptr<ISocket> clientSocket);
+  void _runReactorLoop(Shard &shard);
+  void _recordAccepted(const Shard &shard, const ISocket &clientSocket);
+  [[nodiscard]] bool _allowConnection(const ISocket &clientSocket);
+  [[nodiscard]] bool _allowRequest(const ISocket &clientSocket);
+  void _recordFailure();
+  void _reportStats(const std::stop_token &stopToken) const;
+  [[nodiscard]] std::string _formatStats() const;
+  [[nodiscard]] SocketTimeouts _socketTimeouts() const;
+  [[nodiscard]] http::RequestLimits _requestLimits() const;
+  void _rejectClient(std::unique_ptr<ISocket> clientSocket,
+                     http::StatusCode statusCode);
+  void _serveClient(std::unique_ptr<ISocket> clientSocket);
+  [[nodiscard]] core::AsyncTask<ConnType> _serveRequest(
+      AsyncSocket &clientSocket);
+  [[nodiscard]] core::AsyncTask<ConnType> _handleRequest(
+      AsyncSocket &clientSocket) const;
   void _throwIfPortIsInvalid() const;
 
   const config::Config _config;
-  core::ThreadPool _threadPool;
-  std::unique_ptr<ISocket> _serverSocket;
+  const std::vector<Endpoint> _endpoints;
+  std::vector<Shard> _shards;
   const IHandler &_handler;
+  core::ServerStats _stats;
+  // Shared by all shards: a client's budget is per process, whichever
+  // listener its connections land on.
+  core::RateLimiter _connectionLimiter;
+  core::RateLimiter _requestLimiter;
+  core::RequestClassifier _classifier;  // reactor mode only
+  LingeringCloser _rejectedClients;
+  std::shared_ptr<TlsContext> _tlsContext;  // null without TLS
+  // Shard owning each CPU id under CPU locality, for steering and stats.
+  std::vector<std::size_t> _cpuOwners;
+
+  // Upgrades: listeners received from the previous instance, taken out as
+  // the shards adopt them. _handedOff is set once a successor took over
+  // ours; the server then drains and exits.
+  std::unique_ptr<ListenerHandoff> _handoff;  // null without [handoff]
+  ListenerHandoff::Listeners _inheritedListeners;
+  std::atomic<bool> _handedOff{false};
+
+  std::mutex _failureMutex;
+  std::exception_ptr _firstFailure;
 };
 
 }  // namespace webserver::net
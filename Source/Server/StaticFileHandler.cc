@@ -4,23 +4,30 @@
 #include "HttpBase.h"
 #include "HttpParser.h"
 #include "IniParser.h"
-#include "Socket.h"
 
 namespace webserver::http {
 
-StaticFileHandler::StaticFileHandler(std::string contentDirectory)
-    : _contentDirectory{std::move(contentDirectory)} {
+StaticFileHandler::StaticFileHandler(std::string contentDirectory,
+                                     core::AccessControl accessControl)
+    : _contentDirectory{std::move(contentDirectory)},
+      _accessControl{std::move(accessControl)} {
 }
 
-[[nodiscard]] net::HandlingResult StaticFileHandler::handle(
-    net::ISocket& clientSocket) const {
-  const auto requestRaw{clientSocket.receive()};
+core::AsyncTask<net::HandlingResult> StaticFileHandler::handle(
+    net::AsyncSocket& clientSocket) const {
+  const auto requestRaw{co_await clientSocket.receive()};
   const auto request{HttpParser{requestRaw}.parse()};
 
+  if (!_accessControl.isAllowed(request.uri, clientSocket.peerAddress())) {
+    co_return std::unexpected<HttpError>{
+        {.statusCode = StatusCode::HTTP_403_FORBIDDEN,
+         .message = "Client address not allowed for this path"}};
+  }
+
   net::ConnType connType = net::ConnType::CLOSE;
 
-  if (request.headers.contains("Connection")) {
-    connType = request.headers.at("Connection") == "close"
+  if (request.headers.contains("connection")) {
+    connType = request.headers.at("connection") == "close"
                    ? net::ConnType::CLOSE
                    : net::ConnType::KEEP_ALIVE;
   } else if (request.httpVersion >= HttpVersion::HTTP_1_1) {
@@ -33,7 +40,7 @@ StaticFileHandler::StaticFileHandler(std::string contentDirectory)
   const auto validationResult = _validateUri(fullPath);
 
   if (!validationResult.has_value()) {
-    return std::unexpected<HttpError>(validationResult.error());
+    co_return std::unexpected<HttpError>(validationResult.error());
   }
 
   const auto response = HttpResponse{
@@ -44,10 +51,10 @@ StaticFileHandler::StaticFileHandler(std::string contentDirectory)
                   {"Connection",
                    connType == net::ConnType::CLOSE ? "close" : "keep-alive"}}};
 
-  clientSocket.send(response.serialize());
-  clientSocket.sendZeroCopyFile(fullPath);
+  const auto head{response.serializeHead()};
+  co_await clientSocket.sendFileWithHead(head, fullPath);
 
-  return connType;
+  co_return connType;
 }
 
 std::expected<void, HttpError> StaticFileHandler::_validateUri(
@@ -3,18 +3,22 @@
 #include <expected>
 #include <filesystem>
 
+#include "AccessControl.h"
+#include "AsyncSocket.h"
+#include "AsyncTask.h"
 #include "Handler.h"
 #include "HttpResponse.h"
-#include "Socket.h"
 
 namespace webserver::http {
 
 class StaticFileHandler : public net::IHandler {
  public:
-  explicit StaticFileHandler(std::string contentDirectory);
+  explicit StaticFileHandler(std::string contentDirectory,
+                             core::AccessControl accessControl =
+                                 core::AccessControl{{}});
 
-  [[nodiscard]] net::HandlingResult handle(
-      net::ISocket &clientSocket) const override;
+  [[nodiscard]] core::AsyncTask<net::HandlingResult> handle(
+      net::AsyncSocket &clientSocket) const override;
 
  private:
   [[nodiscard]] static std::expected<void, HttpError> _validateUri(
@@ -26,6 +30,7 @@ class StaticFileHandler : public net::IHandler {
       const std::filesystem::path &fileName);
 
   std::string _contentDirectory;
+  core::AccessControl _accessControl;
 };
 
 }  // namespace webserver::http
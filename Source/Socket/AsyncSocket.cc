@@ -0,0 +1,47 @@
+#include "AsyncSocket.h"
+
+#include <stdexcept>
+
+namespace webserver::net {
+
+AsyncSocket::AsyncSocket(ISocket &socket, IAsyncIo *io) noexcept
+    : _socket{socket}, _io{io} {
+}
+
+bool AsyncSocket::ReceiveAwaiter::await_ready() const {
+  return !_socket._mustWait(IoWait::REQUEST);
+}
+
+void AsyncSocket::ReceiveAwaiter::await_suspend(
+    const std::coroutine_handle<> handle) const {
+  _socket._io->suspend(IoWait::REQUEST, handle);
+}
+
+std::string AsyncSocket::ReceiveAwaiter::await_resume() const {
+  _socket._throwIfBroken();
+  return _socket._socket.receive();
+}
+
+AsyncSocket::ReceiveAwaiter AsyncSocket::receive() noexcept {
+  return ReceiveAwaiter{*this};
+}
+
+std::optional<IpAddress> AsyncSocket::peerAddress() const noexcept {
+  return _socket.peerAddress();
+}
+
+ISocket &AsyncSocket::socket() const noexcept {
+  return _socket;
+}
+
+bool AsyncSocket::_mustWait(const IoWait wait) const {
+  return _io != nullptr && _io->mustWait(wait);
+}
+
+void AsyncSocket::_throwIfBroken() const {
+  if (_io != nullptr && _io->broken()) {
+    throw std::runtime_error("Connection lost while suspended");
+  }
+}
+
+}  // namespace webserver::net
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "IpAddress.h"
+#include "Socket.h"
+
+namespace webserver::net {
+
+// What a coroutine on an AsyncSocket can be waiting for: a complete request
+// in the connection's input, or its queued output to be written out.
+enum class IoWait : std::uint8_t { REQUEST, FLUSH };
+
+// Suspension points of an AsyncSocket, provided by the event loop that owns
+// the connection. suspend() parks the coroutine until the wait is satisfied
+// and resumes it later, normally on a pool worker; no thread is tied up in
+// between.
+class IAsyncIo {
+ public:
+  IAsyncIo() = default;
+  IAsyncIo(const IAsyncIo &) = delete;
+  IAsyncIo(IAsyncIo &&) = delete;
+  IAsyncIo &operator=(const IAsyncIo &) = delete;
+  IAsyncIo &operator=(IAsyncIo &&) = delete;
+  virtual ~IAsyncIo() = default;
+
+  // False if the coroutine can go on without suspending.
+  [[nodiscard]] virtual bool mustWait(IoWait wait) = 0;
+  // Called from await_suspend(); `handle` may be resumed on another thread
+  // before this returns.
+  virtual void suspend(IoWait wait, std::coroutine_handle<> handle) = 0;
+  // True once the connection failed or timed out while a coroutine was
+  // parked on it.
+  [[nodiscard]] virtual bool broken() const noexcept = 0;
+};
+
+// Awaitable client socket for coroutine handlers. Every operation is issued
+// on the underlying ISocket when it is co_awaited. Under an event loop (with
+// an IAsyncIo) they never block: receive() suspends until a whole request
+// has been buffered, sends queue their data and suspend only while too much
+// output is waiting for the client. Without an IAsyncIo, i.e. on a thread
+// dedicated to the connection, they are the blocking ISocket calls and never
+// suspend.
+class AsyncSocket {
+ public:
+  explicit AsyncSocket(ISocket &socket, IAsyncIo *io = nullptr) noexcept;
+
+  AsyncSocket(const AsyncSocket &) = delete;
+  AsyncSocket(AsyncSocket &&) = delete;
+  AsyncSocket &operator=(const AsyncSocket &) = delete;
+  AsyncSocket &operator=(AsyncSocket &&) = delete;
+  ~AsyncSocket() = default;
+
+  class ReceiveAwaiter {
+   public:
+    explicit ReceiveAwaiter(AsyncSocket &socket) noexcept : _socket{socket} {
+    }
+
+    [[nodiscard]] bool await_ready() const;
+    void await_suspend(std::coroutine_handle<> handle) const;
+    [[nodiscard]] std::string await_resume() const;
+
+   private:
+    AsyncSocket &_socket;
+  };
+
+  template <class Send>
+  class SendAwaiter {
+   public:
+    SendAwaiter(AsyncSocket &socket, Send send) noexcept
+        : _socket{socket}, _send{std::move(send)} {
+    }
+
+    [[nodiscard]] bool await_ready() {
+      _send(_socket._socket);
+      return !_socket._mustWait(IoWait::FLUSH);
+    }
+    void await_suspend(const std::coroutine_handle<> handle) const {
+      _socket._io->suspend(IoWait::FLUSH, handle);
+    }
+    void await_resume() const {
+      _socket._throwIfBroken();
+    }
+
+   private:
+    AsyncSocket &_socket;
+    Send _send;
+  };
+
+  // co_await yields the next request, see ISocket::receive().
+  [[nodiscard]] ReceiveAwaiter receive() noexcept;
+
+  // The data must stay valid until the co_await completes.
+  [[nodiscard]] auto send(const std::string_view data) noexcept {
+    return _makeSend(
+        [data](ISocket &socket) { socket.send(std::string{data}); });
+  }
+  [[nodiscard]] auto sendVectored(
+      const std::span<const std::string_view> parts) noexcept {
+    return _makeSend(
+        [parts](ISocket &socket) { socket.sendVectored(parts); });
+  }
+  [[nodiscard]] auto sendFile(std::filesystem::path filePath) noexcept {
+    return _makeSend([filePath = std::move(filePath)](ISocket &socket) {
+      socket.sendZeroCopyFile(filePath);
+    });
+  }
+  [[nodiscard]] auto sendFileWithHead(const std::string_view head,
+                                      std::filesystem::path filePath) noexcept {
+    return _makeSend(
+        [head, filePath = std::move(filePath)](ISocket &socket) {
+          socket.sendFileWithHead(head, filePath);
+        });
+  }
+
+  [[nodiscard]] std::optional<IpAddress> peerAddress() const noexcept;
+  [[nodiscard]] ISocket &socket() const noexcept;
+
+ private:
+  template <class Send>
+  [[nodiscard]] SendAwaiter<Send> _makeSend(Send send) noexcept {
+    return SendAwaiter<Send>{*this, std::move(send)};
+  }
+
+  [[nodiscard]] bool _mustWait(IoWait wait) const;
+  void _throwIfBroken() const;
+
+  ISocket &_socket;
+  IAsyncIo *_io;
+};
+
+}  // namespace webserver::net
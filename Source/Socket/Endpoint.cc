@@ -0,0 +1,100 @@
+#include "Endpoint.h"
+
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+namespace webserver::net {
+
+constexpr std::string_view kUnixScheme{"unix:"};
+
+Endpoint Endpoint::anyAddress(const std::uint16_t port) {
+  return {.kind = Kind::TCP, .address = IpAddress{}, .port = port, .path = {}};
+}
+
+Endpoint Endpoint::parse(const std::string_view text) {
+  const auto fail{[text]() {
+    return std::invalid_argument("Invalid listen address: " +
+                                 std::string{text});
+  }};
+
+  if (text.starts_with(kUnixScheme)) {
+    const auto path{text.substr(kUnixScheme.size())};
+
+    if (path.empty()) {
+      throw fail();
+    }
+
+    return {.kind = Kind::UNIX,
+            .address = {},
+            .port = 0,
+            .path = std::string{path}};
+  }
+
+  std::string_view host;
+  std::string_view portText{text};
+
+  if (text.starts_with('[')) {
+    const auto closing{text.find("]:")};
+
+    if (closing == std::string_view::npos) {
+      throw fail();
+    }
+
+    host = text.substr(1, closing - 1);
+    portText = text.substr(closing + 2);
+  } else if (const auto colon{text.rfind(':')};
+             colon != std::string_view::npos) {
+    host = text.substr(0, colon);
+    portText = text.substr(colon + 1);
+
+    // IPv6 hosts must be bracketed, "::1:80" is ambiguous.
+    if (host.contains(':')) {
+      throw fail();
+    }
+  }
+
+  unsigned port{0};
+  const auto [end, error]{std::from_chars(
+      portText.data(), portText.data() + portText.size(), port)};
+
+  if (portText.empty() || error != std::errc{} ||
+      end != portText.data() + portText.size() || port == 0 ||
+      port > std::numeric_limits<std::uint16_t>::max()) {
+    throw fail();
+  }
+
+  auto endpoint{anyAddress(static_cast<std::uint16_t>(port))};
+
+  if (!host.empty() && host != "*") {
+    const auto address{IpAddress::parse(host)};
+
+    if (!address.has_value()) {
+      throw fail();
+    }
+
+    endpoint.address = *address;
+  }
+
+  return endpoint;
+}
+
+bool Endpoint::isUnix() const noexcept {
+  return kind == Kind::UNIX;
+}
+
+std::string Endpoint::toString() const {
+  if (isUnix()) {
+    return std::string{kUnixScheme} + path;
+  }
+
+  const auto portText{std::to_string(port)};
+
+  if (address.isV4()) {
+    return address.toString() + ":" + portText;
+  }
+
+  return "[" + address.toString() + "]:" + portText;
+}
+
+}  // namespace webserver::net
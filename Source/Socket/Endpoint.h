@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "IpAddress.h"
+
+namespace webserver::net {
+
+// Local address a listener binds to, as written in `server.listen`:
+//   8000, *:8000        every address, IPv6 and IPv4 (dual-stack)
+//   [::]:8000           same as above
+//   0.0.0.0:8000        every IPv4 address only
+//   127.0.0.1:8000      one IPv4 address
+//   [::1]:8000          one IPv6 address
+//   unix:/run/ws.sock   Unix domain stream socket
+struct Endpoint {
+  enum class Kind : std::uint8_t { TCP, UNIX };
+
+  Kind kind{Kind::TCP};
+  IpAddress address;  // TCP only; the unspecified :: means dual-stack
+  std::uint16_t port{0};  // TCP only
+  std::string path;       // UNIX only
+
+  [[nodiscard]] static Endpoint anyAddress(std::uint16_t port);
+  // Throws std::invalid_argument for malformed entries.
+  [[nodiscard]] static Endpoint parse(std::string_view text);
+
+  [[nodiscard]] bool isUnix() const noexcept;
+  [[nodiscard]] std::string toString() const;
+};
+
+}  // namespace webserver::net
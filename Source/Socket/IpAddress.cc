@@ -0,0 +1,109 @@
+#include "IpAddress.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace webserver::net {
+
+constexpr auto kV4Offset = 12;  // IPv4 bytes follow the ::ffff: prefix
+constexpr std::array<std::uint8_t, kV4Offset> kV4MappedPrefix{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+
+IpAddress::IpAddress(const Bytes &bytes) noexcept : _bytes{bytes} {
+}
+
+IpAddress IpAddress::fromV4(const std::uint32_t hostOrderAddress) noexcept {
+  Bytes bytes{};
+  std::ranges::copy(kV4MappedPrefix, bytes.begin());
+
+  for (std::size_t i = 0; i < 4; ++i) {
+    bytes.at(kV4Offset + i) =
+        static_cast<std::uint8_t>(hostOrderAddress >> (8 * (3 - i)));
+  }
+
+  return IpAddress{bytes};
+}
+
+std::optional<IpAddress> IpAddress::fromSockaddr(
+    const sockaddr *address) noexcept {
+  if (address == nullptr) {
+    return std::nullopt;
+  }
+
+  if (address->sa_family == AF_INET) {
+    sockaddr_in v4{};
+    std::memcpy(&v4, address, sizeof(v4));
+    return fromV4(ntohl(v4.sin_addr.s_addr));
+  }
+
+  if (address->sa_family == AF_INET6) {
+    sockaddr_in6 v6{};
+    std::memcpy(&v6, address, sizeof(v6));
+    Bytes bytes{};
+    std::memcpy(bytes.data(), &v6.sin6_addr, kSize);
+    return IpAddress{bytes};
+  }
+
+  return std::nullopt;
+}
+
+std::optional<IpAddress> IpAddress::parse(const std::string_view text) {
+  const std::string terminated{text};
+  in_addr v4{};
+
+  if (::inet_pton(AF_INET, terminated.c_str(), &v4) == 1) {
+    return fromV4(ntohl(v4.s_addr));
+  }
+
+  Bytes bytes{};
+
+  if (::inet_pton(AF_INET6, terminated.c_str(), bytes.data()) == 1) {
+    return IpAddress{bytes};
+  }
+
+  return std::nullopt;
+}
+
+bool IpAddress::isV4() const noexcept {
+  return std::equal(kV4MappedPrefix.begin(), kV4MappedPrefix.end(),
+                    _bytes.begin());
+}
+
+const IpAddress::Bytes &IpAddress::bytes() const noexcept {
+  return _bytes;
+}
+
+std::string IpAddress::toString() const {
+  std::array<char, INET6_ADDRSTRLEN> buffer{};
+
+  if (isV4()) {
+    ::inet_ntop(AF_INET, &_bytes.at(kV4Offset), buffer.data(), buffer.size());
+  } else {
+    ::inet_ntop(AF_INET6, _bytes.data(), buffer.data(), buffer.size());
+  }
+
+  return buffer.data();
+}
+
+std::size_t IpAddressHash::operator()(
+    const IpAddress &address) const noexcept {
+  // Two 64-bit halves through a multiplicative mix; good enough spread for
+  // both hash buckets and the high bits used to pick a shard.
+  constexpr std::uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+  constexpr auto kShift = 32;
+
+  std::uint64_t high{};
+  std::uint64_t low{};
+  std::memcpy(&high, address.bytes().data(), sizeof(high));
+  std::memcpy(&low, address.bytes().data() + sizeof(high), sizeof(low));
+
+  auto hash{(high * kMultiplier) ^ low};
+  hash *= kMultiplier;
+  return static_cast<std::size_t>(hash ^ (hash >> kShift));
+}
+
+}  // namespace webserver::net
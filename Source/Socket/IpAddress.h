@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+struct sockaddr;
+
+namespace webserver::net {
+
+// IPv4 or IPv6 address of a peer. IPv4 addresses are kept in their
+// IPv4-mapped IPv6 form (::ffff:a.b.c.d), so both families share one
+// 16-byte representation that can be hashed and compared directly.
+class IpAddress {
+ public:
+  static constexpr std::size_t kSize = 16;
+  using Bytes = std::array<std::uint8_t, kSize>;
+
+  IpAddress() = default;  // the unspecified address ::
+  explicit IpAddress(const Bytes &bytes) noexcept;
+
+  [[nodiscard]] static IpAddress fromV4(
+      std::uint32_t hostOrderAddress) noexcept;
+  // std::nullopt for families other than AF_INET/AF_INET6.
+  [[nodiscard]] static std::optional<IpAddress> fromSockaddr(
+      const sockaddr *address) noexcept;
+  // Dotted IPv4 or textual IPv6 notation.
+  [[nodiscard]] static std::optional<IpAddress> parse(std::string_view text);
+
+  [[nodiscard]] bool isV4() const noexcept;
+  [[nodiscard]] const Bytes &bytes() const noexcept;
+  [[nodiscard]] std::string toString() const;
+
+  bool operator==(const IpAddress &) const = default;
+  auto operator<=>(const IpAddress &) const = default;
+
+ private:
+  Bytes _bytes{};
+};
+
+struct IpAddressHash {
+  [[nodiscard]] std::size_t operator()(
+      const IpAddress &address) const noexcept;
+};
+
+}  // namespace webserver::net
@@ -0,0 +1,126 @@
+#include "LingeringCloser.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <array>
+#include <exception>
+#include <utility>
+
+namespace webserver::net {
+
+// Deadline resolution, and how late a connection added during a wait is
+// first read.
+constexpr auto kPollIntervalMs = 100;
+
+LingeringCloser::LingeringCloser(const Options &options)
+    : _options{options},
+      _thread{[this](const std::stop_token &stopToken) { _run(stopToken); }} {
+}
+
+void LingeringCloser::close(std::unique_ptr<ISocket> socket,
+                            const std::string_view response) {
+  try {
+    socket->setNonBlocking();
+
+    if (socket->sendSome(response, false) != response.size()) {
+      return;
+    }
+
+    // The client sees the end of the response, and a well-behaved one
+    // closes its side once it has read it.
+    ::shutdown(socket->nativeHandle(), SHUT_WR);
+  } catch (const std::exception &) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    if (_sockets.size() >= _options.maxSockets) {
+      return;
+    }
+
+    _sockets.push_back(
+        {.socket = std::move(socket),
+         .closeAt = std::chrono::steady_clock::now() + _options.timeout});
+  }
+
+  _added.notify_one();
+}
+
+std::size_t LingeringCloser::size() const {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _sockets.size();
+}
+
+void LingeringCloser::_run(const std::stop_token &stopToken) {
+  std::vector<pollfd> pollFds;
+
+  while (!stopToken.stop_requested()) {
+    {
+      std::unique_lock<std::mutex> lock{_mutex};
+
+      if (!_added.wait(lock, stopToken,
+                       [this] { return !_sockets.empty(); })) {
+        return;
+      }
+
+      pollFds.clear();
+
+      for (const auto &lingering : _sockets) {
+        pollFds.push_back({.fd = lingering.socket->nativeHandle(),
+                           .events = POLLIN,
+                           .revents = 0});
+      }
+    }
+
+    // A failed poll reports nothing ready; the deadlines still apply.
+    static_cast<void>(::poll(pollFds.data(), pollFds.size(), kPollIntervalMs));
+
+    const auto now{std::chrono::steady_clock::now()};
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    // Connections added meanwhile follow the polled ones.
+    for (std::size_t i = 0; i < pollFds.size(); ++i) {
+      auto &lingering{_sockets.at(i)};
+
+      if (pollFds.at(i).revents != 0 && !_discardInput(lingering)) {
+        lingering.socket.reset();
+      }
+    }
+
+    std::erase_if(_sockets, [now](const Lingering &lingering) {
+      return lingering.socket == nullptr || lingering.closeAt <= now;
+    });
+  }
+}
+
+bool LingeringCloser::_discardInput(Lingering &lingering) const {
+  std::array<char, 4096> discarded{};  // NOLINT
+
+  try {
+    // A zero-copy send of the response reports its completion as POLLERR,
+    // which stays raised until it is taken.
+    static_cast<void>(lingering.socket->reapZeroCopyCompletions());
+
+    while (lingering.bytesRead < _options.maxBytes) {
+      const auto bytesReceived{lingering.socket->receiveSome(discarded)};
+
+      if (!bytesReceived.has_value()) {
+        return true;
+      }
+      if (bytesReceived.value() == 0) {
+        return false;  // the client closed its side
+      }
+
+      lingering.bytesRead += bytesReceived.value();
+    }
+  } catch (const std::exception &) {
+    // Reset by the client.
+  }
+
+  return false;
+}
+
+}  // namespace webserver::net
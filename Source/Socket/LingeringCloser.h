@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Socket.h"
+
+namespace webserver::net {
+
+// Closes connections that are answered without their request being read,
+// e.g. clients turned away right after accept. Closing a socket with unread
+// input resets the connection, which can destroy the answer before the
+// client has read it. Here the answer is sent without blocking and the write
+// side shut down; a thread of its own then reads and discards whatever the
+// client still sends, until it closes, `timeout` passes or `maxBytes` have
+// arrived, and only then closes the socket. Callers never wait: if the
+// answer does not fit the socket buffer, or `maxSockets` connections are
+// lingering already, the connection is closed right away as before.
+class LingeringCloser {
+ public:
+  struct Options {
+    std::chrono::milliseconds timeout{std::chrono::seconds{2}};
+    std::size_t maxBytes{64 * 1024};
+    std::size_t maxSockets{1024};
+  };
+
+  explicit LingeringCloser(const Options &options);
+  LingeringCloser(const LingeringCloser &) = delete;
+  LingeringCloser(LingeringCloser &&) = delete;
+  LingeringCloser &operator=(const LingeringCloser &) = delete;
+  LingeringCloser &operator=(LingeringCloser &&) = delete;
+  ~LingeringCloser() = default;
+
+  // Sends `response` and takes the socket over. Thread-safe.
+  void close(std::unique_ptr<ISocket> socket, std::string_view response);
+  // Connections still lingering.
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  struct Lingering {
+    std::unique_ptr<ISocket> socket;
+    std::chrono::steady_clock::time_point closeAt{};
+    std::size_t bytesRead{0};
+  };
+
+  void _run(const std::stop_token &stopToken);
+  // Reads what has arrived; false once the connection can be closed.
+  [[nodiscard]] bool _discardInput(Lingering &lingering) const;
+
+  const Options _options;
+  mutable std::mutex _mutex;
+  std::condition_variable_any _added;
+  std::vector<Lingering> _sockets;
+  std::jthread _thread;  // last: stops before the sockets go
+};
+
+}  // namespace webserver::net
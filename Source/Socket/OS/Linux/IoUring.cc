@@ -0,0 +1,455 @@
+#include "IoUring.h"
+
+#ifdef __linux__
+  #include <fcntl.h>
+  #include <linux/time_types.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+
+  #include <algorithm>
+  #include <array>
+  #include <atomic>
+  #include <cerrno>
+  #include <cstring>
+  #include <stdexcept>
+  #include <system_error>
+
+namespace webserver::net {
+
+constexpr unsigned kRingEntries = 256;
+constexpr unsigned kFixedFileSlots = 1024;
+constexpr unsigned kProvidedBufferCount = 64;  // must be a power of two
+constexpr unsigned kProvidedBufferSize = 8192;
+
+namespace {
+
+int ioUringSetup(const unsigned entries, io_uring_params &params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int ioUringEnter(const int ringFd, const unsigned toSubmit,
+                 const unsigned minComplete, const unsigned flags,
+                 const void *arg, const std::size_t argSize) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, toSubmit,
+                                    minComplete, flags, arg, argSize));
+}
+
+int ioUringRegister(const int ringFd, const unsigned opcode, const void *arg,
+                    const unsigned argCount) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, ringFd, opcode, arg, argCount));
+}
+
+unsigned loadAcquire(unsigned *value) {
+  return std::atomic_ref<unsigned>{*value}.load(std::memory_order_acquire);
+}
+
+void storeRelease(unsigned *value, const unsigned newValue) {
+  std::atomic_ref<unsigned>{*value}.store(newValue, std::memory_order_release);
+}
+
+bool isOpcodeSupported(const io_uring_probe &probe, const unsigned opcode) {
+  return opcode <= probe.last_op &&
+         (probe.ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;  // NOLINT
+}
+
+}  // namespace
+
+IoUring::IoUring() {
+  _ringFd = ioUringSetup(kRingEntries, _params);
+
+  if (_ringFd < 0) {
+    throw std::runtime_error("io_uring_setup() failed");
+  }
+
+  try {
+    _mapRings();
+    _registerFileTable();
+    _setupBufferRing();
+    _createSplicePipe();
+  } catch (...) {
+    _unmapRings();
+    ::close(_ringFd);
+    throw;
+  }
+}
+
+IoUring::~IoUring() {
+  ::close(_ringFd);  // releases the fixed files and the buffer ring
+  _unmapRings();
+
+  for (const int pipeFd : _pipeFds) {
+    if (pipeFd >= 0) {
+      ::close(pipeFd);
+    }
+  }
+}
+
+bool IoUring::isSupported() noexcept {
+  static const bool kSupported = [] {
+    try {
+      const IoUring ring;
+
+      if ((ring._params.features & IORING_FEAT_EXT_ARG) == 0) {
+        return false;
+      }
+
+      constexpr auto kProbeOps = 256;
+      std::vector<char> probeStorage(
+          sizeof(io_uring_probe) + (kProbeOps * sizeof(io_uring_probe_op)));
+      auto *probe = reinterpret_cast<io_uring_probe *>(  // NOLINT
+          probeStorage.data());
+
+      if (ioUringRegister(ring._ringFd, IORING_REGISTER_PROBE, probe,
+                          kProbeOps) < 0) {
+        return false;
+      }
+
+      // SEND_ZC arrived together with multishot recv (6.0).
+      return std::ranges::all_of(
+          std::array{IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND,
+                     IORING_OP_SPLICE, IORING_OP_LINK_TIMEOUT,
+                     IORING_OP_ASYNC_CANCEL, IORING_OP_SEND_ZC},
+          [probe](const auto opcode) {
+            return isOpcodeSupported(*probe, opcode);
+          });
+    } catch (const std::exception &) {
+      return false;
+    }
+  }();
+
+  return kSupported;
+}
+
+const std::shared_ptr<IoUring> &IoUring::forCurrentThread() {
+  thread_local const auto kRing{std::make_shared<IoUring>()};
+  return kRing;
+}
+
+void IoUring::_mapRings() {
+  const auto &sqOff{_params.sq_off};
+  const auto &cqOff{_params.cq_off};
+
+  _sqRingSize = sqOff.array + (_params.sq_entries * sizeof(unsigned));
+  _cqRingSize = cqOff.cqes + (_params.cq_entries * sizeof(io_uring_cqe));
+
+  const bool singleMmap = (_params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+  if (singleMmap) {
+    _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+  }
+
+  _sqRingPtr = ::mmap(nullptr, _sqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+
+  if (_sqRingPtr == MAP_FAILED) {
+    _sqRingPtr = nullptr;
+    throw std::runtime_error("Unable to map io_uring submission ring");
+  }
+
+  if (singleMmap) {
+    _cqRingPtr = _sqRingPtr;
+  } else {
+    _cqRingPtr = ::mmap(nullptr, _cqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+
+    if (_cqRingPtr == MAP_FAILED) {
+      _cqRingPtr = nullptr;
+      throw std::runtime_error("Unable to map io_uring completion ring");
+    }
+  }
+
+  _sqesSize = _params.sq_entries * sizeof(io_uring_sqe);
+  auto *sqes = ::mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQES);
+
+  if (sqes == MAP_FAILED) {
+    throw std::runtime_error("Unable to map io_uring SQE array");
+  }
+
+  _sqes = static_cast<io_uring_sqe *>(sqes);
+
+  auto *sqBase = static_cast<char *>(_sqRingPtr);
+  auto *cqBase = static_cast<char *>(_cqRingPtr);
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  _sqHead = reinterpret_cast<unsigned *>(sqBase + sqOff.head);
+  _sqTail = reinterpret_cast<unsigned *>(sqBase + sqOff.tail);
+  _sqMask = reinterpret_cast<unsigned *>(sqBase + sqOff.ring_mask);
+  _sqArray = reinterpret_cast<unsigned *>(sqBase + sqOff.array);
+  _cqHead = reinterpret_cast<unsigned *>(cqBase + cqOff.head);
+  _cqTail = reinterpret_cast<unsigned *>(cqBase + cqOff.tail);
+  _cqMask = reinterpret_cast<unsigned *>(cqBase + cqOff.ring_mask);
+  _cqes = reinterpret_cast<io_uring_cqe *>(cqBase + cqOff.cqes);
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void IoUring::_unmapRings() noexcept {
+  if (_bufferRing != nullptr) {
+    ::munmap(_bufferRing, _bufferRingSize);
+    _bufferRing = nullptr;
+  }
+  if (_sqes != nullptr) {
+    ::munmap(_sqes, _sqesSize);
+    _sqes = nullptr;
+  }
+  if (_cqRingPtr != nullptr && _cqRingPtr != _sqRingPtr) {
+    ::munmap(_cqRingPtr, _cqRingSize);
+  }
+  if (_sqRingPtr != nullptr) {
+    ::munmap(_sqRingPtr, _sqRingSize);
+  }
+  _sqRingPtr = _cqRingPtr = nullptr;
+}
+
+void IoUring::_registerFileTable() {
+  const std::vector<int> sparseTable(kFixedFileSlots, -1);
+
+  if (ioUringRegister(_ringFd, IORING_REGISTER_FILES, sparseTable.data(),
+                      kFixedFileSlots) < 0) {
+    throw std::runtime_error("Unable to register io_uring file table");
+  }
+
+  _freeFileSlots.reserve(kFixedFileSlots);
+
+  for (int slot = kFixedFileSlots - 1; slot > kPipeWriteSlot; --slot) {
+    _freeFileSlots.push_back(slot);
+  }
+}
+
+void IoUring::_setupBufferRing() {
+  _bufferRingSize = kProvidedBufferCount * sizeof(io_uring_buf);
+  auto *ringMemory = ::mmap(nullptr, _bufferRingSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (ringMemory == MAP_FAILED) {
+    throw std::runtime_error("Unable to allocate io_uring buffer ring");
+  }
+
+  _bufferRing = static_cast<io_uring_buf *>(ringMemory);
+
+  io_uring_buf_reg registration{};
+  registration.ring_addr = reinterpret_cast<std::uint64_t>(_bufferRing);
+  registration.ring_entries = kProvidedBufferCount;
+  registration.bgid = kBufferGroupId;
+
+  if (ioUringRegister(_ringFd, IORING_REGISTER_PBUF_RING, &registration, 1) <
+      0) {
+    throw std::runtime_error("Unable to register io_uring buffer ring");
+  }
+
+  _bufferStorage.resize(std::size_t{kProvidedBufferCount} *
+                        kProvidedBufferSize);
+
+  for (std::uint16_t bufferId = 0; bufferId < kProvidedBufferCount;
+       ++bufferId) {
+    recycleBuffer({.result = 0,
+                   .flags = static_cast<std::uint32_t>(bufferId)
+                            << IORING_CQE_BUFFER_SHIFT});
+  }
+}
+
+void IoUring::_createSplicePipe() {
+  if (::pipe2(static_cast<int *>(_pipeFds), O_CLOEXEC) < 0) {
+    throw std::runtime_error("Unable to create splice pipe");
+  }
+
+  io_uring_files_update update{};
+  update.offset = kPipeReadSlot;
+  update.fds = reinterpret_cast<std::uint64_t>(&_pipeFds[0]);
+
+  if (ioUringRegister(_ringFd, IORING_REGISTER_FILES_UPDATE, &update, 2) < 0) {
+    throw std::runtime_error("Unable to register splice pipe");
+  }
+}
+
+io_uring_sqe &IoUring::nextSqe() {
+  if (*_sqTail + _pendingSubmissions - loadAcquire(_sqHead) >=
+      _params.sq_entries) {
+    _submitAndWait(0, std::nullopt);
+  }
+
+  const auto tail{*_sqTail + _pendingSubmissions};
+  const auto index{tail & *_sqMask};
+
+  _sqArray[index] = index;  // NOLINT
+  ++_pendingSubmissions;
+
+  auto &sqe{_sqes[index]};  // NOLINT
+  std::memset(&sqe, 0, sizeof(sqe));
+  return sqe;
+}
+
+std::optional<UringCompletion> IoUring::waitFor(
+    const std::uint64_t tag,
+    const std::optional<std::chrono::milliseconds> timeout) {
+  const auto deadline{std::chrono::steady_clock::now() +
+                      timeout.value_or(std::chrono::milliseconds::zero())};
+
+  while (true) {
+    _reapCompletions();
+
+    if (const auto stashIt{_stash.find(tag)};
+        stashIt != _stash.end() && !stashIt->second.empty()) {
+      const auto completion{stashIt->second.front()};
+      stashIt->second.pop_front();
+      return completion;
+    }
+
+    std::optional<std::chrono::milliseconds> remaining;
+
+    if (timeout.has_value()) {
+      remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now());
+
+      if (remaining.value() <= std::chrono::milliseconds::zero()) {
+        return std::nullopt;
+      }
+    }
+
+    try {
+      _submitAndWait(1, remaining);
+    } catch (const std::system_error &e) {
+      if (e.code().value() == EINTR || e.code().value() == ETIME) {
+        return std::nullopt;
+      }
+
+      throw;
+    }
+  }
+}
+
+void IoUring::discardCompletions(const std::uint64_t tag) {
+  const auto stashIt{_stash.find(tag)};
+
+  if (stashIt == _stash.end()) {
+    return;
+  }
+
+  for (const auto &completion : stashIt->second) {
+    if ((completion.flags & IORING_CQE_F_BUFFER) != 0) {
+      recycleBuffer(completion);
+    }
+  }
+
+  _stash.erase(stashIt);
+}
+
+void IoUring::_submitAndWait(
+    const unsigned minComplete,
+    const std::optional<std::chrono::milliseconds> timeout) {
+  storeRelease(_sqTail, *_sqTail + _pendingSubmissions);
+  const auto toSubmit{_pendingSubmissions};
+  _pendingSubmissions = 0;
+
+  unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+  __kernel_timespec timeSpec{};
+  io_uring_getevents_arg extArg{};
+
+  if (timeout.has_value()) {
+    constexpr auto kNanosecondsInMillisecond = 1'000'000;
+    constexpr auto kMillisecondsInSecond = 1000;
+
+    timeSpec.tv_sec = timeout->count() / kMillisecondsInSecond;
+    timeSpec.tv_nsec =
+        (timeout->count() % kMillisecondsInSecond) * kNanosecondsInMillisecond;
+    extArg.ts = reinterpret_cast<std::uint64_t>(&timeSpec);
+    flags |= IORING_ENTER_EXT_ARG;
+  }
+
+  const auto result{
+      ioUringEnter(_ringFd, toSubmit, minComplete, flags,
+                   timeout.has_value() ? &extArg : nullptr,
+                   timeout.has_value() ? sizeof(extArg) : 0)};
+
+  if (result < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "io_uring_enter() failed");
+  }
+}
+
+void IoUring::_reapCompletions() {
+  auto head{*_cqHead};
+  const auto tail{loadAcquire(_cqTail)};
+
+  for (; head != tail; ++head) {
+    const auto &cqe{_cqes[head & *_cqMask]};  // NOLINT
+
+    if (cqe.user_data == kIgnoredTag) {
+      continue;
+    }
+
+    _stash[cqe.user_data].push_back({.result = cqe.res, .flags = cqe.flags});
+  }
+
+  storeRelease(_cqHead, head);
+}
+
+int IoUring::registerFile(const int fd) {
+  int slot{};
+
+  {
+    std::lock_guard<std::mutex> lock{_fileSlotsMutex};
+
+    if (_freeFileSlots.empty()) {
+      return -1;
+    }
+
+    slot = _freeFileSlots.back();
+    _freeFileSlots.pop_back();
+  }
+
+  io_uring_files_update update{};
+  update.offset = static_cast<std::uint32_t>(slot);
+  update.fds = reinterpret_cast<std::uint64_t>(&fd);
+
+  if (ioUringRegister(_ringFd, IORING_REGISTER_FILES_UPDATE, &update, 1) < 0) {
+    std::lock_guard<std::mutex> lock{_fileSlotsMutex};
+    _freeFileSlots.push_back(slot);
+    return -1;
+  }
+
+  return slot;
+}
+
+void IoUring::unregisterFile(const int slot) {
+  constexpr int kEmptySlot = -1;
+
+  io_uring_files_update update{};
+  update.offset = static_cast<std::uint32_t>(slot);
+  update.fds = reinterpret_cast<std::uint64_t>(&kEmptySlot);
+
+  ioUringRegister(_ringFd, IORING_REGISTER_FILES_UPDATE, &update, 1);
+
+  std::lock_guard<std::mutex> lock{_fileSlotsMutex};
+  _freeFileSlots.push_back(slot);
+}
+
+std::span<const char> IoUring::selectedBuffer(
+    const UringCompletion &completion) const {
+  const auto bufferId{completion.flags >> IORING_CQE_BUFFER_SHIFT};
+  const auto length{static_cast<std::size_t>(std::max(completion.result, 0))};
+
+  return {_bufferStorage.data() + (bufferId * kProvidedBufferSize), length};
+}
+
+void IoUring::recycleBuffer(const UringCompletion &completion) {
+  const auto bufferId{
+      static_cast<std::uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT)};
+  auto &ringTail{_bufferRing[0].resv};  // NOLINT
+  const auto tail{ringTail};
+
+  auto &slot{_bufferRing[tail & (kProvidedBufferCount - 1)]};  // NOLINT
+  slot.addr = reinterpret_cast<std::uint64_t>(_bufferStorage.data() +
+                                              (bufferId * kProvidedBufferSize));
+  slot.len = kProvidedBufferSize;
+  slot.bid = bufferId;
+
+  std::atomic_ref<std::uint16_t>{ringTail}.store(
+      static_cast<std::uint16_t>(tail + 1), std::memory_order_release);
+}
+
+}  // namespace webserver::net
+
+#endif  // __linux__
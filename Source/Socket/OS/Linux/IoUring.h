@@ -0,0 +1,114 @@
+#pragma once
+
+#ifdef __linux__
+
+  #include <linux/io_uring.h>
+
+  #include <chrono>
+  #include <cstdint>
+  #include <deque>
+  #include <memory>
+  #include <mutex>
+  #include <optional>
+  #include <span>
+  #include <unordered_map>
+  #include <vector>
+
+namespace webserver::net {
+
+struct UringCompletion {
+  std::int32_t result{};
+  std::uint32_t flags{};
+};
+
+// Thin wrapper over the raw io_uring syscalls. Each thread owns one ring;
+// completions are routed to whoever waits on their user_data tag, so several
+// sockets (and multishot requests) can share the ring of the thread they run
+// on. The ring also owns a sparse fixed-file table, a provided buffer ring for
+// multishot receives and a pipe used to splice files into sockets.
+class IoUring {
+ public:
+  // Completions tagged with kIgnoredTag (link timeouts, cancellations) are
+  // dropped when reaped.
+  static constexpr std::uint64_t kIgnoredTag = 0;
+  static constexpr std::uint16_t kBufferGroupId = 0;
+  static constexpr int kPipeReadSlot = 0;
+  static constexpr int kPipeWriteSlot = 1;
+
+  IoUring();
+  IoUring(const IoUring &) = delete;
+  IoUring(IoUring &&) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+  IoUring &operator=(IoUring &&) = delete;
+  ~IoUring();
+
+  // Probes once whether the running kernel supports everything the socket
+  // backend relies on (multishot accept/recv, buffer rings, ext-arg waits).
+  [[nodiscard]] static bool isSupported() noexcept;
+  [[nodiscard]] static const std::shared_ptr<IoUring> &forCurrentThread();
+
+  // Returns a zeroed SQE; flushes the submission queue first if it is full.
+  [[nodiscard]] io_uring_sqe &nextSqe();
+  // Submits everything queued and blocks until a completion for `tag` is
+  // available. Returns std::nullopt on timeout or signal interruption.
+  [[nodiscard]] std::optional<UringCompletion> waitFor(
+      std::uint64_t tag,
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+  // Drops completions already reaped for `tag`, recycling their buffers.
+  void discardCompletions(std::uint64_t tag);
+
+  [[nodiscard]] int registerFile(int fd);
+  void unregisterFile(int slot);
+
+  [[nodiscard]] std::span<const char> selectedBuffer(
+      const UringCompletion &completion) const;
+  void recycleBuffer(const UringCompletion &completion);
+
+ private:
+  void _mapRings();
+  void _registerFileTable();
+  void _setupBufferRing();
+  void _createSplicePipe();
+  void _submitAndWait(unsigned minComplete,
+                      std::optional<std::chrono::milliseconds> timeout);
+  void _reapCompletions();
+  void _unmapRings() noexcept;
+
+  int _ringFd{-1};
+  io_uring_params _params{};
+
+  void *_sqRingPtr{nullptr};
+  std::size_t _sqRingSize{};
+  void *_cqRingPtr{nullptr};
+  std::size_t _cqRingSize{};
+  io_uring_sqe *_sqes{nullptr};
+  std::size_t _sqesSize{};
+
+  unsigned *_sqHead{nullptr};
+  unsigned *_sqTail{nullptr};
+  unsigned *_sqMask{nullptr};
+  unsigned *_sqArray{nullptr};
+  unsigned *_cqHead{nullptr};
+  unsigned *_cqTail{nullptr};
+  unsigned *_cqMask{nullptr};
+  io_uring_cqe *_cqes{nullptr};
+  unsigned _pendingSubmissions{0};
+
+  std::unordered_map<std::uint64_t, std::deque<UringCompletion>> _stash;
+
+  std::mutex _fileSlotsMutex;  // sockets may be closed from another thread
+  std::vector<int> _freeFileSlots;
+
+  // Viewed as a plain io_uring_buf array: the kernel's io_uring_buf_ring
+  // flex-array declaration has a different layout when compiled as C++. The
+  // ring tail lives in the resv field of the first entry.
+  io_uring_buf *_bufferRing{nullptr};
+  std::size_t _bufferRingSize{};
+  std::vector<char> _bufferStorage;
+
+  int _pipeFds[2]{-1, -1};  // NOLINT
+};
+
+}  // namespace webserver::net
+
+#endif  // __linux__
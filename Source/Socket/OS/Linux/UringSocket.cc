@@ -0,0 +1,658 @@
+#include "UringSocket.h"
+
+#ifdef __linux__
+  #include <fcntl.h>
+  #include <linux/time_types.h>
+  #include <sys/socket.h>
+  #include <sys/stat.h>
+  #include <sys/uio.h>
+  #include <unistd.h>
+
+  #include <algorithm>
+  #include <array>
+  #include <climits>
+  #include <cerrno>
+  #include <chrono>
+  #include <optional>
+  #include <stdexcept>
+  #include <system_error>
+  #include <vector>
+
+namespace webserver::net {
+
+constexpr auto kTagShift = 8;
+constexpr auto kTagIndexBits = 5;
+constexpr auto kAcceptTimeout = std::chrono::seconds{5};
+constexpr auto kMultishotDrainTimeout = std::chrono::seconds{1};
+
+// Each pair (file -> pipe, pipe -> socket) moves at most one pipe worth of
+// data; several pairs are linked and submitted with a single io_uring_enter.
+constexpr std::int64_t kSpliceChunkSize = 64 * 1024;
+constexpr unsigned kSplicePairsPerBatch = 8;
+constexpr std::uint64_t kNoOffset = ~std::uint64_t{0};
+
+UringSocket::UringSocket() : _socket{std::make_unique<UnixSocket>()} {
+}
+
+UringSocket::UringSocket(std::unique_ptr<UnixSocket> socket)
+    : _socket{std::move(socket)} {
+}
+
+UringSocket::~UringSocket() noexcept {
+  close();
+}
+
+void UringSocket::connect(const HostData &hostData) {
+  _socket->connect(hostData);
+}
+
+void UringSocket::bind(const Endpoint &endpoint) {
+  _socket->bind(endpoint);
+}
+
+void UringSocket::enableReusePort() {
+  _socket->enableReusePort();
+}
+
+void UringSocket::listen() {
+  _socket->listen();
+}
+
+int UringSocket::nativeHandle() const noexcept {
+  return _socket->nativeHandle();
+}
+
+void UringSocket::setNonBlocking() {
+  _socket->setNonBlocking();
+  _nonBlocking = true;
+}
+
+std::optional<std::size_t> UringSocket::receiveSome(std::span<char> buffer) {
+  return _socket->receiveSome(buffer);
+}
+
+std::optional<std::size_t> UringSocket::sendSome(std::span<const char> data,
+                                                 const bool moreFollows) {
+  return _socket->sendSome(data, moreFollows);
+}
+
+std::optional<std::size_t> UringSocket::sendFileSome(const int fileFd,
+                                           std::int64_t &offset,
+                                           const std::size_t count) {
+  return _socket->sendFileSome(fileFd, offset, count);
+}
+
+void UringSocket::enableZeroCopy(const std::size_t minSize) {
+  _zeroCopyThreshold = minSize;
+  _socket->enableZeroCopy(minSize);  // non-blocking sends go through it
+}
+
+std::uint32_t UringSocket::zeroCopyIssued() const noexcept {
+  return _socket->zeroCopyIssued();
+}
+
+std::uint32_t UringSocket::reapZeroCopyCompletions() {
+  return _socket->reapZeroCopyCompletions();
+}
+
+void UringSocket::enableCpuSteering(
+    const std::size_t listenersCount,
+    const std::span<const std::size_t> cpuOwners) {
+  _socket->enableCpuSteering(listenersCount, cpuOwners);
+}
+
+std::optional<int> UringSocket::incomingCpu() const noexcept {
+  return _socket->incomingCpu();
+}
+
+std::optional<IpAddress> UringSocket::peerAddress() const noexcept {
+  return _socket->peerAddress();
+}
+
+std::unique_ptr<ISocket> UringSocket::accept() {
+  if (_handedOff) {
+    if (_acceptedBacklog.empty()) {
+      return nullptr;
+    }
+
+    const auto clientFd{_acceptedBacklog.back()};
+    _acceptedBacklog.pop_back();
+    return _adoptClient(clientFd);
+  }
+
+  if (_nonBlocking) {
+    // Readiness-driven callers (the reactor) expect nullptr once drained.
+    const auto clientFd{::accept(nativeHandle(), nullptr, nullptr)};
+
+    if (clientFd < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return nullptr;
+      }
+
+      throw std::system_error(errno, std::generic_category(),
+                              "Error while accepting socket");
+    }
+
+    return _adoptClient(clientFd);
+  }
+
+  _bindToCurrentRing();
+
+  if (!_acceptArmed) {
+    auto &sqe{_ring->nextSqe()};
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = nativeHandle();
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.user_data = _tag(Operation::ACCEPT);
+    _acceptArmed = true;
+  }
+
+  const auto completion{
+      _ring->waitFor(_tag(Operation::ACCEPT), kAcceptTimeout)};
+
+  if (!completion.has_value()) {
+    return nullptr;  // timed out or interrupted, caller re-checks shutdown
+  }
+
+  if ((completion->flags & IORING_CQE_F_MORE) == 0) {
+    _acceptArmed = false;  // re-armed on the next call
+  }
+
+  if (completion->result < 0) {
+    throw std::system_error(-completion->result, std::generic_category(),
+                            "Error while accepting socket");
+  }
+
+  return _adoptClient(completion->result);
+}
+
+std::unique_ptr<ISocket> UringSocket::_adoptClient(const int clientFd) const {
+  auto clientSocket{
+      std::make_unique<UringSocket>(UnixSocket::fromNativeHandle(clientFd))};
+  clientSocket->enableZeroCopy(_zeroCopyThreshold);
+  return clientSocket;
+}
+
+std::string UringSocket::receive() {
+  if (_nonBlocking) {
+    return _socket->receive();
+  }
+
+  _bindToCurrentRing();
+
+  // Same deadlines as the POSIX socket: the idle timeout until the first
+  // bytes, then the request deadline for the rest of the request.
+  std::optional<std::chrono::steady_clock::time_point> requestDeadline;
+
+  while (!_receiveBuffer.hasCompleteRequest()) {
+    auto timeout{_timeouts.idle};
+
+    if (!_receiveBuffer.empty()) {
+      if (!requestDeadline.has_value()) {
+        requestDeadline = std::chrono::steady_clock::now() + _timeouts.request;
+      }
+
+      timeout = std::chrono::ceil<std::chrono::milliseconds>(
+          requestDeadline.value() - std::chrono::steady_clock::now());
+
+      if (timeout <= std::chrono::milliseconds::zero()) {
+        // Drop the partial request, the client gets a 408 instead.
+        static_cast<void>(_receiveBuffer.takeRequest());
+        throw http::RequestRejected{http::StatusCode::HTTP_408_REQUEST_TIMEOUT,
+                                    "request timed out"};
+      }
+    }
+
+    if (!_receiveArmed) {
+      auto &sqe{_ring->nextSqe()};
+      sqe.opcode = IORING_OP_RECV;
+      _setTarget(*_ring, sqe);
+      sqe.ioprio = IORING_RECV_MULTISHOT;
+      sqe.flags |= IOSQE_BUFFER_SELECT;
+      sqe.buf_group = IoUring::kBufferGroupId;
+      sqe.user_data = _tag(Operation::RECEIVE);
+      _receiveArmed = true;
+    }
+
+    const auto completion{
+        _ring->waitFor(_tag(Operation::RECEIVE), timeout)};
+
+    if (!completion.has_value()) {
+      if (_receiveBuffer.empty()) {
+        break;  // idle timeout, nothing to answer
+      }
+
+      continue;  // the request deadline is checked above
+    }
+
+    if ((completion->flags & IORING_CQE_F_MORE) == 0) {
+      _receiveArmed = false;
+    }
+
+    if (completion->result == -ENOBUFS) {
+      continue;  // buffers were recycled meanwhile, re-arm
+    }
+
+    if (completion->result <= 0) {
+      break;  // peer closed or error
+    }
+
+    const auto data{_ring->selectedBuffer(completion.value())};
+    _receiveBuffer.append({data.data(), data.size()});
+    _ring->recycleBuffer(completion.value());
+  }
+
+  auto received{_receiveBuffer.takeRequest()};
+  _receiveBuffer.release();
+  return received;
+}
+
+void UringSocket::send(const std::string &data) {
+  if (!_nonBlocking) {
+    _bindToCurrentRing();
+  }
+
+  _sendBuffer(*IoUring::forCurrentThread(), data, 0);
+}
+
+void UringSocket::sendZeroCopyFile(std::filesystem::path filePath) {
+  sendFileWithHead({}, std::move(filePath));
+}
+
+void UringSocket::sendVectored(const std::span<const std::string_view> parts) {
+  if (!_nonBlocking) {
+    _bindToCurrentRing();
+  }
+
+  std::vector<iovec> vectors;
+  vectors.reserve(parts.size());
+
+  for (const auto part : parts) {
+    if (!part.empty()) {
+      vectors.push_back({.iov_base = const_cast<char *>(part.data()),
+                         .iov_len = part.size()});
+    }
+  }
+
+  auto &ring{*IoUring::forCurrentThread()};
+  std::size_t totalSize{0};
+
+  for (const auto &vector : vectors) {
+    totalSize += vector.iov_len;
+  }
+
+  if (_zeroCopyThreshold == 0 || totalSize < _zeroCopyThreshold) {
+    _sendVectors(ring, vectors, 0);
+    return;
+  }
+
+  // Parts above the threshold go out with SEND_ZC, smaller ones (headers)
+  // are corked in front of them.
+  for (std::size_t i = 0; i < vectors.size(); ++i) {
+    _sendBuffer(ring,
+                {static_cast<const char *>(vectors.at(i).iov_base),
+                 vectors.at(i).iov_len},
+                i + 1 < vectors.size() ? MSG_MORE : 0);
+  }
+}
+
+void UringSocket::sendFileWithHead(const std::string_view head,
+                                   const std::filesystem::path filePath) {
+  if (filePath.empty()) {
+    throw std::runtime_error("Empty file path");
+  }
+
+  const int fileFd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fileFd < 0) {
+    throw std::runtime_error("Failed to open file");
+  }
+
+  struct stat stats{};
+
+  if (::fstat(fileFd, &stats) < 0) {
+    ::close(fileFd);
+    throw std::runtime_error("Failed to stat file");
+  }
+
+  if (!_nonBlocking) {
+    _bindToCurrentRing();
+  }
+
+  auto &ring{*IoUring::forCurrentThread()};
+  std::int64_t offset{0};
+  std::size_t bytesInPipe{0};
+
+  try {
+    if (!head.empty()) {
+      std::array<iovec, 1> headVector{{{
+          .iov_base = const_cast<char *>(head.data()),
+          .iov_len = head.size(),
+      }}};
+      // Corked: the head waits for the first spliced bytes of the file.
+      _sendVectors(ring, headVector, stats.st_size > 0 ? MSG_MORE : 0);
+    }
+
+    while (offset < stats.st_size || bytesInPipe > 0) {
+      offset += static_cast<std::int64_t>(_spliceBatch(
+          ring, fileFd, offset, stats.st_size - offset, bytesInPipe));
+    }
+  } catch (...) {
+    ::close(fileFd);
+    throw;
+  }
+
+  ::close(fileFd);
+}
+
+void UringSocket::_sendBuffer(IoUring &ring, const std::string_view data,
+                              const int flags) {
+  // Corked data is not transmitted, so waiting for the notification of a
+  // corked SEND_ZC would never finish.
+  const bool zeroCopy{(flags & MSG_MORE) == 0 && _zeroCopyThreshold > 0 &&
+                      data.size() >= _zeroCopyThreshold};
+  std::size_t totalSent{0};
+
+  while (totalSent < data.size()) {
+    auto &sqe{ring.nextSqe()};
+    sqe.opcode = zeroCopy ? IORING_OP_SEND_ZC : IORING_OP_SEND;
+    _setTarget(ring, sqe);
+    sqe.addr = reinterpret_cast<std::uint64_t>(data.data() + totalSent);
+    sqe.len = static_cast<std::uint32_t>(data.size() - totalSent);
+    sqe.msg_flags = static_cast<std::uint32_t>(flags) | MSG_NOSIGNAL;
+    sqe.user_data = _tag(Operation::SEND);
+    _addLinkTimeout(ring, sqe);
+
+    const auto completion{_waitForCompletion(ring, _tag(Operation::SEND))};
+
+    if ((completion.flags & IORING_CQE_F_MORE) != 0) {
+      // SEND_ZC keeps using the buffer until its IORING_CQE_F_NOTIF
+      // completion, which shares the tag.
+      static_cast<void>(_waitForCompletion(ring, _tag(Operation::SEND)));
+    }
+
+    if (completion.result <= 0) {
+      throw std::runtime_error("send() failed");
+    }
+
+    totalSent += static_cast<std::size_t>(completion.result);
+  }
+}
+
+void UringSocket::_sendVectors(IoUring &ring, std::span<iovec> vectors,
+                               const int flags) {
+  while (!vectors.empty()) {
+    msghdr message{};
+    message.msg_iov = vectors.data();
+    message.msg_iovlen = std::min<std::size_t>(vectors.size(), IOV_MAX);
+
+    auto &sqe{ring.nextSqe()};
+    sqe.opcode = IORING_OP_SENDMSG;
+    _setTarget(ring, sqe);
+    sqe.addr = reinterpret_cast<std::uint64_t>(&message);
+    sqe.len = 1;
+    sqe.msg_flags = static_cast<std::uint32_t>(flags) | MSG_NOSIGNAL;
+    sqe.user_data = _tag(Operation::SEND);
+    _addLinkTimeout(ring, sqe);
+
+    const auto completion{_waitForCompletion(ring, _tag(Operation::SEND))};
+
+    if (completion.result <= 0) {
+      throw std::runtime_error("sendmsg() failed");
+    }
+
+    auto remaining{static_cast<std::size_t>(completion.result)};
+
+    while (!vectors.empty() && remaining >= vectors.front().iov_len) {
+      remaining -= vectors.front().iov_len;
+      vectors = vectors.subspan(1);
+    }
+
+    if (remaining > 0) {
+      auto &partial{vectors.front()};
+      partial.iov_base = static_cast<char *>(partial.iov_base) + remaining;
+      partial.iov_len -= remaining;
+    }
+  }
+}
+
+std::size_t UringSocket::_spliceBatch(IoUring &ring, const int fileFd,
+                                      const std::int64_t offset,
+                                      const std::int64_t remaining,
+                                      std::size_t &bytesInPipe) {
+  const auto queuePipeToSocket = [this, &ring](const std::size_t length,
+                                               const unsigned index,
+                                               const bool linkNext) {
+    auto &sqe{ring.nextSqe()};
+    sqe.opcode = IORING_OP_SPLICE;
+    _setTarget(ring, sqe);
+    sqe.off = kNoOffset;
+    sqe.splice_fd_in = IoUring::kPipeReadSlot;
+    sqe.splice_off_in = kNoOffset;
+    sqe.len = static_cast<std::uint32_t>(length);
+    sqe.splice_flags = SPLICE_F_MOVE | SPLICE_F_FD_IN_FIXED;
+    sqe.user_data = _tag(Operation::SPLICE, index);
+
+    if (linkNext) {
+      sqe.flags |= IOSQE_IO_LINK;
+    }
+  };
+
+  if (bytesInPipe > 0) {
+    // A previous pipe -> socket splice was short; flush the pipe first.
+    queuePipeToSocket(bytesInPipe, 0, false);
+    const auto completion{
+        _waitForCompletion(ring, _tag(Operation::SPLICE, 0))};
+
+    if (completion.result <= 0) {
+      throw std::runtime_error("splice() to socket failed");
+    }
+
+    bytesInPipe -= static_cast<std::size_t>(completion.result);
+    return 0;
+  }
+
+  const auto pairs{static_cast<unsigned>(
+      std::min<std::int64_t>(kSplicePairsPerBatch,
+                             (remaining + kSpliceChunkSize - 1) /
+                                 kSpliceChunkSize))};
+
+  for (unsigned pair = 0; pair < pairs; ++pair) {
+    const auto chunkOffset{offset + (pair * kSpliceChunkSize)};
+    const auto chunkLength{
+        std::min(kSpliceChunkSize, remaining - (pair * kSpliceChunkSize))};
+
+    auto &fileToPipe{ring.nextSqe()};
+    fileToPipe.opcode = IORING_OP_SPLICE;
+    fileToPipe.fd = IoUring::kPipeWriteSlot;
+    fileToPipe.flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+    fileToPipe.off = kNoOffset;
+    fileToPipe.splice_fd_in = fileFd;
+    fileToPipe.splice_off_in = static_cast<std::uint64_t>(chunkOffset);
+    fileToPipe.len = static_cast<std::uint32_t>(chunkLength);
+    fileToPipe.splice_flags = SPLICE_F_MOVE;
+    fileToPipe.user_data = _tag(Operation::SPLICE, pair * 2);
+
+    queuePipeToSocket(static_cast<std::size_t>(chunkLength), (pair * 2) + 1,
+                      pair + 1 < pairs);
+  }
+
+  // A short splice breaks the link and cancels the rest of the chain, so
+  // every completion has to be collected before deciding where to resume.
+  std::size_t readFromFile{0};
+  std::size_t writtenToSocket{0};
+  bool failed{false};
+
+  for (unsigned index = 0; index < pairs * 2; ++index) {
+    const auto completion{
+        _waitForCompletion(ring, _tag(Operation::SPLICE, index))};
+
+    if (completion.result == -ECANCELED) {
+      continue;
+    }
+
+    if (completion.result < 0) {
+      failed = true;
+      continue;
+    }
+
+    (index % 2 == 0 ? readFromFile : writtenToSocket) +=
+        static_cast<std::size_t>(completion.result);
+  }
+
+  if (failed) {
+    throw std::runtime_error("splice() failed");
+  }
+
+  bytesInPipe = readFromFile - writtenToSocket;
+  return readFromFile;
+}
+
+void UringSocket::setTimeouts(const SocketTimeouts &timeouts) {
+  _socket->setTimeouts(timeouts);
+  _timeouts = timeouts;
+
+  const auto seconds{std::chrono::floor<std::chrono::seconds>(timeouts.send)};
+  _sendTimeout.tv_sec = seconds.count();
+  _sendTimeout.tv_nsec =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(timeouts.send -
+                                                           seconds)
+          .count();
+}
+
+void UringSocket::setRequestLimits(const http::RequestLimits &limits) {
+  _socket->setRequestLimits(limits);
+  _receiveBuffer.setLimits(limits);
+}
+
+void UringSocket::close() {
+  if (_ring != nullptr) {
+    if (_acceptArmed || _receiveArmed) {
+      // Shutting the socket down terminates any multishot request, wherever
+      // it was armed; completions are only reclaimed on the owning thread.
+      ::shutdown(nativeHandle(), SHUT_RDWR);
+
+      if (_ring == IoUring::forCurrentThread()) {
+        _drainMultishot(Operation::ACCEPT, _acceptArmed);
+        _drainMultishot(Operation::RECEIVE, _receiveArmed);
+      }
+    }
+
+    if (_fixedSlot >= 0) {
+      _ring->unregisterFile(_fixedSlot);
+      _fixedSlot = -1;
+    }
+
+    _ring.reset();
+  }
+
+  for (const auto clientFd : _acceptedBacklog) {
+    ::close(clientFd);
+  }
+  _acceptedBacklog.clear();
+
+  _socket->close();
+}
+
+void UringSocket::handOff() {
+  _handedOff = true;
+
+  if (_acceptArmed && _ring == IoUring::forCurrentThread()) {
+    // Shutting the socket down would also stop the process it was passed
+    // to, so cancel the multishot accept instead.
+    auto &sqe{_ring->nextSqe()};
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = -1;
+    sqe.addr = _tag(Operation::ACCEPT);
+    sqe.user_data = IoUring::kIgnoredTag;
+    _drainMultishot(Operation::ACCEPT, _acceptArmed);
+  }
+
+  _acceptArmed = false;
+  _socket->handOff();
+}
+
+void UringSocket::_drainMultishot(const Operation operation, bool &armed) {
+  const auto tag{_tag(operation)};
+
+  while (armed) {
+    const auto completion{_ring->waitFor(tag, kMultishotDrainTimeout)};
+
+    if (!completion.has_value()) {
+      break;
+    }
+
+    if ((completion->flags & IORING_CQE_F_BUFFER) != 0) {
+      _ring->recycleBuffer(completion.value());
+    } else if (operation == Operation::ACCEPT && completion->result >= 0) {
+      if (_handedOff) {
+        _acceptedBacklog.push_back(completion->result);  // still served
+      } else {
+        ::close(completion->result);  // accepted but never handed out
+      }
+    }
+
+    armed = (completion->flags & IORING_CQE_F_MORE) != 0;
+  }
+
+  armed = false;
+  _ring->discardCompletions(tag);
+}
+
+std::uint64_t UringSocket::_tag(const Operation operation,
+                                const unsigned index) const noexcept {
+  return (reinterpret_cast<std::uint64_t>(this) << kTagShift) |
+         (static_cast<std::uint64_t>(operation) << kTagIndexBits) | index;
+}
+
+void UringSocket::_bindToCurrentRing() {
+  const auto &currentRing{IoUring::forCurrentThread()};
+
+  if (_ring == nullptr) {
+    _ring = currentRing;
+    _fixedSlot = _ring->registerFile(nativeHandle());  // -1 if table is full
+    return;
+  }
+
+  if (_ring != currentRing) {
+    throw std::logic_error(
+        "blocking io_uring socket used from more than one thread");
+  }
+}
+
+void UringSocket::_setTarget(const IoUring &ring, io_uring_sqe &sqe) const {
+  if (&ring == _ring.get() && _fixedSlot >= 0) {
+    sqe.fd = _fixedSlot;
+    sqe.flags |= IOSQE_FIXED_FILE;
+    return;
+  }
+
+  sqe.fd = nativeHandle();
+}
+
+UringCompletion UringSocket::_waitForCompletion(IoUring &ring,
+                                                const std::uint64_t tag) {
+  // The request references caller-owned memory, so it must be reaped even if
+  // the wait is interrupted by a signal.
+  while (true) {
+    if (const auto completion{ring.waitFor(tag)}; completion.has_value()) {
+      return completion.value();
+    }
+  }
+}
+
+void UringSocket::_addLinkTimeout(IoUring &ring,
+                                  io_uring_sqe &linkedSqe) const {
+  linkedSqe.flags |= IOSQE_IO_LINK;
+
+  auto &timeoutSqe{ring.nextSqe()};
+  timeoutSqe.opcode = IORING_OP_LINK_TIMEOUT;
+  timeoutSqe.fd = -1;
+  timeoutSqe.addr = reinterpret_cast<std::uint64_t>(&_sendTimeout);
+  timeoutSqe.len = 1;
+  timeoutSqe.user_data = IoUring::kIgnoredTag;
+}
+
+}  // namespace webserver::net
+
+#endif  // __linux__
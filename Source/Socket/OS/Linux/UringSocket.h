@@ -0,0 +1,104 @@
+#pragma once
+
+#ifdef __linux__
+
+  #include <linux/time_types.h>
+  #include <sys/uio.h>
+
+  #include <memory>
+  #include <vector>
+
+  #include "IoUring.h"
+  #include "RequestBuffer.h"
+  #include "Socket.h"
+  #include "UnixSocket.h"
+
+namespace webserver::net {
+
+// Socket backend that performs data-path operations through the io_uring of
+// the calling thread. Blocking sockets use a multishot accept/recv armed once
+// per socket, are registered as fixed files, and stream files with batches of
+// linked splice requests. Control-path calls (bind, listen, connect) and the
+// readiness-based non-blocking calls are delegated to a plain UnixSocket.
+class UringSocket final : public ISocket, public IListener {
+ public:
+  UringSocket();
+  explicit UringSocket(std::unique_ptr<UnixSocket> socket);
+  UringSocket(const UringSocket &) = delete;
+  UringSocket(UringSocket &&) = delete;
+  UringSocket &operator=(const UringSocket &) = delete;
+  UringSocket &operator=(UringSocket &&) = delete;
+  ~UringSocket() noexcept override;
+
+  void connect(const HostData &hostData);
+
+  void bind(const Endpoint &endpoint) override;
+  void enableReusePort() override;
+  [[nodiscard]] std::unique_ptr<ISocket> accept() override;
+  void listen() override;
+  void handOff() override;
+  void enableZeroCopy(std::size_t minSize) override;
+  void enableCpuSteering(std::size_t listenersCount,
+                         std::span<const std::size_t> cpuOwners) override;
+
+  void send(const std::string &data) override;
+  [[nodiscard]] std::string receive() override;
+  void sendZeroCopyFile(std::filesystem::path filePath) override;
+  void sendVectored(std::span<const std::string_view> parts) override;
+  void sendFileWithHead(std::string_view head,
+                        std::filesystem::path filePath) override;
+  void close() override;
+  void setTimeouts(const SocketTimeouts &timeouts) override;
+  void setRequestLimits(const http::RequestLimits &limits) override;
+
+  [[nodiscard]] int nativeHandle() const noexcept override;
+  void setNonBlocking() override;
+  [[nodiscard]] std::optional<std::size_t> receiveSome(
+      std::span<char> buffer) override;
+  [[nodiscard]] std::optional<std::size_t> sendSome(
+      std::span<const char> data, bool moreFollows) override;
+  [[nodiscard]] std::optional<std::size_t> sendFileSome(
+      int fileFd, std::int64_t &offset, std::size_t count) override;
+
+  [[nodiscard]] std::uint32_t zeroCopyIssued() const noexcept override;
+  [[nodiscard]] std::uint32_t reapZeroCopyCompletions() override;
+  [[nodiscard]] std::optional<int> incomingCpu() const noexcept override;
+  [[nodiscard]] std::optional<IpAddress> peerAddress()
+      const noexcept override;
+
+ private:
+  enum class Operation : std::uint8_t { ACCEPT = 1, RECEIVE, SEND, SPLICE };
+
+  [[nodiscard]] std::uint64_t _tag(Operation operation,
+                                   unsigned index = 0) const noexcept;
+  void _bindToCurrentRing();
+  void _setTarget(const IoUring &ring, io_uring_sqe &sqe) const;
+  [[nodiscard]] static UringCompletion _waitForCompletion(IoUring &ring,
+                                                          std::uint64_t tag);
+  void _addLinkTimeout(IoUring &ring, io_uring_sqe &linkedSqe) const;
+  void _sendBuffer(IoUring &ring, std::string_view data, int flags);
+  void _sendVectors(IoUring &ring, std::span<iovec> vectors, int flags);
+  [[nodiscard]] std::unique_ptr<ISocket> _adoptClient(int clientFd) const;
+  [[nodiscard]] std::size_t _spliceBatch(IoUring &ring, int fileFd,
+                                         std::int64_t offset,
+                                         std::int64_t remaining,
+                                         std::size_t &bytesInPipe);
+  void _drainMultishot(Operation operation, bool &armed);
+
+  std::unique_ptr<UnixSocket> _socket;
+  std::shared_ptr<IoUring> _ring;  // ring owning the multishot requests
+  int _fixedSlot{-1};
+  bool _nonBlocking{false};
+  bool _acceptArmed{false};
+  bool _receiveArmed{false};
+  bool _handedOff{false};
+  std::vector<int> _acceptedBacklog;  // taken by the cancelled accept
+  std::size_t _zeroCopyThreshold{0};  // 0 disables SEND_ZC
+  http::RequestBuffer _receiveBuffer;
+  SocketTimeouts _timeouts;
+  __kernel_timespec _sendTimeout{.tv_sec = 5, .tv_nsec = 0};  // link timeout
+};
+
+}  // namespace webserver::net
+
+#endif  // __linux__
@@ -4,29 +4,54 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <sys/_types/_timeval.h>
+#include <poll.h>
 #include <sys/fcntl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/un.h>
 
 #ifdef __linux__
+  #include <linux/errqueue.h>
+  #include <linux/filter.h>
   #include <sys/sendfile.h>
 
   #include <cstring>
 #endif
 
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <climits>
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <system_error>
+#include <vector>
 
 #include "HostData.h"
 
 namespace webserver::net {
 
-constexpr auto kBufferSize = 1024;
+#ifdef MSG_MORE
+constexpr int kMoreDataFlag = MSG_MORE;
+#else
+constexpr int kMoreDataFlag = 0;  // no corking, data is pushed right away
+#endif
+
+#ifdef __linux__
+constexpr int kZeroCopyFlag = MSG_ZEROCOPY;
+#else
+constexpr int kZeroCopyFlag = 0;
+#endif
+
+constexpr auto kDefaultSocketTimeoutSec = 5;
 
 UnixSocket::UnixSocket() {
   const auto fileDescriptor = ::socket(AF_INET, SOCK_STREAM, 0);
@@ -47,8 +72,6 @@ inline void UnixSocket::_setReuseAddressSocketOption(const int fileDes) {
 }
 
 inline void UnixSocket::_setTimeoutForSocket(const int fileDes) {
-  constexpr auto kDefaultSocketTimeoutSec = 5;
-
   timeval time{};
   time.tv_sec = kDefaultSocketTimeoutSec;
   time.tv_usec = 0;
@@ -57,6 +80,35 @@ inline void UnixSocket::_setTimeoutForSocket(const int fileDes) {
   setsockopt(fileDes, SOL_SOCKET, SO_SNDTIMEO, &time, sizeof(time));
 }
 
+void UnixSocket::setTimeouts(const SocketTimeouts& timeouts) {
+  _timeouts = timeouts;
+
+  // The idle timeout bounds the wait for the first bytes of a request, the
+  // rest of it is covered by the request deadline in receive().
+  const auto receiveTime{_toTimeval(timeouts.idle)};
+  const auto sendTime{_toTimeval(timeouts.send)};
+
+  setsockopt(_socketFd, SOL_SOCKET, SO_RCVTIMEO, &receiveTime,
+             sizeof(receiveTime));
+  setsockopt(_socketFd, SOL_SOCKET, SO_SNDTIMEO, &sendTime, sizeof(sendTime));
+}
+
+void UnixSocket::setRequestLimits(const http::RequestLimits& limits) {
+  _receiveBuffer.setLimits(limits);
+}
+
+timeval UnixSocket::_toTimeval(const std::chrono::milliseconds duration) {
+  const auto seconds{std::chrono::floor<std::chrono::seconds>(duration)};
+  const auto microseconds{
+      std::chrono::duration_cast<std::chrono::microseconds>(duration -
+                                                            seconds)};
+
+  timeval time{};
+  time.tv_sec = static_cast<decltype(time.tv_sec)>(seconds.count());
+  time.tv_usec = static_cast<decltype(time.tv_usec)>(microseconds.count());
+  return time;
+}
+
 UnixSocket::UnixSocket(const int fileDescriptor) {
   if (!_isValidFileDescriptor(fileDescriptor)) {
     throw std::runtime_error("Invalid file descriptor");
@@ -65,6 +117,47 @@ UnixSocket::UnixSocket(const int fileDescriptor) {
   _socketFd = fileDescriptor;
 }
 
+std::unique_ptr<UnixSocket> UnixSocket::fromNativeHandle(
+    const int fileDescriptor) {
+  auto socket{std::unique_ptr<UnixSocket>(new UnixSocket(fileDescriptor))};
+  sockaddr_storage address{};
+  socklen_t length{sizeof(address)};
+
+  if (::getpeername(fileDescriptor, reinterpret_cast<sockaddr*>(&address),
+                    &length) == 0) {
+    socket->_peerAddress =
+        IpAddress::fromSockaddr(reinterpret_cast<sockaddr*>(&address));
+  }
+
+  int listening{0};
+  socklen_t optionLength{sizeof(listening)};
+
+  if (::getsockopt(fileDescriptor, SOL_SOCKET, SO_ACCEPTCONN, &listening,
+                   &optionLength) == 0 &&
+      listening != 0) {
+    socket->_adoptListener();
+  }
+
+  return socket;
+}
+
+void UnixSocket::_adoptListener() {
+  // File status flags belong to the open file, which the previous owner
+  // shares; it may have made the descriptor non-blocking.
+  const auto flags{::fcntl(_socketFd, F_GETFL, 0)};
+  _sharedNonBlocking = flags >= 0 && (flags & O_NONBLOCK) != 0;
+
+  sockaddr_storage address{};
+  socklen_t length{sizeof(address)};
+
+  if (::getsockname(_socketFd, reinterpret_cast<sockaddr*>(&address),
+                    &length) == 0 &&
+      address.ss_family == AF_UNIX) {
+    const auto* unixAddress{reinterpret_cast<const sockaddr_un*>(&address)};
+    _unixPath = unixAddress->sun_path;
+  }
+}
+
 bool UnixSocket::_isValidFileDescriptor(const int fileDescriptor) noexcept {
   return fileDescriptor >= 0;
 }
@@ -79,6 +172,16 @@ void UnixSocket::close() {
     constexpr auto kInvalidSocketFd = -1;
     _socketFd = kInvalidSocketFd;
   }
+
+  if (!_unixPath.empty()) {
+    ::unlink(_unixPath.c_str());
+    _unixPath.clear();
+  }
+}
+
+void UnixSocket::handOff() {
+  _handedOff = true;
+  _unixPath.clear();  // the other process keeps serving on the socket file
 }
 
 void UnixSocket::connect(const HostData& hostData) {
@@ -117,34 +220,246 @@ struct addrinfo* UnixSocket::_resolveHostDataToAddressInfo(
   return server;
 }
 
-void UnixSocket::bind(const std::uint16_t port) {
-  auto address{_buildLocalAddressByPort(port)};
+void UnixSocket::bind(const Endpoint& endpoint) {
+  auto family{AF_INET6};
+
+  if (endpoint.isUnix()) {
+    family = AF_UNIX;
+  } else if (endpoint.address.isV4()) {
+    family = AF_INET;
+  }
+
+  // The constructor opened an IPv4 socket, other families need a new one.
+  if (family != AF_INET && !_reopen(family)) {
+    // A host without IPv6 still serves IPv4 on the wildcard address.
+    if (family != AF_INET6 || endpoint.address != IpAddress{}) {
+      throw std::runtime_error("Unable to create socket for " +
+                               endpoint.toString());
+    }
+
+    family = AF_INET;
+  }
+
+  if (family == AF_INET6) {
+    // Dual-stack regardless of the net.ipv6.bindv6only default.
+    constexpr int disable = 0;
+    setsockopt(_socketFd, IPPROTO_IPV6, IPV6_V6ONLY, &disable,
+               sizeof(disable));
+  }
+
+  if (family == AF_UNIX) {
+    _removeStaleUnixSocket(endpoint.path);
+  }
+
+  sockaddr_storage address{};
+  const auto length{_buildLocalAddress(endpoint, family, address)};
 
   const auto bindResult{
       ::bind(_socketFd, reinterpret_cast<struct sockaddr*>(&address),  // NOLINT
-             sizeof(address))};
+             length)};
 
   if (bindResult < 0) {
-    throw std::runtime_error("Unable to bind socket");
+    throw std::runtime_error("Unable to bind socket to " +
+                             endpoint.toString());
+  }
+
+  if (family == AF_UNIX) {
+    _unixPath = endpoint.path;
+  }
+}
+
+bool UnixSocket::_reopen(const int family) {
+  const auto fileDescriptor{::socket(family, SOCK_STREAM, 0)};
+
+  if (!_isValidFileDescriptor(fileDescriptor)) {
+    return false;
+  }
+
+  if (family != AF_UNIX) {
+    _setReuseAddressSocketOption(fileDescriptor);
+  }
+  _setTimeoutForSocket(fileDescriptor);
+
+  if (_reusePort) {
+    constexpr int enable = 1;
+    setsockopt(fileDescriptor, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int));
+  }
+
+  ::close(_socketFd);
+  _socketFd = fileDescriptor;
+  return true;
+}
+
+socklen_t UnixSocket::_buildLocalAddress(const Endpoint& endpoint,
+                                         const int family,
+                                         sockaddr_storage& address) {
+  const auto& bytes{endpoint.address.bytes()};
+
+  if (family == AF_UNIX) {
+    auto& local{reinterpret_cast<sockaddr_un&>(address)};  // NOLINT
+
+    if (endpoint.path.size() >= sizeof(local.sun_path)) {
+      throw std::invalid_argument("Unix socket path is too long: " +
+                                  endpoint.path);
+    }
+
+    local.sun_family = AF_UNIX;
+    std::ranges::copy(endpoint.path, std::begin(local.sun_path));
+    return sizeof(local);
   }
+
+  if (family == AF_INET6) {
+    auto& local{reinterpret_cast<sockaddr_in6&>(address)};  // NOLINT
+    local.sin6_family = AF_INET6;
+    local.sin6_port = htons(endpoint.port);
+    std::memcpy(&local.sin6_addr, bytes.data(), bytes.size());
+    return sizeof(local);
+  }
+
+  // IPv4 sits in the last four bytes; the unspecified :: maps to INADDR_ANY.
+  constexpr auto kV4Offset = 12;
+  auto& local{reinterpret_cast<sockaddr_in&>(address)};  // NOLINT
+  local.sin_family = AF_INET;
+  local.sin_port = htons(endpoint.port);
+  std::memcpy(&local.sin_addr, &bytes.at(kV4Offset), sizeof(local.sin_addr));
+  return sizeof(local);
 }
 
-struct sockaddr_in UnixSocket::_buildLocalAddressByPort(std::uint16_t port) {
-  struct sockaddr_in address{};
-  address.sin_family = AF_INET;
-  address.sin_addr.s_addr = INADDR_ANY;
-  address.sin_port = htons(port);
-  return address;
+void UnixSocket::_removeStaleUnixSocket(const std::string& path) {
+  struct stat status{};
+
+  if (::lstat(path.c_str(), &status) < 0 || !S_ISSOCK(status.st_mode)) {
+    return;  // nothing there, or a regular file bind() will refuse
+  }
+
+  // A socket file left behind by a crashed server refuses connections; one
+  // still accepting them belongs to a live server and is left alone.
+  const auto probe{::socket(AF_UNIX, SOCK_STREAM, 0)};
+
+  if (!_isValidFileDescriptor(probe)) {
+    return;
+  }
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+  const auto connectResult{::connect(
+      probe, reinterpret_cast<sockaddr*>(&address), sizeof(address))};
+  const auto connectError{errno};
+  ::close(probe);
+
+  if (connectResult < 0 && connectError == ECONNREFUSED) {
+    ::unlink(path.c_str());
+  }
+}
+
+void UnixSocket::enableReusePort() {
+  constexpr int enable = 1;
+  _reusePort = true;
+
+  if (setsockopt(_socketFd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int)) <
+      0) {
+    throw std::runtime_error("Unable to enable SO_REUSEPORT");
+  }
+}
+
+void UnixSocket::enableCpuSteering(
+    const std::size_t listenersCount,
+    const std::span<const std::size_t> cpuOwners) {
+#ifdef __linux__
+  // Loads the CPU that handled the incoming SYN and returns the index of the
+  // listener (in listen() order) whose shard owns it. While ownership is
+  // `cpu % listenersCount` that is all the program does; otherwise every
+  // CPU whose owner differs gets a compare-and-return ahead of the modulo.
+  std::vector<sock_filter> code{
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0,
+       static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_CPU)}};
+
+  for (std::size_t cpu = 0; cpu < cpuOwners.size(); ++cpu) {
+    if (cpuOwners[cpu] == cpu % listenersCount) {
+      continue;
+    }
+    if (code.size() + 4 > BPF_MAXINSNS) {
+      break;
+    }
+
+    code.push_back({BPF_JMP | BPF_JEQ | BPF_K, 0, 1,
+                    static_cast<std::uint32_t>(cpu)});
+    code.push_back(
+        {BPF_RET | BPF_K, 0, 0, static_cast<std::uint32_t>(cpuOwners[cpu])});
+  }
+
+  code.push_back({BPF_ALU | BPF_MOD | BPF_K, 0, 0,
+                  static_cast<std::uint32_t>(listenersCount)});
+  code.push_back({BPF_RET | BPF_A, 0, 0, 0});
+
+  const sock_fprog program{.len = static_cast<unsigned short>(code.size()),
+                           .filter = code.data()};
+
+  if (setsockopt(_socketFd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program,
+                 sizeof(program)) < 0) {
+    throw std::runtime_error("Unable to attach SO_REUSEPORT CPU steering");
+  }
+#else
+  static_cast<void>(listenersCount);
+  static_cast<void>(cpuOwners);
+#endif
+}
+
+std::optional<int> UnixSocket::incomingCpu() const noexcept {
+#ifdef __linux__
+  int cpu{-1};
+  socklen_t length{sizeof(cpu)};
+
+  if (getsockopt(_socketFd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &length) < 0 ||
+      cpu < 0) {
+    return std::nullopt;
+  }
+
+  return cpu;
+#else
+  return std::nullopt;
+#endif
+}
+
+std::optional<IpAddress> UnixSocket::peerAddress() const noexcept {
+  return _peerAddress;
 }
 
 std::unique_ptr<ISocket> UnixSocket::accept() {
-  const auto clientFileDescriptor{::accept(_socketFd, nullptr, nullptr)};
+  if (_handedOff) {
+    return nullptr;
+  }
+
+  if (_sharedNonBlocking && !_nonBlocking &&
+      !_waitUntilReadable(std::chrono::steady_clock::now() +
+                          std::chrono::seconds{kDefaultSocketTimeoutSec})) {
+    return nullptr;
+  }
+
+  sockaddr_storage peer{};
+  socklen_t peerLength{sizeof(peer)};
+  const auto clientFileDescriptor{::accept(
+      _socketFd, reinterpret_cast<sockaddr*>(&peer), &peerLength)};
 
   if (!_isValidFileDescriptor(clientFileDescriptor)) {
-    throw std::runtime_error("Error while accepting socket");
+    // Drained non-blocking queue, SO_RCVTIMEO expiry or a signal. An event
+    // loop takes nullptr as "drained", so it gets EINTR as an error to retry.
+    if (_isWouldBlockError() || (errno == EINTR && !_nonBlocking)) {
+      return nullptr;
+    }
+
+    throw std::system_error(errno, std::generic_category(),
+                            "Error while accepting socket");
   }
 
-  return std::unique_ptr<UnixSocket>(new UnixSocket(clientFileDescriptor));
+  auto clientSocket{
+      std::unique_ptr<UnixSocket>(new UnixSocket(clientFileDescriptor))};
+  clientSocket->_zeroCopyThreshold = _zeroCopyThreshold;
+  clientSocket->_peerAddress =
+      IpAddress::fromSockaddr(reinterpret_cast<sockaddr*>(&peer));
+  return clientSocket;
 }
 
 void UnixSocket::listen() {
@@ -155,30 +470,85 @@ void UnixSocket::listen() {
 }
 
 void UnixSocket::send(const std::string& data) {
-  if (const auto bytesSent{::send(_socketFd, data.data(), data.size(), 0)};
-      bytesSent != data.size()) {
-    throw std::runtime_error("Bytes sent don't match data size");
+  if (_useZeroCopy(data.size())) {
+    const std::array<std::string_view, 1> parts{data};
+    sendVectored(parts);
+    return;
+  }
+
+  std::size_t totalSent{0};
+
+  while (totalSent < data.size()) {
+    const auto bytesSent{::send(_socketFd, data.data() + totalSent,
+                                data.size() - totalSent, 0)};
+
+    if (bytesSent < 0 && _nonBlocking && _isWouldBlockError()) {
+      _waitUntilWritable();
+      continue;
+    }
+
+    if (bytesSent <= 0) {
+      throw std::runtime_error("send() failed");
+    }
+
+    totalSent += static_cast<std::size_t>(bytesSent);
   }
 }
 
 std::string UnixSocket::receive() {
-  std::string received;
-  std::array<char, kBufferSize> buffer{};
+  std::optional<std::chrono::steady_clock::time_point> requestDeadline;
+
+  while (!_receiveBuffer.hasCompleteRequest()) {
+    // Once part of a request is here, the rest has to arrive before the
+    // request deadline, however slowly the client trickles it in.
+    if (!_receiveBuffer.empty()) {
+      if (!requestDeadline.has_value()) {
+        requestDeadline = std::chrono::steady_clock::now() + _timeouts.request;
+      }
+
+      if (!_waitUntilReadable(requestDeadline.value())) {
+        // Drop the partial request, the client gets a 408 instead.
+        static_cast<void>(_receiveBuffer.takeRequest());
+        throw http::RequestRejected{http::StatusCode::HTTP_408_REQUEST_TIMEOUT,
+                                    "request timed out"};
+      }
+    }
 
-  ssize_t bytesReceived{0};
-  while ((bytesReceived = ::recv(_socketFd, buffer.data(), buffer.size(), 0)) >
-         0) {
-    received.append(buffer.data(), bytesReceived);
+    const auto space{_receiveBuffer.prepareWrite()};
+    const auto bytesReceived{::recv(_socketFd, space.data(), space.size(), 0)};
 
-    if (received.find("\r\n\r\n") != std::string::npos) {
-      break;
+    if (bytesReceived <= 0) {
+      break;  // peer closed, SO_RCVTIMEO expired or error
     }
+
+    _receiveBuffer.commitWrite(static_cast<std::size_t>(bytesReceived));
   }
 
+  auto received{_receiveBuffer.takeRequest()};
+  _receiveBuffer.release();
   return received;
 }
 
-void UnixSocket::sendZeroCopyFile(const std::filesystem::path filePath) {
+void UnixSocket::sendZeroCopyFile(std::filesystem::path filePath) {
+  sendFileWithHead({}, std::move(filePath));
+}
+
+void UnixSocket::sendVectored(const std::span<const std::string_view> parts) {
+  std::vector<iovec> vectors;
+  vectors.reserve(parts.size());
+
+  for (const auto part : parts) {
+    if (!part.empty()) {
+      vectors.push_back({.iov_base = const_cast<char*>(part.data()),
+                         .iov_len = part.size()});
+    }
+  }
+
+  _sendVectors(vectors, 0);
+}
+
+void UnixSocket::sendFileWithHead(const std::string_view head,
+                                  const std::filesystem::path filePath) {
   if (filePath.empty()) {
     throw std::runtime_error("Empty file path");
   }
@@ -194,6 +564,19 @@ void UnixSocket::sendZeroCopyFile(const std::filesystem::path filePath) {
     throw std::runtime_error("Failed to stat file");
   }
 
+  if (!head.empty()) {
+    std::array<iovec, 1> headVector{
+        {{.iov_base = const_cast<char*>(head.data()), .iov_len = head.size()}}};
+
+    try {
+      // Corked: the kernel waits for the file data to fill the segment.
+      _sendVectors(headVector, stats.st_size > 0 ? kMoreDataFlag : 0);
+    } catch (...) {
+      ::close(fileFd);
+      throw;
+    }
+  }
+
   off_t offset = 0;
   off_t remaining = stats.st_size;
 
@@ -203,6 +586,13 @@ void UnixSocket::sendZeroCopyFile(const std::filesystem::path filePath) {
 
     const int result = sendfile(fileFd, _socketFd, offset, &toSend, nullptr, 0);
 
+    if (result < 0 && _nonBlocking && _isWouldBlockError()) {
+      offset += toSend;  // partial progress is reported through toSend
+      remaining -= toSend;
+      _waitUntilWritable();
+      continue;
+    }
+
     if (result < 0) {
       ::close(fileFd);
       throw std::runtime_error("sendfile() failed");
@@ -216,6 +606,11 @@ void UnixSocket::sendZeroCopyFile(const std::filesystem::path filePath) {
   while (remaining > 0) {
     const ssize_t sent = ::sendfile(_socketFd, fileFd, &offset, remaining);
 
+    if (sent == -1 && _nonBlocking && _isWouldBlockError()) {
+      _waitUntilWritable();
+      continue;
+    }
+
     if (sent == -1) {
       ::close(fileFd);
       throw std::runtime_error("sendfile() failed");
@@ -230,4 +625,295 @@ void UnixSocket::sendZeroCopyFile(const std::filesystem::path filePath) {
   ::close(fileFd);
 }
 
+int UnixSocket::nativeHandle() const noexcept {
+  return _socketFd;
+}
+
+void UnixSocket::setNonBlocking() {
+  const auto flags{::fcntl(_socketFd, F_GETFL, 0)};
+
+  if (flags < 0 || ::fcntl(_socketFd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    throw std::runtime_error("Unable to make socket non-blocking");
+  }
+
+  _nonBlocking = true;
+}
+
+std::optional<std::size_t> UnixSocket::receiveSome(
+    const std::span<char> buffer) {
+  const auto bytesReceived{
+      ::recv(_socketFd, buffer.data(), buffer.size(), 0)};
+
+  if (bytesReceived >= 0) {
+    return static_cast<std::size_t>(bytesReceived);
+  }
+
+  if (_isWouldBlockError() || errno == EINTR) {
+    return std::nullopt;
+  }
+
+  if (errno == ECONNRESET) {
+    return 0;  // treat reset as an orderly close
+  }
+
+  throw std::runtime_error("recv() failed");
+}
+
+std::optional<std::size_t> UnixSocket::sendSome(
+    const std::span<const char> data, const bool moreFollows) {
+  // Corked data is not transmitted, so its completion would only arrive
+  // after the next send; keep corked sends on the copying path.
+  const bool zeroCopy{!moreFollows && _useZeroCopy(data.size())};
+  const auto bytesSent{
+      ::send(_socketFd, data.data(), data.size(),
+             (moreFollows ? kMoreDataFlag : 0) | (zeroCopy ? kZeroCopyFlag : 0))};
+
+  if (bytesSent >= 0) {
+    _zeroCopyIssued += zeroCopy && bytesSent > 0 ? 1 : 0;
+    return static_cast<std::size_t>(bytesSent);
+  }
+
+  if (_isWouldBlockError() || errno == EINTR) {
+    return std::nullopt;
+  }
+
+  throw std::runtime_error("send() failed");
+}
+
+std::optional<std::size_t> UnixSocket::sendFileSome(const int fileFd,
+                                                    std::int64_t& offset,
+                                                    const std::size_t count) {
+#if defined(__APPLE__) && defined(__MACH__)
+  auto bytesSent{static_cast<off_t>(count)};
+
+  const int result =
+      sendfile(fileFd, _socketFd, static_cast<off_t>(offset), &bytesSent,
+               nullptr, 0);
+
+  // A short write fails with EAGAIN but still reports progress.
+  if (result < 0 && !_isWouldBlockError() && errno != EINTR) {
+    throw std::runtime_error("sendfile() failed");
+  }
+
+  if (bytesSent == 0 && result < 0) {
+    return std::nullopt;
+  }
+
+  offset += bytesSent;
+  return static_cast<std::size_t>(bytesSent);
+#elifdef __linux__
+  auto fileOffset{static_cast<off_t>(offset)};
+  const auto bytesSent{::sendfile(_socketFd, fileFd, &fileOffset, count)};
+
+  if (bytesSent < 0) {
+    if (_isWouldBlockError() || errno == EINTR) {
+      return std::nullopt;
+    }
+
+    throw std::runtime_error("sendfile() failed");
+  }
+
+  offset = fileOffset;
+  return static_cast<std::size_t>(bytesSent);
+#else
+  #error "Unsupported UNIX platform"
+#endif
+}
+
+void UnixSocket::_sendVectors(std::span<iovec> vectors, int flags) {
+  std::size_t totalSize{0};
+
+  for (const auto& vector : vectors) {
+    totalSize += vector.iov_len;
+  }
+
+  // A corked send would wait for its own completion forever.
+  const bool zeroCopy{(flags & kMoreDataFlag) == 0 && _useZeroCopy(totalSize)};
+  flags |= zeroCopy ? kZeroCopyFlag : 0;
+
+  while (!vectors.empty()) {
+    msghdr message{};
+    message.msg_iov = vectors.data();
+    message.msg_iovlen = std::min<std::size_t>(vectors.size(), IOV_MAX);
+
+    const auto bytesSent{::sendmsg(_socketFd, &message, flags)};
+
+    if (bytesSent < 0 && _nonBlocking && _isWouldBlockError()) {
+      _waitUntilWritable();
+      continue;
+    }
+
+    if (bytesSent <= 0) {
+      throw std::runtime_error("sendmsg() failed");
+    }
+
+    _zeroCopyIssued += zeroCopy ? 1 : 0;
+
+    // Drop what was written, a partially written vector is advanced.
+    auto remaining{static_cast<std::size_t>(bytesSent)};
+
+    while (!vectors.empty() && remaining >= vectors.front().iov_len) {
+      remaining -= vectors.front().iov_len;
+      vectors = vectors.subspan(1);
+    }
+
+    if (remaining > 0) {
+      auto& partial{vectors.front()};
+      partial.iov_base = static_cast<char*>(partial.iov_base) + remaining;
+      partial.iov_len -= remaining;
+    }
+  }
+
+  if (zeroCopy) {
+    _waitForZeroCopyCompletions();  // the caller may free the data now
+  }
+}
+
+void UnixSocket::enableZeroCopy(const std::size_t minSize) {
+  _zeroCopyThreshold = minSize;
+}
+
+std::uint32_t UnixSocket::zeroCopyIssued() const noexcept {
+  return _zeroCopyIssued;
+}
+
+std::uint32_t UnixSocket::reapZeroCopyCompletions() {
+#ifdef __linux__
+  while (_zeroCopyCompleted != _zeroCopyIssued) {
+    std::array<char, CMSG_SPACE(sizeof(sock_extended_err))> control{};
+    msghdr message{};
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    if (::recvmsg(_socketFd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      if (_isWouldBlockError() || errno == EINTR) {
+        break;
+      }
+
+      throw std::runtime_error("Unable to read socket error queue");
+    }
+
+    for (auto* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      const bool isRecvErr{
+          (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+          (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)};
+
+      if (!isRecvErr) {
+        continue;
+      }
+
+      sock_extended_err error{};
+      std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+
+      // Notifications carry the inclusive range [ee_info, ee_data] of
+      // completed send ids, which the kernel numbers from 0.
+      if (error.ee_origin == SO_EE_ORIGIN_ZEROCOPY && error.ee_errno == 0) {
+        _zeroCopyCompleted = std::max(_zeroCopyCompleted, error.ee_data + 1);
+      }
+    }
+  }
+#endif
+
+  return _zeroCopyCompleted;
+}
+
+bool UnixSocket::_useZeroCopy(const std::size_t size) {
+#ifdef __linux__
+  if (_zeroCopyThreshold == 0 || size < _zeroCopyThreshold) {
+    return false;
+  }
+
+  if (!_zeroCopyEnabled) {
+    constexpr int enable = 1;
+
+    if (setsockopt(_socketFd, SOL_SOCKET, SO_ZEROCOPY, &enable,
+                   sizeof(enable)) < 0) {
+      _zeroCopyThreshold = 0;  // unsupported, keep copying
+      return false;
+    }
+
+    _zeroCopyEnabled = true;
+  }
+
+  return true;
+#else
+  static_cast<void>(size);
+  return false;
+#endif
+}
+
+void UnixSocket::_waitForZeroCopyCompletions() {
+  while (reapZeroCopyCompletions() != _zeroCopyIssued) {
+    // Error queue notifications are reported as POLLERR.
+    pollfd pollData{.fd = _socketFd, .events = 0, .revents = 0};
+
+    const auto pollResult{
+        ::poll(&pollData, 1, static_cast<int>(_timeouts.send.count()))};
+
+    if (pollResult == 0) {
+      throw std::runtime_error("Timed out waiting for zero-copy completion");
+    }
+
+    if (pollResult < 0 && errno != EINTR) {
+      throw std::runtime_error("poll() failed");
+    }
+
+    // POLLERR is also raised by a pending socket error, which would
+    // otherwise make this loop spin.
+    int socketError{0};
+    socklen_t length{sizeof(socketError)};
+
+    if ((pollData.revents & (POLLHUP | POLLNVAL)) != 0 ||
+        (::getsockopt(_socketFd, SOL_SOCKET, SO_ERROR, &socketError,
+                      &length) == 0 &&
+         socketError != 0)) {
+      throw std::runtime_error("Connection failed before zero-copy completion");
+    }
+  }
+}
+
+bool UnixSocket::_isWouldBlockError() noexcept {
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+void UnixSocket::_waitUntilWritable() const {
+  pollfd pollData{.fd = _socketFd, .events = POLLOUT, .revents = 0};
+
+  const auto pollResult{
+      ::poll(&pollData, 1, static_cast<int>(_timeouts.send.count()))};
+
+  if (pollResult == 0) {
+    throw std::runtime_error("Timed out waiting for socket to become writable");
+  }
+
+  if (pollResult < 0 && errno != EINTR) {
+    throw std::runtime_error("poll() failed");
+  }
+}
+
+bool UnixSocket::_waitUntilReadable(
+    const std::chrono::steady_clock::time_point deadline) const {
+  while (true) {
+    const auto remaining{std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now())};
+
+    if (remaining <= std::chrono::milliseconds::zero()) {
+      return false;
+    }
+
+    pollfd pollData{.fd = _socketFd, .events = POLLIN, .revents = 0};
+    const auto pollResult{
+        ::poll(&pollData, 1, static_cast<int>(remaining.count()))};
+
+    if (pollResult > 0) {
+      return true;  // data, hangup or error: recv() reports which
+    }
+
+    if (pollResult < 0 && errno != EINTR) {
+      return false;
+    }
+  }
+}
+
 }  // namespace webserver::net
@@ -1,13 +1,20 @@
 #pragma once
 
 #include <netdb.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include <chrono>
+#include <string>
 
 #include "HostData.h"
+#include "RequestBuffer.h"
 #include "Socket.h"
 
 namespace webserver::net {
 
-class UnixSocket final : public ISocket {
+// POSIX socket, used both as a listener and for the connections it accepts.
+class UnixSocket final : public ISocket, public IListener {
  public:
   UnixSocket();
   UnixSocket(const UnixSocket&) = delete;
@@ -16,14 +23,46 @@ class UnixSocket final : public ISocket {
   UnixSocket& operator=(UnixSocket&&) = delete;
   ~UnixSocket() noexcept override;
 
-  void connect(const HostData& hostData) override;
-  void bind(std::uint16_t port) override;
+  // Adopts an already open socket descriptor (e.g. one accepted elsewhere
+  // or a listener inherited from another process).
+  [[nodiscard]] static std::unique_ptr<UnixSocket> fromNativeHandle(
+      int fileDescriptor);
+
+  void connect(const HostData& hostData);
+
+  void bind(const Endpoint& endpoint) override;
+  void enableReusePort() override;
   std::unique_ptr<ISocket> accept() override;
   void listen() override;
+  void handOff() override;
+  void enableZeroCopy(std::size_t minSize) override;
+  void enableCpuSteering(std::size_t listenersCount,
+                         std::span<const std::size_t> cpuOwners) override;
+
   void send(const std::string& data) override;
   std::string receive() override;
   void sendZeroCopyFile(std::filesystem::path filePath) override;
+  void sendVectored(std::span<const std::string_view> parts) override;
+  void sendFileWithHead(std::string_view head,
+                        std::filesystem::path filePath) override;
   void close() override;
+  void setTimeouts(const SocketTimeouts& timeouts) override;
+  void setRequestLimits(const http::RequestLimits& limits) override;
+
+  [[nodiscard]] int nativeHandle() const noexcept override;
+  void setNonBlocking() override;
+  [[nodiscard]] std::optional<std::size_t> receiveSome(
+      std::span<char> buffer) override;
+  [[nodiscard]] std::optional<std::size_t> sendSome(
+      std::span<const char> data, bool moreFollows) override;
+  [[nodiscard]] std::optional<std::size_t> sendFileSome(
+      int fileFd, std::int64_t& offset, std::size_t count) override;
+
+  [[nodiscard]] std::uint32_t zeroCopyIssued() const noexcept override;
+  [[nodiscard]] std::uint32_t reapZeroCopyCompletions() override;
+  [[nodiscard]] std::optional<int> incomingCpu() const noexcept override;
+  [[nodiscard]] std::optional<IpAddress> peerAddress()
+      const noexcept override;
 
  private:
   explicit UnixSocket(int fileDescriptor);
@@ -34,11 +73,38 @@ class UnixSocket final : public ISocket {
 
   static void _setReuseAddressSocketOption(int fileDes);
   static void _setTimeoutForSocket(int fileDes);
+  [[nodiscard]] static timeval _toTimeval(std::chrono::milliseconds duration);
+  void _sendVectors(std::span<iovec> vectors, int flags);
+  [[nodiscard]] bool _useZeroCopy(std::size_t size);
+  void _waitForZeroCopyCompletions();
+  [[nodiscard]] static bool _isWouldBlockError() noexcept;
+  void _waitUntilWritable() const;
+  [[nodiscard]] bool _waitUntilReadable(
+      std::chrono::steady_clock::time_point deadline) const;
 
-  [[nodiscard]] static struct sockaddr_in _buildLocalAddressByPort(
-      std::uint16_t port);
+  void _adoptListener();
+  [[nodiscard]] bool _reopen(int family);
+  [[nodiscard]] static socklen_t _buildLocalAddress(const Endpoint& endpoint,
+                                                    int family,
+                                                    sockaddr_storage& address);
+  static void _removeStaleUnixSocket(const std::string& path);
 
   int _socketFd{};
+  bool _nonBlocking{false};
+  bool _reusePort{false};
+  // Inherited listener whose descriptor another process made non-blocking;
+  // blocking accepts poll first so they do not spin.
+  bool _sharedNonBlocking{false};
+  bool _handedOff{false};
+  std::string _unixPath;  // bound Unix socket file, removed on close()
+  http::RequestBuffer _receiveBuffer;
+  SocketTimeouts _timeouts;
+  std::optional<IpAddress> _peerAddress;
+
+  std::size_t _zeroCopyThreshold{0};  // 0 disables MSG_ZEROCOPY
+  bool _zeroCopyEnabled{false};       // SO_ZEROCOPY has been set
+  std::uint32_t _zeroCopyIssued{0};
+  std::uint32_t _zeroCopyCompleted{0};
 };
 
 }  // namespace webserver::net
@@ -1,13 +1,31 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 
-#include "HostData.h"
+#include "Endpoint.h"
+#include "IpAddress.h"
+#include "RequestBuffer.h"
 
 namespace webserver::net {
 
+// Connection deadlines. `idle` bounds the wait for the next request on a
+// kept-alive connection, `request` the time from the first byte of a request
+// until it has fully arrived, and `send` how long a write may stall.
+struct SocketTimeouts {
+  std::chrono::milliseconds idle{std::chrono::seconds{5}};
+  std::chrono::milliseconds request{std::chrono::seconds{5}};
+  std::chrono::milliseconds send{std::chrono::seconds{5}};
+};
+
+// Connected socket: the I/O of one client connection. Listeners hand these
+// out from IListener::accept().
 class ISocket {
  public:
   ISocket() = default;
@@ -17,14 +35,102 @@ class ISocket {
   ISocket &operator=(ISocket &&) = delete;
   virtual ~ISocket() = default;
 
-  virtual void connect(const HostData &hostData) = 0;
-  virtual void bind(std::uint16_t port) = 0;
-  [[nodiscard]] virtual std::unique_ptr<ISocket> accept() = 0;
-  virtual void listen() = 0;
   virtual void send(const std::string &data) = 0;
   [[nodiscard]] virtual std::string receive() = 0;
   virtual void sendZeroCopyFile(std::filesystem::path filePath) = 0;
+  // Sends all parts back to back with a single gathered write (writev) where
+  // the socket buffer allows, e.g. response headers and an in-memory body.
+  virtual void sendVectored(std::span<const std::string_view> parts) = 0;
+  // Sends `head` followed by the file contents. The head is held back
+  // (MSG_MORE) so it shares a TCP segment with the first bytes of the file.
+  virtual void sendFileWithHead(std::string_view head,
+                                std::filesystem::path filePath) = 0;
+  virtual void close() = 0;
+  // Deadlines enforced by the blocking calls: receive() gives up once the
+  // idle or request deadline passes and returns what has arrived, sends
+  // fail once they stall for longer than the send timeout. Event loops keep
+  // their own deadlines and do not rely on these.
+  virtual void setTimeouts(const SocketTimeouts &timeouts) = 0;
+  // Bounds on the requests receive() buffers; a request crossing one makes
+  // receive() throw http::RequestRejected.
+  virtual void setRequestLimits(const http::RequestLimits &limits) = 0;
+
+  // Readiness-driven I/O used by the event loop.
+  [[nodiscard]] virtual int nativeHandle() const noexcept = 0;
+  virtual void setNonBlocking() = 0;
+  // Returns std::nullopt if the read would block and 0 if the peer closed
+  // the connection.
+  [[nodiscard]] virtual std::optional<std::size_t> receiveSome(
+      std::span<char> buffer) = 0;
+  // Non-blocking counterparts of send()/sendZeroCopyFile(): write what the
+  // socket buffer accepts right now and return how much that was, or
+  // std::nullopt if nothing could be written. `moreFollows` corks the data
+  // (MSG_MORE) because the caller is about to send more. sendFileSome()
+  // advances `offset` by the number of bytes sent.
+  [[nodiscard]] virtual std::optional<std::size_t> sendSome(
+      std::span<const char> data, bool moreFollows) = 0;
+  [[nodiscard]] virtual std::optional<std::size_t> sendFileSome(
+      int fileFd, std::int64_t &offset, std::size_t count) = 0;
+
+  // MSG_ZEROCOPY, enabled by the listener (see IListener::enableZeroCopy()).
+  // Blocking sends wait for the kernel to release the buffer before
+  // returning. For sendSome() the caller must keep the buffer alive until
+  // reapZeroCopyCompletions() reaches the value zeroCopyIssued() had right
+  // after the send.
+  [[nodiscard]] virtual std::uint32_t zeroCopyIssued() const noexcept = 0;
+  [[nodiscard]] virtual std::uint32_t reapZeroCopyCompletions() = 0;
+
+  // CPU that received the connection's packets (Linux only, std::nullopt
+  // elsewhere), see IListener::enableCpuSteering().
+  [[nodiscard]] virtual std::optional<int> incomingCpu() const noexcept = 0;
+  // Address of the remote end; std::nullopt for non-IP peers.
+  [[nodiscard]] virtual std::optional<IpAddress> peerAddress()
+      const noexcept = 0;
+};
+
+// Listening socket.
+class IListener {
+ public:
+  IListener() = default;
+  IListener(const IListener &) = delete;
+  IListener(IListener &&) = delete;
+  IListener &operator=(const IListener &) = delete;
+  IListener &operator=(IListener &&) = delete;
+  virtual ~IListener() = default;
+
+  // Binds to a TCP (IPv4, IPv6 or dual-stack) or Unix domain endpoint; the
+  // descriptor is reopened in the endpoint's address family if needed.
+  virtual void bind(const Endpoint &endpoint) = 0;
+  // Lets several sockets bind the same port (must precede bind()).
+  virtual void enableReusePort() = 0;
+  virtual void listen() = 0;
+  // Returns nullptr when no connection was taken: the accept queue of a
+  // non-blocking socket is drained, or a blocking wait timed out or was
+  // interrupted. Failed accepts throw std::system_error with the errno
+  // value.
+  [[nodiscard]] virtual std::unique_ptr<ISocket> accept() = 0;
   virtual void close() = 0;
+  // For listeners whose descriptor was passed to another process: withdraws
+  // pending asynchronous accepts, and close() then leaves state shared with
+  // that process alone (e.g. a Unix socket file). Afterwards accept() only
+  // returns connections already taken off the queue, then nullptr. Call it
+  // on the thread that accepts.
+  virtual void handOff() = 0;
+
+  [[nodiscard]] virtual int nativeHandle() const noexcept = 0;
+  virtual void setNonBlocking() = 0;
+
+  // MSG_ZEROCOPY (Linux only, no-op elsewhere) for the connections accepted
+  // from now on: their sends of at least `minSize` bytes let the kernel read
+  // the caller's pages instead of copying them.
+  virtual void enableZeroCopy(std::size_t minSize) = 0;
+  // CPU locality (Linux only, no-op elsewhere). Attaches a reuseport program
+  // to the group this listener belongs to, so a connection is accepted by
+  // listener `cpuOwners[cpu]`, the one whose threads run on the CPU that
+  // received the packets; CPUs past the end of `cpuOwners` go to
+  // `cpu % listenersCount`. ISocket::incomingCpu() reports that CPU.
+  virtual void enableCpuSteering(std::size_t listenersCount,
+                                 std::span<const std::size_t> cpuOwners) = 0;
 };
 
 }  // namespace webserver::net
@@ -3,12 +3,30 @@
 #include <unistd.h>
 
 #include <memory>
+#include <stdexcept>
 
 #include "UnixSocket.h"
 
+#ifdef WEBSERVER_WITH_TLS
+  #include "TlsListener.h"
+#endif
+
+#ifdef __linux__
+  #include "IoUring.h"
+  #include "UringSocket.h"
+#endif
+
 namespace webserver::net {
 
-std::unique_ptr<ISocket> SocketFactory::newSocket() {
+std::unique_ptr<IListener> SocketFactory::newListener(
+    const config::SocketBackend backend) {
+#ifdef __linux__
+  if (backend == config::SocketBackend::IO_URING &&
+      isBackendSupported(backend)) {
+    return std::make_unique<UringSocket>();
+  }
+#endif
+
 #ifdef _POSIX_VERSION
   return std::make_unique<UnixSocket>();
 #else
@@ -16,4 +34,44 @@ std::unique_ptr<ISocket> SocketFactory::newSocket() {
 #endif
 }
 
+std::unique_ptr<IListener> SocketFactory::adopt(
+    const int fileDescriptor, const config::SocketBackend backend) {
+#ifdef __linux__
+  if (backend == config::SocketBackend::IO_URING &&
+      isBackendSupported(backend)) {
+    return std::make_unique<UringSocket>(
+        UnixSocket::fromNativeHandle(fileDescriptor));
+  }
+#endif
+
+  return UnixSocket::fromNativeHandle(fileDescriptor);
+}
+
+std::unique_ptr<IListener> SocketFactory::withTls(
+    [[maybe_unused]] std::unique_ptr<IListener> listener,
+    [[maybe_unused]] std::shared_ptr<TlsContext> context) {
+#ifdef WEBSERVER_WITH_TLS
+  return std::make_unique<TlsListener>(std::move(context),
+                                       std::move(listener));
+#else
+  throw std::runtime_error(TlsContext::lastError());
+#endif
+}
+
+bool SocketFactory::isBackendSupported(
+    const config::SocketBackend backend) noexcept {
+  switch (backend) {
+    case config::SocketBackend::POSIX:
+      return true;
+    case config::SocketBackend::IO_URING:
+#ifdef __linux__
+      return IoUring::isSupported();
+#else
+      return false;
+#endif
+  }
+
+  return false;
+}
+
 }  // namespace webserver::net
@@ -2,13 +2,28 @@
 
 #include <memory>
 
+#include "Config.h"
 #include "Socket.h"
+#include "TlsContext.h"
 
 namespace webserver::net {
 
 class SocketFactory {
  public:
-  [[nodiscard]] static std::unique_ptr<ISocket> newSocket();
+  [[nodiscard]] static std::unique_ptr<IListener> newListener(
+      config::SocketBackend backend = config::kDefaultSocketBackend);
+  // Wraps an open descriptor, e.g. a listener inherited from the previous
+  // server instance; the socket owns it from then on.
+  [[nodiscard]] static std::unique_ptr<IListener> adopt(
+      int fileDescriptor,
+      config::SocketBackend backend = config::kDefaultSocketBackend);
+  [[nodiscard]] static bool isBackendSupported(
+      config::SocketBackend backend) noexcept;
+  // Makes every connection `listener` accepts speak TLS. Throws
+  // std::runtime_error in builds without OpenSSL.
+  [[nodiscard]] static std::unique_ptr<IListener> withTls(
+      std::unique_ptr<IListener> listener,
+      std::shared_ptr<TlsContext> context);
 };
 
 }  // namespace webserver::net
@@ -0,0 +1,122 @@
+#include "TlsContext.h"
+
+#include <stdexcept>
+#include <string_view>
+
+#ifdef WEBSERVER_WITH_TLS
+  #include <openssl/err.h>
+  #include <openssl/ssl.h>
+
+  #include <array>
+#endif
+
+namespace webserver::net {
+
+#ifdef WEBSERVER_WITH_TLS
+
+constexpr std::string_view kSessionIdContext{"webserver"};
+constexpr long kSessionTimeoutSec = 2L * 60 * 60;
+
+TlsContext::TlsContext(const Options &options)
+    : _context{SSL_CTX_new(TLS_server_method())} {
+  if (_context == nullptr) {
+    throw std::runtime_error("Unable to create TLS context: " + lastError());
+  }
+
+  SSL_CTX_set_min_proto_version(_context, TLS1_2_VERSION);
+
+  if (SSL_CTX_use_certificate_chain_file(_context,
+                                         options.certificate.c_str()) != 1 ||
+      SSL_CTX_use_PrivateKey_file(_context, options.privateKey.c_str(),
+                                  SSL_FILETYPE_PEM) != 1 ||
+      SSL_CTX_check_private_key(_context) != 1) {
+    const auto error{lastError()};
+    SSL_CTX_free(_context);
+    throw std::runtime_error("Unable to load TLS certificate " +
+                             options.certificate.string() + ": " + error);
+  }
+
+  // Partial writes let non-blocking sends report progress record by record;
+  // a retried write may come from a different buffer holding the same bytes.
+  SSL_CTX_set_mode(_context, SSL_MODE_ENABLE_PARTIAL_WRITE |
+                                 SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                                 SSL_MODE_RELEASE_BUFFERS);
+
+  // Many clients just close the connection; treat that as an orderly end.
+  auto sslOptions{SSL_OP_IGNORE_UNEXPECTED_EOF | SSL_OP_NO_RENEGOTIATION |
+                  SSL_OP_CIPHER_SERVER_PREFERENCE};
+
+  if (options.kernelOffload) {
+    sslOptions |= SSL_OP_ENABLE_KTLS;
+  }
+  if (!options.sessionTickets) {
+    sslOptions |= SSL_OP_NO_TICKET;
+  }
+
+  SSL_CTX_set_options(_context, sslOptions);
+
+  SSL_CTX_set_session_cache_mode(_context, SSL_SESS_CACHE_SERVER);
+  SSL_CTX_set_session_id_context(
+      _context,
+      reinterpret_cast<const unsigned char *>(kSessionIdContext.data()),
+      kSessionIdContext.size());
+  SSL_CTX_set_timeout(_context, kSessionTimeoutSec);
+}
+
+TlsContext::~TlsContext() noexcept {
+  SSL_CTX_free(_context);
+}
+
+bool TlsContext::isSupported() noexcept {
+  return true;
+}
+
+std::string TlsContext::lastError() {
+  constexpr std::size_t kMessageSize = 256;
+
+  std::string message;
+  std::array<char, kMessageSize> buffer{};
+
+  while (const auto error{ERR_get_error()}) {
+    ERR_error_string_n(error, buffer.data(), buffer.size());
+
+    if (!message.empty()) {
+      message += "; ";
+    }
+    message += buffer.data();
+  }
+
+  return message.empty() ? "unknown error" : message;
+}
+
+#else
+
+TlsContext::TlsContext([[maybe_unused]] const Options &options) {
+  throw std::runtime_error("TLS requires a build with OpenSSL 3");
+}
+
+TlsContext::~TlsContext() noexcept = default;
+
+bool TlsContext::isSupported() noexcept {
+  return false;
+}
+
+std::string TlsContext::lastError() {
+  return "TLS support is not compiled in";
+}
+
+#endif  // WEBSERVER_WITH_TLS
+
+ssl_ctx_st *TlsContext::nativeHandle() const noexcept {
+  return _context;
+}
+
+TlsContext::Counters &TlsContext::counters() noexcept {
+  return _counters;
+}
+
+const TlsContext::Counters &TlsContext::counters() const noexcept {
+  return _counters;
+}
+
+}  // namespace webserver::net
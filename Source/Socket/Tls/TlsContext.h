@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+struct ssl_ctx_st;
+
+namespace webserver::net {
+
+// Server-side TLS configuration shared by every listener: certificate chain
+// and key, TLS 1.2 as the oldest protocol, session resumption and kernel TLS
+// offload. One context serves all shards, so a ticket issued by one listener
+// resumes on any other. Requires a build with OpenSSL 3
+// (WEBSERVER_WITH_TLS); otherwise constructing a context throws.
+class TlsContext {
+ public:
+  struct Options {
+    std::filesystem::path certificate;  // PEM, leaf first
+    std::filesystem::path privateKey;   // PEM
+    // Let OpenSSL install the session keys in the kernel (TCP_ULP "tls")
+    // once the handshake is done, so sendfile() and splice() keep working.
+    bool kernelOffload{true};
+    // Stateless session tickets; with them off only the server's session
+    // cache can resume a session.
+    bool sessionTickets{true};
+  };
+
+  struct Counters {
+    std::atomic<std::uint64_t> handshakes{0};
+    std::atomic<std::uint64_t> resumed{0};
+    std::atomic<std::uint64_t> kernelOffloaded{0};
+  };
+
+  // Throws std::runtime_error if the certificate or key cannot be loaded.
+  explicit TlsContext(const Options &options);
+
+  TlsContext(const TlsContext &) = delete;
+  TlsContext(TlsContext &&) = delete;
+  TlsContext &operator=(const TlsContext &) = delete;
+  TlsContext &operator=(TlsContext &&) = delete;
+  ~TlsContext() noexcept;
+
+  [[nodiscard]] static bool isSupported() noexcept;
+  // Drains the calling thread's OpenSSL error queue into a message.
+  [[nodiscard]] static std::string lastError();
+
+  [[nodiscard]] ssl_ctx_st *nativeHandle() const noexcept;
+  [[nodiscard]] Counters &counters() noexcept;
+  [[nodiscard]] const Counters &counters() const noexcept;
+
+ private:
+  ssl_ctx_st *_context{nullptr};
+  Counters _counters;
+};
+
+}  // namespace webserver::net
@@ -0,0 +1,65 @@
+#include "TlsListener.h"
+
+#ifdef WEBSERVER_WITH_TLS
+  #include <utility>
+
+  #include "TlsSocket.h"
+
+namespace webserver::net {
+
+TlsListener::TlsListener(std::shared_ptr<TlsContext> context,
+                         std::unique_ptr<IListener> listener)
+    : _context{std::move(context)}, _listener{std::move(listener)} {
+}
+
+void TlsListener::bind(const Endpoint &endpoint) {
+  _listener->bind(endpoint);
+}
+
+void TlsListener::enableReusePort() {
+  _listener->enableReusePort();
+}
+
+void TlsListener::listen() {
+  _listener->listen();
+}
+
+std::unique_ptr<ISocket> TlsListener::accept() {
+  auto clientSocket{_listener->accept()};
+
+  if (clientSocket == nullptr) {
+    return nullptr;
+  }
+
+  return std::make_unique<TlsSocket>(_context, std::move(clientSocket));
+}
+
+void TlsListener::close() {
+  _listener->close();
+}
+
+void TlsListener::handOff() {
+  _listener->handOff();
+}
+
+int TlsListener::nativeHandle() const noexcept {
+  return _listener->nativeHandle();
+}
+
+void TlsListener::setNonBlocking() {
+  _listener->setNonBlocking();
+}
+
+void TlsListener::enableZeroCopy([[maybe_unused]] const std::size_t minSize) {
+  // The wrapped listener is left without it, so accepted sockets are too.
+}
+
+void TlsListener::enableCpuSteering(
+    const std::size_t listenersCount,
+    const std::span<const std::size_t> cpuOwners) {
+  _listener->enableCpuSteering(listenersCount, cpuOwners);
+}
+
+}  // namespace webserver::net
+
+#endif  // WEBSERVER_WITH_TLS
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef WEBSERVER_WITH_TLS
+
+  #include <memory>
+
+  #include "Socket.h"
+  #include "TlsContext.h"
+
+namespace webserver::net {
+
+// Listener decorator that wraps every connection it accepts in a TlsSocket.
+// MSG_ZEROCOPY is never enabled: kernel TLS rejects it and user-space TLS
+// sends a copy anyway.
+class TlsListener final : public IListener {
+ public:
+  TlsListener(std::shared_ptr<TlsContext> context,
+              std::unique_ptr<IListener> listener);
+  TlsListener(const TlsListener &) = delete;
+  TlsListener(TlsListener &&) = delete;
+  TlsListener &operator=(const TlsListener &) = delete;
+  TlsListener &operator=(TlsListener &&) = delete;
+  ~TlsListener() override = default;
+
+  void bind(const Endpoint &endpoint) override;
+  void enableReusePort() override;
+  void listen() override;
+  [[nodiscard]] std::unique_ptr<ISocket> accept() override;
+  void close() override;
+  void handOff() override;
+
+  [[nodiscard]] int nativeHandle() const noexcept override;
+  void setNonBlocking() override;
+
+  void enableZeroCopy(std::size_t minSize) override;
+  void enableCpuSteering(std::size_t listenersCount,
+                         std::span<const std::size_t> cpuOwners) override;
+
+ private:
+  std::shared_ptr<TlsContext> _context;
+  std::unique_ptr<IListener> _listener;
+};
+
+}  // namespace webserver::net
+
+#endif  // WEBSERVER_WITH_TLS
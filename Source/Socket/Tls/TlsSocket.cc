@@ -0,0 +1,473 @@
+#include "TlsSocket.h"
+
+#ifdef WEBSERVER_WITH_TLS
+  #include <fcntl.h>
+  #include <openssl/err.h>
+  #include <openssl/ssl.h>
+  #include <poll.h>
+  #include <unistd.h>
+
+  #include <algorithm>
+  #include <cerrno>
+  #include <optional>
+  #include <stdexcept>
+  #include <string>
+
+namespace webserver::net {
+
+// Largest plaintext of one TLS record; user-space sends are cut to it.
+constexpr std::size_t kRecordSize = 16 * 1024;
+
+void TlsSocket::SessionDeleter::operator()(ssl_st *session) const noexcept {
+  SSL_free(session);
+}
+
+TlsSocket::TlsSocket(std::shared_ptr<TlsContext> context,
+                     std::unique_ptr<ISocket> socket)
+    : _context{std::move(context)}, _socket{std::move(socket)} {
+  _startSession();
+}
+
+TlsSocket::~TlsSocket() noexcept {
+  // A session freed without a shutdown is dropped from the server's cache;
+  // keep it resumable unless the connection failed.
+  if (_established && !_failed) {
+    SSL_set_shutdown(_session.get(), SSL_SENT_SHUTDOWN);
+  }
+}
+
+void TlsSocket::send(const std::string &data) {
+  _establish();
+
+  if (_kernelSend) {
+    _socket->send(data);
+    return;
+  }
+
+  _writeAll(data);
+}
+
+std::string TlsSocket::receive() {
+  // Workers do not expect receive() to throw: a failed handshake looks like
+  // a client that went away.
+  try {
+    _establish();
+  } catch (const std::exception &) {
+    _failed = true;
+    return {};
+  }
+
+  std::optional<std::chrono::steady_clock::time_point> requestDeadline;
+
+  while (!_receiveBuffer.hasCompleteRequest()) {
+    // Once part of a request is here, the rest has to arrive before the
+    // request deadline, however slowly the client trickles it in.
+    if (!_receiveBuffer.empty()) {
+      if (!requestDeadline.has_value()) {
+        requestDeadline = std::chrono::steady_clock::now() + _timeouts.request;
+      }
+
+      if (!_waitUntilReadable(requestDeadline.value())) {
+        static_cast<void>(_receiveBuffer.takeRequest());
+        throw http::RequestRejected{http::StatusCode::HTTP_408_REQUEST_TIMEOUT,
+                                    "request timed out"};
+      }
+    }
+
+    std::optional<std::size_t> bytesReceived;
+
+    try {
+      bytesReceived = _read(_receiveBuffer.prepareWrite());
+    } catch (const std::exception &) {
+      break;  // protocol error, _read() marked the session failed
+    }
+
+    if (!bytesReceived.has_value() || bytesReceived.value() == 0) {
+      break;  // peer closed or SO_RCVTIMEO expired
+    }
+
+    _receiveBuffer.commitWrite(bytesReceived.value());
+  }
+
+  auto received{_receiveBuffer.takeRequest()};
+  _receiveBuffer.release();
+  return received;
+}
+
+void TlsSocket::sendZeroCopyFile(std::filesystem::path filePath) {
+  sendFileWithHead({}, std::move(filePath));
+}
+
+void TlsSocket::sendVectored(const std::span<const std::string_view> parts) {
+  _establish();
+
+  if (_kernelSend) {
+    _socket->sendVectored(parts);
+    return;
+  }
+
+  // Encryption copies anyway; one buffer keeps the parts in shared records.
+  std::string data;
+
+  for (const auto part : parts) {
+    data += part;
+  }
+
+  _writeAll(data);
+}
+
+void TlsSocket::sendFileWithHead(const std::string_view head,
+                                 const std::filesystem::path filePath) {
+  _establish();
+
+  if (_kernelSend) {
+    _socket->sendFileWithHead(head, filePath);
+    return;
+  }
+
+  if (filePath.empty()) {
+    throw std::runtime_error("Empty file path");
+  }
+
+  const int fileFd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fileFd < 0) {
+    throw std::runtime_error("Failed to open file");
+  }
+
+  try {
+    // The head shares the first record with the start of the file.
+    std::string record{head};
+    std::int64_t offset{0};
+
+    while (true) {
+      if (record.size() < kRecordSize) {
+        const auto used{record.size()};
+        record.resize(kRecordSize);
+
+        const auto bytesRead{::pread(fileFd, record.data() + used,
+                                     kRecordSize - used,
+                                     static_cast<off_t>(offset))};
+
+        if (bytesRead < 0) {
+          throw std::runtime_error("Failed to read file");
+        }
+
+        record.resize(used + static_cast<std::size_t>(bytesRead));
+        offset += bytesRead;
+      }
+
+      if (record.empty()) {
+        break;
+      }
+
+      _writeAll(record);
+      record.clear();
+    }
+  } catch (...) {
+    ::close(fileFd);
+    throw;
+  }
+
+  ::close(fileFd);
+}
+
+void TlsSocket::close() {
+  if (_established && !_failed) {
+    // Best effort close_notify; the peer's reply is not awaited.
+    ERR_clear_error();
+    static_cast<void>(SSL_shutdown(_session.get()));
+  }
+
+  _socket->close();
+}
+
+void TlsSocket::setTimeouts(const SocketTimeouts &timeouts) {
+  _timeouts = timeouts;
+  _socket->setTimeouts(timeouts);  // SO_RCVTIMEO bounds the handshake too
+}
+
+void TlsSocket::setRequestLimits(const http::RequestLimits &limits) {
+  _receiveBuffer.setLimits(limits);
+}
+
+int TlsSocket::nativeHandle() const noexcept {
+  return _socket->nativeHandle();
+}
+
+void TlsSocket::setNonBlocking() {
+  _socket->setNonBlocking();
+  _nonBlocking = true;
+}
+
+std::optional<std::size_t> TlsSocket::receiveSome(
+    const std::span<char> buffer) {
+  if (!_completeHandshake()) {
+    return std::nullopt;
+  }
+
+  return _read(buffer);
+}
+
+std::optional<std::size_t> TlsSocket::sendSome(
+    const std::span<const char> data, const bool moreFollows) {
+  if (!_completeHandshake()) {
+    return std::nullopt;
+  }
+
+  if (_kernelSend) {
+    return _socket->sendSome(data, moreFollows);
+  }
+
+  return _writeSome(data);
+}
+
+std::optional<std::size_t> TlsSocket::sendFileSome(const int fileFd,
+                                                   std::int64_t &offset,
+                                                   const std::size_t count) {
+  if (!_completeHandshake()) {
+    return std::nullopt;
+  }
+
+  if (_kernelSend) {
+    return _socket->sendFileSome(fileFd, offset, count);
+  }
+
+  // A retry after a full socket buffer reads the same bytes again, which is
+  // what OpenSSL expects of a repeated write.
+  const auto bytesRead{_readFile(fileFd, offset, count)};
+
+  if (!bytesRead.has_value() || bytesRead.value() == 0) {
+    return bytesRead;
+  }
+
+  const auto bytesSent{
+      _writeSome(std::span{_fileBuffer}.first(bytesRead.value()))};
+
+  if (bytesSent.has_value()) {
+    offset += static_cast<std::int64_t>(bytesSent.value());
+  }
+
+  return bytesSent;
+}
+
+std::uint32_t TlsSocket::zeroCopyIssued() const noexcept {
+  return 0;
+}
+
+std::uint32_t TlsSocket::reapZeroCopyCompletions() {
+  return 0;
+}
+
+std::optional<int> TlsSocket::incomingCpu() const noexcept {
+  return _socket->incomingCpu();
+}
+
+std::optional<IpAddress> TlsSocket::peerAddress() const noexcept {
+  return _socket->peerAddress();
+}
+
+void TlsSocket::_startSession() {
+  _session.reset(SSL_new(_context->nativeHandle()));
+
+  if (_session == nullptr ||
+      SSL_set_fd(_session.get(), _socket->nativeHandle()) != 1) {
+    throw std::runtime_error("Unable to create TLS session: " +
+                             TlsContext::lastError());
+  }
+
+  SSL_set_accept_state(_session.get());
+}
+
+bool TlsSocket::_completeHandshake() {
+  if (_established) {
+    return true;
+  }
+
+  if (_failed) {
+    throw std::runtime_error("TLS session is not usable");
+  }
+
+  ERR_clear_error();
+  const auto result{SSL_do_handshake(_session.get())};
+
+  if (result == 1) {
+    _established = true;
+    _kernelSend = BIO_get_ktls_send(SSL_get_wbio(_session.get())) != 0;
+
+    auto &counters{_context->counters()};
+    counters.handshakes.fetch_add(1, std::memory_order_relaxed);
+    counters.resumed.fetch_add(SSL_session_reused(_session.get()) == 1 ? 1 : 0,
+                               std::memory_order_relaxed);
+    counters.kernelOffloaded.fetch_add(_kernelSend ? 1 : 0,
+                                       std::memory_order_relaxed);
+    return true;
+  }
+
+  const auto error{SSL_get_error(_session.get(), result)};
+
+  if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+    if (_nonBlocking) {
+      return false;
+    }
+
+    _failed = true;
+    throw std::runtime_error("TLS handshake timed out");
+  }
+
+  _failed = true;
+  throw std::runtime_error("TLS handshake failed: " + TlsContext::lastError());
+}
+
+void TlsSocket::_establish() {
+  // Blocking calls on a non-blocking socket wait for the peer here.
+  while (!_completeHandshake()) {
+    const auto deadline{std::chrono::steady_clock::now() + _timeouts.request};
+
+    if (SSL_want_write(_session.get()) != 0) {
+      _waitUntilWritable();
+    } else if (!_waitUntilReadable(deadline)) {
+      _failed = true;
+      throw std::runtime_error("TLS handshake timed out");
+    }
+  }
+}
+
+std::optional<std::size_t> TlsSocket::_read(const std::span<char> buffer) {
+  ERR_clear_error();
+
+  std::size_t bytesRead{0};
+  const auto result{
+      SSL_read_ex(_session.get(), buffer.data(), buffer.size(), &bytesRead)};
+
+  if (result == 1) {
+    return bytesRead;
+  }
+
+  switch (SSL_get_error(_session.get(), result)) {
+    case SSL_ERROR_WANT_READ:
+    case SSL_ERROR_WANT_WRITE:
+      return std::nullopt;  // drained, or SO_RCVTIMEO expired
+    case SSL_ERROR_ZERO_RETURN:
+      return 0;
+    case SSL_ERROR_SYSCALL:
+      _failed = true;
+
+      if (errno == ECONNRESET || errno == 0) {
+        return 0;  // treat reset as an orderly close
+      }
+
+      throw std::runtime_error("recv() failed");
+    default:
+      _failed = true;
+      throw std::runtime_error("TLS read failed: " + TlsContext::lastError());
+  }
+}
+
+std::optional<std::size_t> TlsSocket::_writeSome(
+    const std::span<const char> data) {
+  ERR_clear_error();
+
+  std::size_t bytesWritten{0};
+  const auto result{SSL_write_ex(_session.get(), data.data(),
+                                 std::min(data.size(), kRecordSize),
+                                 &bytesWritten)};
+
+  if (result == 1) {
+    return bytesWritten;
+  }
+
+  const auto error{SSL_get_error(_session.get(), result)};
+
+  if (error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ) {
+    return std::nullopt;
+  }
+
+  _failed = true;
+  throw std::runtime_error("TLS write failed: " + TlsContext::lastError());
+}
+
+void TlsSocket::_writeAll(std::span<const char> data) {
+  while (!data.empty()) {
+    const auto bytesWritten{_writeSome(data)};
+
+    if (!bytesWritten.has_value()) {
+      if (!_nonBlocking) {
+        _failed = true;
+        throw std::runtime_error("Timed out sending over TLS");
+      }
+
+      _waitUntilWritable();
+      continue;
+    }
+
+    data = data.subspan(bytesWritten.value());
+  }
+}
+
+std::optional<std::size_t> TlsSocket::_readFile(const int fileFd,
+                                                const std::int64_t offset,
+                                                const std::size_t count) {
+  _fileBuffer.resize(std::min(count, kRecordSize));
+
+  const auto bytesRead{::pread(fileFd, _fileBuffer.data(), _fileBuffer.size(),
+                               static_cast<off_t>(offset))};
+
+  if (bytesRead < 0) {
+    if (errno == EINTR) {
+      return std::nullopt;
+    }
+
+    throw std::runtime_error("Failed to read file");
+  }
+
+  return static_cast<std::size_t>(bytesRead);
+}
+
+void TlsSocket::_waitUntilWritable() const {
+  pollfd pollData{.fd = nativeHandle(), .events = POLLOUT, .revents = 0};
+
+  const auto pollResult{
+      ::poll(&pollData, 1, static_cast<int>(_timeouts.send.count()))};
+
+  if (pollResult == 0) {
+    throw std::runtime_error("Timed out waiting for socket to become writable");
+  }
+
+  if (pollResult < 0 && errno != EINTR) {
+    throw std::runtime_error("poll() failed");
+  }
+}
+
+bool TlsSocket::_waitUntilReadable(
+    const std::chrono::steady_clock::time_point deadline) const {
+  // Records OpenSSL has already decrypted do not show up on the socket.
+  if (SSL_has_pending(_session.get()) == 1) {
+    return true;
+  }
+
+  while (true) {
+    const auto remaining{std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now())};
+
+    if (remaining <= std::chrono::milliseconds::zero()) {
+      return false;
+    }
+
+    pollfd pollData{.fd = nativeHandle(), .events = POLLIN, .revents = 0};
+    const auto pollResult{
+        ::poll(&pollData, 1, static_cast<int>(remaining.count()))};
+
+    if (pollResult > 0) {
+      return true;  // data, hangup or error: SSL_read() reports which
+    }
+
+    if (pollResult < 0 && errno != EINTR) {
+      return false;
+    }
+  }
+}
+
+}  // namespace webserver::net
+
+#endif  // WEBSERVER_WITH_TLS
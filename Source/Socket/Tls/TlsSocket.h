@@ -0,0 +1,98 @@
+#pragma once
+
+#ifdef WEBSERVER_WITH_TLS
+
+  #include <chrono>
+  #include <memory>
+  #include <vector>
+
+  #include "RequestBuffer.h"
+  #include "Socket.h"
+  #include "TlsContext.h"
+
+struct ssl_st;
+
+namespace webserver::net {
+
+// ISocket decorator that speaks TLS over an accepted connection (see
+// TlsListener). The handshake runs on the first read or write, blocking on
+// blocking sockets and spread over readiness events on non-blocking ones.
+// Once it completes, OpenSSL tries to hand the session keys to the kernel
+// (kTLS). With kernel offload for sends, writes, sendfile() and splice() go
+// straight to the wrapped socket and the kernel frames and encrypts the
+// records, so files stay zero-copy; without it records are encrypted in user
+// space and files go through a bounce buffer. Reads always go through
+// OpenSSL, which also drives kernel-side decryption. MSG_ZEROCOPY is never
+// used on TLS connections.
+class TlsSocket final : public ISocket {
+ public:
+  TlsSocket(std::shared_ptr<TlsContext> context,
+            std::unique_ptr<ISocket> socket);
+  TlsSocket(const TlsSocket &) = delete;
+  TlsSocket(TlsSocket &&) = delete;
+  TlsSocket &operator=(const TlsSocket &) = delete;
+  TlsSocket &operator=(TlsSocket &&) = delete;
+  ~TlsSocket() noexcept override;
+
+  void send(const std::string &data) override;
+  [[nodiscard]] std::string receive() override;
+  void sendZeroCopyFile(std::filesystem::path filePath) override;
+  void sendVectored(std::span<const std::string_view> parts) override;
+  void sendFileWithHead(std::string_view head,
+                        std::filesystem::path filePath) override;
+  void close() override;
+  void setTimeouts(const SocketTimeouts &timeouts) override;
+  void setRequestLimits(const http::RequestLimits &limits) override;
+
+  [[nodiscard]] int nativeHandle() const noexcept override;
+  void setNonBlocking() override;
+  [[nodiscard]] std::optional<std::size_t> receiveSome(
+      std::span<char> buffer) override;
+  [[nodiscard]] std::optional<std::size_t> sendSome(
+      std::span<const char> data, bool moreFollows) override;
+  [[nodiscard]] std::optional<std::size_t> sendFileSome(
+      int fileFd, std::int64_t &offset, std::size_t count) override;
+
+  [[nodiscard]] std::uint32_t zeroCopyIssued() const noexcept override;
+  [[nodiscard]] std::uint32_t reapZeroCopyCompletions() override;
+  [[nodiscard]] std::optional<int> incomingCpu() const noexcept override;
+  [[nodiscard]] std::optional<IpAddress> peerAddress()
+      const noexcept override;
+
+ private:
+  struct SessionDeleter {
+    void operator()(ssl_st *session) const noexcept;
+  };
+
+  void _startSession();
+  // Advances a pending handshake. Returns false while a non-blocking socket
+  // waits for the peer; throws if the handshake fails or, on a blocking
+  // socket, times out.
+  [[nodiscard]] bool _completeHandshake();
+  void _establish();
+  [[nodiscard]] std::optional<std::size_t> _read(std::span<char> buffer);
+  [[nodiscard]] std::optional<std::size_t> _writeSome(
+      std::span<const char> data);
+  void _writeAll(std::span<const char> data);
+  [[nodiscard]] std::optional<std::size_t> _readFile(int fileFd,
+                                                     std::int64_t offset,
+                                                     std::size_t count);
+  void _waitUntilWritable() const;
+  [[nodiscard]] bool _waitUntilReadable(
+      std::chrono::steady_clock::time_point deadline) const;
+
+  std::shared_ptr<TlsContext> _context;
+  std::unique_ptr<ISocket> _socket;
+  std::unique_ptr<ssl_st, SessionDeleter> _session;
+  bool _established{false};
+  bool _failed{false};  // no close_notify after a fatal error
+  bool _kernelSend{false};
+  bool _nonBlocking{false};
+  http::RequestBuffer _receiveBuffer;
+  std::vector<char> _fileBuffer;  // plaintext file data without kTLS
+  SocketTimeouts _timeouts;
+};
+
+}  // namespace webserver::net
+
+#endif  // WEBSERVER_WITH_TLS
@@ -0,0 +1,27 @@
+#include "ServerStats.h"
+
+#include <fmt/core.h>
+
+namespace webserver::core {
+
+std::string ServerStats::format() const {
+  constexpr auto kPercent = 100.0;
+
+  const auto hits{localityHits.load(std::memory_order_relaxed)};
+  const auto misses{localityMisses.load(std::memory_order_relaxed)};
+  const auto sampled{hits + misses};
+
+  auto result{fmt::format("accepted={}",
+                          acceptedConnections.load(std::memory_order_relaxed))};
+
+  if (sampled > 0) {
+    result += fmt::format(" locality_hits={} locality_misses={} ({:.1f}%)",
+                          hits, misses,
+                          kPercent * static_cast<double>(hits) /
+                              static_cast<double>(sampled));
+  }
+
+  return result;
+}
+
+}  // namespace webserver::core
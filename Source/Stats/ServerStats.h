@@ -0,0 +1,21 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace webserver::core {
+
+// Process-wide counters, updated with relaxed atomics from the hot path and
+// periodically printed by the server.
+struct ServerStats {
+  std::atomic<std::uint64_t> acceptedConnections{0};
+  // Connections whose packets were processed on a CPU owned by the shard
+  // that accepted them (SO_INCOMING_CPU).
+  std::atomic<std::uint64_t> localityHits{0};
+  std::atomic<std::uint64_t> localityMisses{0};
+
+  [[nodiscard]] std::string format() const;
+};
+
+}  // namespace webserver::core
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace webserver::core {
+
+// Scheduling class of a pool task. Interactive work (pages, API calls) is
+// preferred by weight; bulk work (large downloads, uploads) gets its share
+// but can never take the workers kept free for interactive tasks.
+enum class Lane : std::uint8_t { INTERACTIVE, BULK };
+
+constexpr std::size_t kLanesCount = 2;
+
+}  // namespace webserver::core
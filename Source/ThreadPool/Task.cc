@@ -0,0 +1,50 @@
+#include "Task.h"
+
+#include <stdexcept>
+
+namespace webserver::core {
+
+Task::Task(Task &&other) noexcept : _operations{other._operations} {
+  if (_operations != nullptr) {
+    _operations->relocate(other._storage, _storage);
+    other._operations = nullptr;
+  }
+}
+
+Task &Task::operator=(Task &&other) noexcept {
+  if (this != &other) {
+    _reset();
+
+    if (other._operations != nullptr) {
+      other._operations->relocate(other._storage, _storage);
+      _operations = std::exchange(other._operations, nullptr);
+    }
+  }
+
+  return *this;
+}
+
+Task::~Task() {
+  _reset();
+}
+
+void Task::operator()() {
+  if (_operations == nullptr) {
+    throw std::logic_error("Empty task invoked");
+  }
+
+  _operations->invoke(_storage);
+}
+
+Task::operator bool() const noexcept {
+  return _operations != nullptr;
+}
+
+void Task::_reset() noexcept {
+  if (_operations != nullptr) {
+    _operations->destroy(_storage);
+    _operations = nullptr;
+  }
+}
+
+}  // namespace webserver::core
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace webserver::core {
+
+// Move-only type-erased `void()` callable for the thread pool. Callables of
+// up to kInlineSize bytes that move without throwing live inside the task
+// itself, so submitting e.g. a lambda holding a socket, an admission permit
+// and `this` allocates nothing; larger ones fall back to the heap. Unlike
+// std::function it accepts move-only captures and needs no shared state.
+class Task {
+ public:
+  static constexpr std::size_t kInlineSize = 48;
+
+  Task() noexcept = default;
+
+  template <class F>
+    requires(!std::same_as<std::decay_t<F>, Task> &&
+             std::invocable<std::decay_t<F> &>)
+  explicit Task(F &&func) {
+    using Callable = std::decay_t<F>;
+
+    if constexpr (storesInline<Callable>()) {
+      ::new (static_cast<void *>(_storage)) Callable(std::forward<F>(func));
+      _operations = &kInlineOperations<Callable>;
+    } else {
+      ::new (static_cast<void *>(_storage))
+          Callable *(new Callable(std::forward<F>(func)));
+      _operations = &kHeapOperations<Callable>;
+    }
+  }
+
+  Task(const Task &) = delete;
+  Task(Task &&other) noexcept;
+  Task &operator=(const Task &) = delete;
+  Task &operator=(Task &&other) noexcept;
+  ~Task();
+
+  // Runs the callable; the task must not be empty.
+  void operator()();
+  [[nodiscard]] explicit operator bool() const noexcept;
+
+  template <class F>
+  [[nodiscard]] static constexpr bool storesInline() noexcept {
+    return sizeof(F) <= kInlineSize &&
+           alignof(F) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<F>;
+  }
+
+ private:
+  struct Operations {
+    void (*invoke)(void *storage);
+    // Move-constructs into `to` and destroys the source.
+    void (*relocate)(void *from, void *to) noexcept;
+    void (*destroy)(void *storage) noexcept;
+  };
+
+  template <class F>
+  static constexpr Operations kInlineOperations{
+      .invoke =
+          [](void *storage) {
+            (*std::launder(static_cast<F *>(storage)))();
+          },
+      .relocate =
+          [](void *from, void *to) noexcept {
+            auto *source{std::launder(static_cast<F *>(from))};
+            ::new (to) F(std::move(*source));
+            source->~F();
+          },
+      .destroy =
+          [](void *storage) noexcept {
+            std::launder(static_cast<F *>(storage))->~F();
+          }};
+
+  template <class F>
+  static constexpr Operations kHeapOperations{
+      .invoke = [](void *storage) { (**static_cast<F **>(storage))(); },
+      .relocate =
+          [](void *from, void *to) noexcept {
+            ::new (to) F *(*static_cast<F **>(from));
+          },
+      .destroy =
+          [](void *storage) noexcept { delete *static_cast<F **>(storage); }};
+
+  void _reset() noexcept;
+
+  alignas(std::max_align_t) std::byte _storage[kInlineSize];  // NOLINT
+  const Operations *_operations{nullptr};
+};
+
+}  // namespace webserver::core
@@ -1,12 +1,58 @@
 #include "ThreadPool.h"
 
+#include <algorithm>
 #include <mutex>
 
 namespace webserver::core {
 
-ThreadPool::ThreadPool(const int threadsCount) {
-  for (int i = 0; i < threadsCount; ++i) {
-    _workers.emplace_back([this] { this->_worker(); });
+constexpr std::size_t kQueueCapacity = 1024;
+// Rounds an idle worker re-checks the queues, yielding in between, before
+// it parks. Short bursts are picked up without a futex round trip.
+constexpr auto kSpinRounds = 64;
+
+namespace {
+
+// Pool and queue of the worker running on this thread, if any, and how
+// many tasks it took: the position in its weighted round over the lanes.
+thread_local const ThreadPool *currentPool{nullptr};
+thread_local std::size_t currentQueue{0};
+thread_local std::size_t laneTurn{0};
+
+constexpr std::array kInteractiveFirst{Lane::INTERACTIVE, Lane::BULK};
+constexpr std::array kBulkFirst{Lane::BULK, Lane::INTERACTIVE};
+
+ThreadPool::Clock::rep ticks(const ThreadPool::Clock::time_point time) {
+  return time.time_since_epoch().count();
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(const int threadsCount,
+                       const std::function<void(int)> &onWorkerStart)
+    : ThreadPool{Options{.minThreads = threadsCount,
+                         .maxThreads = threadsCount},
+                 onWorkerStart} {
+}
+
+ThreadPool::ThreadPool(const Options &options,
+                       const std::function<void(int)> &onWorkerStart)
+    : _options{_validated(options)},
+      _onWorkerStart{onWorkerStart},
+      _queuesReady{_options.minThreads} {
+  _lastProgress.store(ticks(Clock::now()), std::memory_order_relaxed);
+
+  for (int i = 0; i < _options.maxThreads; ++i) {
+    _slots.push_back(std::make_unique<Slot>());
+  }
+  for (int i = 0; i < _options.minThreads; ++i) {
+    _startWorker(static_cast<std::size_t>(i), true);
+  }
+
+  _queuesReady.wait();
+
+  if (_isElastic()) {
+    _supervisor = std::jthread{
+        [this](const std::stop_token &stopToken) { _supervise(stopToken); }};
   }
 }
 
@@ -15,41 +61,392 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::stop() {
-  {
-    std::lock_guard<std::mutex> lock{_queueMutex};
+  // Nobody may start or retire workers behind the joins below.
+  if (_supervisor.joinable()) {
+    _supervisor.request_stop();
+    _supervisor.join();
+  }
 
-    if (_stop) {
-      return;
+  if (_stop.exchange(true)) {
+    return;
+  }
+
+  _wakeEpoch.fetch_add(1, std::memory_order_release);
+  _wakeEpoch.notify_all();
+
+  for (auto &slot : _slots) {
+    if (slot->thread.joinable()) {
+      slot->thread.join();
     }
+  }
+}
 
-    _stop = true;
+std::size_t ThreadPool::size() const noexcept {
+  return _liveWorkers.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ThreadPool::grownCount() const noexcept {
+  return _grown.load(std::memory_order_relaxed);
+}
+
+std::uint64_t ThreadPool::retiredCount() const noexcept {
+  return _retired.load(std::memory_order_relaxed);
+}
+
+ThreadPool::Options ThreadPool::_validated(const Options &options) {
+  if (options.minThreads <= 0) {
+    throw std::invalid_argument("ThreadPool needs at least one worker");
+  }
+  if (options.maxThreads < options.minThreads) {
+    throw std::invalid_argument(
+        "ThreadPool maximum size is below its minimum");
+  }
+  if (options.maxThreads > options.minThreads &&
+      options.growDelay <= std::chrono::milliseconds::zero()) {
+    throw std::invalid_argument("ThreadPool grow delay must be positive");
+  }
+  if (options.interactiveWeight <= 0 || options.bulkWeight <= 0 ||
+      options.interactiveReserve < 0) {
+    throw std::invalid_argument(
+        "ThreadPool lane weights must be positive, the reserve not negative");
   }
 
-  _condition.notify_all();
+  return options;
+}
+
+bool ThreadPool::_isElastic() const noexcept {
+  return _options.maxThreads > _options.minThreads;
+}
 
-  for (auto &worker : _workers) {
-    worker.join();
+void ThreadPool::_startWorker(const std::size_t index, const bool initial) {
+  auto &slot{*_slots[index]};
+
+  slot.live.store(true, std::memory_order_relaxed);
+  _liveWorkers.fetch_add(1, std::memory_order_relaxed);
+  slot.thread =
+      std::thread{[this, index, initial] { _worker(index, initial); }};
+}
+
+void ThreadPool::_submit(const Lane lane, Task task) {
+  if (_stop.load(std::memory_order_acquire)) {
+    throw std::runtime_error("Enqueue on stopped ThreadPool");
+  }
+
+  const auto laneIndex{static_cast<std::size_t>(lane)};
+  QueuedTask queued{.task = std::move(task), .queuedAt = {}, .lane = lane};
+
+  if (_isElastic()) {
+    queued.queuedAt = Clock::now();
+
+    // Waiting time only counts from here when the pool had nothing to do.
+    if (_pendingTasks.fetch_add(1, std::memory_order_relaxed) == 0) {
+      _lastProgress.store(ticks(queued.queuedAt), std::memory_order_relaxed);
+    }
+  }
+
+  const auto slotsCount{_slots.size()};
+  const auto first{currentPool == this
+                       ? currentQueue
+                       : _nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                             slotsCount};
+  auto pushed{false};
+
+  for (std::size_t i = 0; i < slotsCount && !pushed; ++i) {
+    auto *queue{_slots[(first + i) % slotsCount]->queues[laneIndex].load(
+        std::memory_order_acquire)};
+    pushed = queue != nullptr && queue->tryPush(std::move(queued));
+  }
+
+  if (!pushed) {
+    std::lock_guard<std::mutex> lock{_overflowMutex};
+    _overflow[laneIndex].push(std::move(queued));
+    _overflowSize[laneIndex].fetch_add(1, std::memory_order_release);
+  }
+
+  // Pairs with the fence in _waitForWork(): either the parking worker sees
+  // this task, or this thread sees the worker parked and wakes it.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (_parkedWorkers.load(std::memory_order_relaxed) > 0) {
+    _wakeOne();
   }
 }
 
-void ThreadPool::_worker() {
+void ThreadPool::_worker(const std::size_t index, const bool initial) {
+  if (_onWorkerStart) {
+    _onWorkerStart(static_cast<int>(index));
+  }
+
+  // First touch happens here, after pinning: the rings are placed on the
+  // worker's node. Slots that never ran a worker are skipped by everyone.
+  auto &slot{*_slots[index]};
+
+  for (std::size_t lane = 0; lane < kLanesCount; ++lane) {
+    if (slot.queues[lane].load(std::memory_order_acquire) == nullptr) {
+      slot.storage[lane] = std::make_unique<Queue>(kQueueCapacity);
+      slot.queues[lane].store(slot.storage[lane].get(),
+                              std::memory_order_release);
+    }
+  }
+  if (initial) {
+    _queuesReady.count_down();
+  }
+
+  currentPool = this;
+  currentQueue = index;
+
   while (true) {
-    std::function<void()> task;
+    if (auto queued{_findTask(index)}) {
+      queued->task();
+
+      if (queued->lane == Lane::BULK) {
+        _runningBulk.fetch_sub(1, std::memory_order_relaxed);
+      }
+      continue;
+    }
+
+    if (_claimRetirement(index) || !_waitForWork()) {
+      return;
+    }
+  }
+}
+
+std::optional<ThreadPool::QueuedTask> ThreadPool::_findTask(
+    const std::size_t index) {
+  const auto round{static_cast<std::size_t>(_options.interactiveWeight +
+                                            _options.bulkWeight)};
+  const auto bulkTurn{laneTurn % round >=
+                      static_cast<std::size_t>(_options.interactiveWeight)};
+
+  // The lane whose turn it is goes first; the other one is taken rather
+  // than leaving the worker idle.
+  for (const auto lane : bulkTurn ? kBulkFirst : kInteractiveFirst) {
+    if (lane == Lane::BULK &&
+        (!_laneHasWork(Lane::BULK) || !_tryStartBulk())) {
+      continue;
+    }
+
+    if (auto queued{_popFrom(index, lane)}) {
+      ++laneTurn;
+      _recordTaken(*queued);
+      return queued;
+    }
+
+    if (lane == Lane::BULK) {
+      _runningBulk.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
 
+  return std::nullopt;
+}
+
+std::optional<ThreadPool::QueuedTask> ThreadPool::_popFrom(
+    const std::size_t index, const Lane lane) {
+  // Own queue first, then steal, starting with the next worker's queue so
+  // thieves spread out instead of all raiding the same victim.
+  const auto laneIndex{static_cast<std::size_t>(lane)};
+  const auto slotsCount{_slots.size()};
+
+  for (std::size_t i = 0; i < slotsCount; ++i) {
+    auto *queue{_slots[(index + i) % slotsCount]->queues[laneIndex].load(
+        std::memory_order_acquire)};
+
+    if (queue == nullptr) {
+      continue;
+    }
+    if (auto queued{queue->tryPop()}) {
+      return queued;
+    }
+  }
+
+  if (_overflowSize[laneIndex].load(std::memory_order_acquire) > 0) {
+    std::lock_guard<std::mutex> lock{_overflowMutex};
+    auto &overflow{_overflow[laneIndex]};
+
+    if (!overflow.empty()) {
+      auto queued{std::move(overflow.front())};
+      overflow.pop();
+      _overflowSize[laneIndex].fetch_sub(1, std::memory_order_relaxed);
+      return queued;
+    }
+  }
+
+  return std::nullopt;
+}
+
+void ThreadPool::_recordTaken(const QueuedTask &queued) noexcept {
+  if (!_isElastic()) {
+    return;
+  }
+
+  const auto now{Clock::now()};
+  const auto waited{(now - queued.queuedAt).count()};
+  auto recent{_recentDelay.load(std::memory_order_relaxed)};
+
+  _pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+  _lastProgress.store(ticks(now), std::memory_order_relaxed);
+
+  while (waited > recent && !_recentDelay.compare_exchange_weak(
+                                recent, waited, std::memory_order_relaxed)) {
+  }
+}
+
+bool ThreadPool::_hasWork() const noexcept {
+  // Bulk tasks only count while there is a worker left to run them;
+  // otherwise idle workers would spin on work they may not take.
+  return _laneHasWork(Lane::INTERACTIVE) ||
+         (_laneHasWork(Lane::BULK) &&
+          _runningBulk.load(std::memory_order_relaxed) < _bulkLimit());
+}
+
+bool ThreadPool::_laneHasWork(const Lane lane) const noexcept {
+  const auto laneIndex{static_cast<std::size_t>(lane)};
+
+  for (const auto &slot : _slots) {
+    const auto *queue{slot->queues[laneIndex].load(std::memory_order_acquire)};
+
+    if (queue != nullptr && queue->hasWork()) {
+      return true;
+    }
+  }
+
+  return _overflowSize[laneIndex].load(std::memory_order_acquire) > 0;
+}
+
+bool ThreadPool::_tryStartBulk() noexcept {
+  const auto limit{_bulkLimit()};
+  auto running{_runningBulk.load(std::memory_order_relaxed)};
+
+  do {
+    if (running >= limit) {
+      return false;
+    }
+  } while (!_runningBulk.compare_exchange_weak(running, running + 1,
+                                               std::memory_order_relaxed));
+
+  return true;
+}
+
+std::size_t ThreadPool::_bulkLimit() const noexcept {
+  const auto live{_liveWorkers.load(std::memory_order_relaxed)};
+  const auto reserve{static_cast<std::size_t>(_options.interactiveReserve)};
+
+  return live > reserve ? live - reserve : 1;
+}
+
+bool ThreadPool::_waitForWork() {
+  const auto mustWake{[this] {
+    return _hasWork() || _stop.load(std::memory_order_acquire) ||
+           _retireRequests.load(std::memory_order_relaxed) > 0;
+  }};
+
+  for (int round = 0; round < kSpinRounds; ++round) {
+    if (mustWake()) {
+      return _hasWork() || !_stop.load(std::memory_order_acquire);
+    }
+
+    std::this_thread::yield();
+  }
+
+  const auto epoch{_wakeEpoch.load(std::memory_order_acquire)};
+  _parkedWorkers.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (!mustWake()) {
+    _wakeEpoch.wait(epoch, std::memory_order_acquire);
+  }
+
+  _parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+  return _hasWork() || !_stop.load(std::memory_order_acquire);
+}
+
+bool ThreadPool::_claimRetirement(const std::size_t index) noexcept {
+  auto requests{_retireRequests.load(std::memory_order_relaxed)};
+
+  do {
+    if (requests == 0) {
+      return false;
+    }
+  } while (!_retireRequests.compare_exchange_weak(requests, requests - 1,
+                                                  std::memory_order_relaxed));
+
+  // The thread object stays in the slot until it is reused or the pool
+  // stops; both join it.
+  _liveWorkers.fetch_sub(1, std::memory_order_relaxed);
+  _retired.fetch_add(1, std::memory_order_relaxed);
+  _slots[index]->live.store(false, std::memory_order_release);
+  return true;
+}
+
+void ThreadPool::_supervise(const std::stop_token &stopToken) {
+  auto idleSince{Clock::now()};
+
+  while (true) {
     {
-      std::unique_lock lock{_queueMutex};
-      _condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+      std::unique_lock<std::mutex> lock{_supervisorMutex};
+      static_cast<void>(_supervisorWake.wait_for(
+          lock, stopToken, _options.growDelay, [] { return false; }));
+    }
 
-      if (_stop && _tasks.empty()) {
-        return;
-      }
+    if (stopToken.stop_requested()) {
+      return;
+    }
+
+    const auto now{Clock::now()};
+    auto waited{Clock::duration{
+        _recentDelay.exchange(0, std::memory_order_relaxed)}};
+
+    // Tasks still queued may have been waiting even longer, e.g. while every
+    // worker is blocked and nothing gets taken at all.
+    if (_pendingTasks.load(std::memory_order_relaxed) > 0) {
+      waited = std::max(
+          waited, now - Clock::time_point{Clock::duration{_lastProgress.load(
+                            std::memory_order_relaxed)}});
+    }
+
+    const auto parked{_parkedWorkers.load(std::memory_order_relaxed)};
+    const auto live{_liveWorkers.load(std::memory_order_relaxed)};
+    const auto minThreads{static_cast<std::size_t>(_options.minThreads)};
+    const auto maxThreads{static_cast<std::size_t>(_options.maxThreads)};
 
-      task = std::move(_tasks.front());
-      _tasks.pop();
+    if (waited >= _options.growDelay && parked == 0 && live < maxThreads) {
+      _grow();
+      idleSince = now;
+    } else if (parked == 0) {
+      idleSince = now;
+    } else if (now - idleSince >= _options.shrinkDelay &&
+               live - _retireRequests.load(std::memory_order_relaxed) >
+                   minThreads) {
+      _retireRequests.fetch_add(1, std::memory_order_relaxed);
+      _wakeOne();
+      idleSince = now;
     }
+  }
+}
+
+void ThreadPool::_grow() {
+  // The pool is saturated: retirements asked for earlier no longer apply.
+  _retireRequests.store(0, std::memory_order_relaxed);
 
-    task();
+  for (std::size_t i = 0; i < _slots.size(); ++i) {
+    auto &slot{*_slots[i]};
+
+    if (slot.live.load(std::memory_order_acquire)) {
+      continue;
+    }
+    if (slot.thread.joinable()) {
+      slot.thread.join();  // a retired worker, already on its way out
+    }
+
+    _startWorker(i, false);
+    _grown.fetch_add(1, std::memory_order_relaxed);
+    return;
   }
 }
 
+void ThreadPool::_wakeOne() noexcept {
+  _wakeEpoch.fetch_add(1, std::memory_order_release);
+  _wakeEpoch.notify_one();
+}
+
 }  // namespace webserver::core
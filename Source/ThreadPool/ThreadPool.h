@@ -1,20 +1,72 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <future>
+#include <latch>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <stdexcept>
+#include <stop_token>
 #include <thread>
 #include <type_traits>
 #include <vector>
 
+#include "Lane.h"
+#include "Task.h"
+#include "WorkQueue.h"
+
 namespace webserver::core {
 
+// Work-stealing pool. Every worker owns a lock-free queue; tasks submitted by
+// a worker go to its own queue, others are spread round-robin. A worker runs
+// its own tasks first and steals from the other queues when it runs dry, so
+// no lock is taken while any queue has room. Idle workers spin briefly, then
+// park on an atomic wait, and are only woken when someone is parked.
+//
+// That holds per lane (see Lane): every worker has one queue for each.
+// Workers take from the lanes by weighted round-robin, so neither can starve
+// the other, and bulk tasks never occupy the workers reserved for
+// interactive ones.
+//
+// An elastic pool sizes itself between a minimum and a maximum: a supervisor
+// thread adds a worker while queued tasks wait too long to start and retires
+// one once workers have been idle for a while.
 class ThreadPool {
  public:
-  explicit ThreadPool(int threadsCount);
+  using Clock = std::chrono::steady_clock;
+
+  // minThreads == maxThreads gives a fixed pool. Otherwise a worker is added
+  // when a task waited growDelay or longer to start and no worker is idle,
+  // and one is retired after some worker was idle for shrinkDelay.
+  // While both lanes have work, a worker takes interactiveWeight interactive
+  // tasks for every bulkWeight bulk ones. Bulk tasks run on at most all but
+  // interactiveReserve workers (on one at least).
+  struct Options {
+    int minThreads{1};
+    int maxThreads{1};
+    std::chrono::milliseconds growDelay{50};
+    std::chrono::milliseconds shrinkDelay{30000};
+    int interactiveWeight{8};
+    int bulkWeight{1};
+    int interactiveReserve{1};
+  };
+
+  // onWorkerStart, if set, runs first on every worker thread with its index
+  // (used e.g. to pin workers to CPUs). Each worker allocates its own queue
+  // after that, so a pinned worker's queue lives on its NUMA node; the
+  // constructor returns once the initial workers' queues exist.
+  explicit ThreadPool(int threadsCount,
+                      const std::function<void(int)> &onWorkerStart = {});
+  explicit ThreadPool(const Options &options,
+                      const std::function<void(int)> &onWorkerStart = {});
 
   ThreadPool(const ThreadPool &) = delete;
   ThreadPool(ThreadPool &&) = delete;
@@ -27,34 +79,110 @@ class ThreadPool {
       -> std::future<std::invoke_result_t<F, Args...>> {
     using returnType = std::invoke_result_t<F, Args...>;
 
-    auto taskPtr = std::make_shared<std::packaged_task<returnType()>>(
-        std::bind(std::forward<F>(func), std::forward<Args>(args)...));
-
-    {
-      std::lock_guard<std::mutex> lock(_queueMutex);
+    std::packaged_task<returnType()> task{
+        std::bind(std::forward<F>(func), std::forward<Args>(args)...)};
+    auto future{task.get_future()};
 
-      if (_stop) {
-        throw std::runtime_error("Enqueue on stopped ThreadPool");
-      }
-
-      _tasks.emplace([taskPtr]() { (*taskPtr)(); });
-    }
+    _submit(Lane::INTERACTIVE, Task{std::move(task)});
+    return future;
+  }
 
-    _condition.notify_one();
-    return taskPtr->get_future();
+  // Fire-and-forget counterpart of enqueue(): no future, no shared state.
+  // Callables that fit Task's inline storage are queued without allocating.
+  // Nothing catches for the caller: an exception escaping `func` terminates
+  // the process, as it would on a std::thread.
+  template <class F>
+  void submit(F &&func) {
+    _submit(Lane::INTERACTIVE, Task{std::forward<F>(func)});
+  }
+  template <class F>
+  void submit(const Lane lane, F &&func) {
+    _submit(lane, Task{std::forward<F>(func)});
   }
 
+  // Runs what is already queued, then joins the workers.
   void stop();
 
+  // Workers currently running, and how many an elastic pool has added and
+  // retired so far.
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] std::uint64_t grownCount() const noexcept;
+  [[nodiscard]] std::uint64_t retiredCount() const noexcept;
+
  private:
-  void _worker();
+  struct QueuedTask {
+    Task task;
+    Clock::time_point queuedAt;  // only stamped by elastic pools
+    Lane lane{Lane::INTERACTIVE};
+  };
+
+  using Queue = WorkQueue<QueuedTask>;
+
+  // Place of one worker. Its queues, one per lane, are allocated by the
+  // first worker started in the slot and kept when that worker retires: the
+  // others steal what is left in them, and the next worker started in the
+  // slot takes them over.
+  struct Slot {
+    std::array<std::unique_ptr<Queue>, kLanesCount> storage;
+    std::array<std::atomic<Queue *>, kLanesCount> queues{};
+    std::atomic<bool> live{false};
+    std::thread thread;
+  };
+
+  [[nodiscard]] static Options _validated(const Options &options);
+  [[nodiscard]] bool _isElastic() const noexcept;
+  void _startWorker(std::size_t index, bool initial);
+  void _submit(Lane lane, Task task);
+  void _worker(std::size_t index, bool initial);
+  [[nodiscard]] std::optional<QueuedTask> _findTask(std::size_t index);
+  [[nodiscard]] std::optional<QueuedTask> _popFrom(std::size_t index,
+                                                   Lane lane);
+  void _recordTaken(const QueuedTask &queued) noexcept;
+  [[nodiscard]] bool _hasWork() const noexcept;
+  [[nodiscard]] bool _laneHasWork(Lane lane) const noexcept;
+  // Reserves a worker for a bulk task; false while bulk tasks already run
+  // on every worker they may use.
+  [[nodiscard]] bool _tryStartBulk() noexcept;
+  [[nodiscard]] std::size_t _bulkLimit() const noexcept;
+  // Spins, then parks until work arrives. False once the pool is stopped
+  // and everything queued has been taken.
+  [[nodiscard]] bool _waitForWork();
+  // An idle worker takes up a pending retirement, if any, and must exit.
+  [[nodiscard]] bool _claimRetirement(std::size_t index) noexcept;
+  void _supervise(const std::stop_token &stopToken);
+  void _grow();
+  void _wakeOne() noexcept;
+
+  const Options _options;
+  const std::function<void(int)> _onWorkerStart;
+  std::vector<std::unique_ptr<Slot>> _slots;
+  std::latch _queuesReady;
+  std::atomic<std::size_t> _nextQueue{0};
+
+  // Only used while every worker queue of a lane is full.
+  std::mutex _overflowMutex;
+  std::array<std::queue<QueuedTask>, kLanesCount> _overflow;
+  std::array<std::atomic<std::size_t>, kLanesCount> _overflowSize{};
+
+  std::atomic<std::size_t> _runningBulk{0};  // bulk tasks being run
 
-  std::vector<std::thread> _workers;
-  std::queue<std::function<void()>> _tasks;
+  std::atomic<std::uint32_t> _wakeEpoch{0};
+  std::atomic<std::size_t> _parkedWorkers{0};
+  std::atomic<bool> _stop{false};
 
-  std::mutex _queueMutex;
-  std::condition_variable _condition;
-  bool _stop = false;
+  // Elastic sizing, in Clock ticks: _lastProgress is when a task was last
+  // taken (or queued into an idle pool), _recentDelay the longest time a
+  // task waited since the supervisor last looked.
+  std::atomic<std::size_t> _liveWorkers{0};
+  std::atomic<std::size_t> _retireRequests{0};
+  std::atomic<std::size_t> _pendingTasks{0};
+  std::atomic<Clock::rep> _lastProgress{0};
+  std::atomic<Clock::rep> _recentDelay{0};
+  std::atomic<std::uint64_t> _grown{0};
+  std::atomic<std::uint64_t> _retired{0};
+  std::mutex _supervisorMutex;
+  std::condition_variable_any _supervisorWake;
+  std::jthread _supervisor;
 };
 
 }  // namespace webserver::core
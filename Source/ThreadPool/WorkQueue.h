@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace webserver::core {
+
+// Bounded lock-free multi-producer multi-consumer queue (Vyukov's ring).
+// Every cell carries a sequence number telling producers and consumers
+// whose turn it is, so a push or pop costs one CAS on the shared position
+// and never takes a lock. The thread pool gives each worker one of these:
+// anyone may push into it and idle workers pop from each other's.
+template <class T>
+class WorkQueue {
+ public:
+  // `capacity` is rounded up to a power of two.
+  explicit WorkQueue(const std::size_t capacity)
+      : _mask{std::bit_ceil(capacity) - 1},
+        _cells{std::make_unique<Cell[]>(_mask + 1)} {
+    if (capacity == 0) {
+      throw std::invalid_argument("WorkQueue capacity must be positive");
+    }
+
+    for (std::size_t i = 0; i <= _mask; ++i) {
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  WorkQueue(const WorkQueue &) = delete;
+  WorkQueue(WorkQueue &&) = delete;
+  WorkQueue &operator=(const WorkQueue &) = delete;
+  WorkQueue &operator=(WorkQueue &&) = delete;
+  ~WorkQueue() = default;
+
+  // Moves from `value` only on success; false if the queue is full.
+  [[nodiscard]] bool tryPush(T &&value) {
+    auto position{_enqueuePosition.load(std::memory_order_relaxed)};
+
+    while (true) {
+      auto &cell{_cells[position & _mask]};
+      const auto sequence{cell.sequence.load(std::memory_order_acquire)};
+      const auto difference{static_cast<std::ptrdiff_t>(sequence) -
+                            static_cast<std::ptrdiff_t>(position)};
+
+      if (difference == 0) {
+        if (_enqueuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;  // the cell still holds an item from one lap ago
+      } else {
+        position = _enqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  [[nodiscard]] std::optional<T> tryPop() {
+    auto position{_dequeuePosition.load(std::memory_order_relaxed)};
+
+    while (true) {
+      auto &cell{_cells[position & _mask]};
+      const auto sequence{cell.sequence.load(std::memory_order_acquire)};
+      const auto difference{static_cast<std::ptrdiff_t>(sequence) -
+                            static_cast<std::ptrdiff_t>(position + 1)};
+
+      if (difference == 0) {
+        if (_dequeuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          std::optional<T> value{std::move(cell.value)};
+          cell.value = T{};  // release captured state right away
+          cell.sequence.store(position + _mask + 1,
+                              std::memory_order_release);
+          return value;
+        }
+      } else if (difference < 0) {
+        return std::nullopt;  // empty, or the next item is being written
+      } else {
+        position = _dequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // True while an item is queued or a push of one is under way. Only a
+  // snapshot, but never false after a push that happened before the call.
+  [[nodiscard]] bool hasWork() const noexcept {
+    return _enqueuePosition.load(std::memory_order_acquire) !=
+           _dequeuePosition.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  const std::size_t _mask;
+  const std::unique_ptr<Cell[]> _cells;
+  // Producers and consumers hammer different positions; keep them apart.
+  alignas(64) std::atomic<std::size_t> _enqueuePosition{0};
+  alignas(64) std::atomic<std::size_t> _dequeuePosition{0};
+};
+
+}  // namespace webserver::core
@@ -0,0 +1,198 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace webserver::core {
+
+TimerNode::~TimerNode() {
+  if (_wheel != nullptr) {
+    _wheel->cancel(*this);
+  }
+}
+
+bool TimerNode::isArmed() const noexcept { return _wheel != nullptr; }
+
+void TimerNode::_unlink() noexcept {
+  _prev->_next = _next;
+  _next->_prev = _prev;
+  _prev = this;
+  _next = this;
+}
+
+TimerWheel::TimerWheel(const std::chrono::milliseconds tick,
+                       const Clock::time_point start)
+    : _tick{tick}, _start{start} {
+  if (tick <= std::chrono::milliseconds::zero()) {
+    throw std::invalid_argument("Timer wheel tick must be positive");
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  // Detach whatever is still armed so the nodes do not call back into us.
+  const auto detach{[](TimerNode &head) {
+    while (head._next != &head) {
+      auto &node{*head._next};
+      node._unlink();
+      node._wheel = nullptr;
+    }
+  }};
+
+  std::ranges::for_each(_root, detach);
+
+  for (auto &level : _levels) {
+    std::ranges::for_each(level, detach);
+  }
+}
+
+void TimerWheel::arm(TimerNode &node, const std::chrono::milliseconds timeout,
+                     const Clock::time_point now) {
+  cancel(node);
+
+  // Never fire early: the deadline falls inside tick _tickAt(now + timeout),
+  // so the node is due at the start of the tick after it.
+  const auto expiryTick{timeout > std::chrono::milliseconds::zero()
+                            ? _tickAt(now + timeout) + 1
+                            : _tickAt(now)};
+
+  node._expiryTick = std::clamp(expiryTick, _currentTick,
+                                _currentTick + kMaxTicks - 1);
+  node._wheel = this;
+  _place(node);
+  ++_size;
+}
+
+void TimerWheel::cancel(TimerNode &node) noexcept {
+  if (node._wheel != this) {
+    return;
+  }
+
+  node._unlink();
+  node._wheel = nullptr;
+  --_size;
+}
+
+std::size_t TimerWheel::advance(const Clock::time_point now,
+                                const ExpiryCallback &onExpired) {
+  const auto targetTick{_tickAt(now)};
+  std::size_t expiredCount{0};
+
+  if (_size == 0) {
+    _currentTick = std::max(_currentTick, targetTick + 1);
+    return 0;
+  }
+
+  while (_currentTick <= targetTick) {
+    const auto rootSlot{_currentTick & (kRootSlots - 1)};
+
+    // At every root wrap the matching slot of the level above is due, and so
+    // on upwards; cascade from the top so nodes fall through level by level.
+    if (rootSlot == 0) {
+      std::array<std::size_t, kUpperLevels> slots{};
+      std::size_t cascadeTop{0};
+
+      for (std::size_t level = 0; level < kUpperLevels; ++level) {
+        const auto shift{kRootBits + (kLevelBits * level)};
+        slots.at(level) = (_currentTick >> shift) & (kLevelSlots - 1);
+        cascadeTop = level;
+
+        if (slots.at(level) != 0) {
+          break;
+        }
+      }
+
+      for (auto level = cascadeTop + 1; level-- > 0;) {
+        _cascade(level, slots.at(level));
+      }
+    }
+
+    TimerNode expired;
+    _splice(_root.at(rootSlot), expired);
+    ++_currentTick;
+
+    while (expired._next != &expired) {
+      auto &node{*expired._next};
+      node._unlink();
+      node._wheel = nullptr;
+      --_size;
+      ++expiredCount;
+      onExpired(node);
+    }
+
+    if (_size == 0) {
+      _currentTick = std::max(_currentTick, targetTick + 1);
+    }
+  }
+
+  return expiredCount;
+}
+
+std::size_t TimerWheel::size() const noexcept { return _size; }
+
+bool TimerWheel::empty() const noexcept { return _size == 0; }
+
+std::chrono::milliseconds TimerWheel::tick() const noexcept { return _tick; }
+
+std::uint64_t TimerWheel::_tickAt(const Clock::time_point time) const noexcept {
+  if (time <= _start) {
+    return 0;
+  }
+
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(time - _start) /
+      _tick);
+}
+
+void TimerWheel::_place(TimerNode &node) noexcept {
+  const auto delta{node._expiryTick - _currentTick};
+
+  if (delta < kRootSlots) {
+    _pushBack(_root.at(node._expiryTick & (kRootSlots - 1)), node);
+    return;
+  }
+
+  for (std::size_t level = 0; level < kUpperLevels; ++level) {
+    const auto shift{kRootBits + (kLevelBits * level)};
+
+    if (delta < (std::uint64_t{1} << (shift + kLevelBits)) ||
+        level + 1 == kUpperLevels) {
+      const auto slot{(node._expiryTick >> shift) & (kLevelSlots - 1)};
+      _pushBack(_levels.at(level).at(slot), node);
+      return;
+    }
+  }
+}
+
+void TimerWheel::_cascade(const std::size_t level,
+                          const std::size_t slot) noexcept {
+  TimerNode pending;
+  _splice(_levels.at(level).at(slot), pending);
+
+  while (pending._next != &pending) {
+    auto &node{*pending._next};
+    node._unlink();
+    _place(node);
+  }
+}
+
+void TimerWheel::_pushBack(TimerNode &head, TimerNode &node) noexcept {
+  node._prev = head._prev;
+  node._next = &head;
+  head._prev->_next = &node;
+  head._prev = &node;
+}
+
+void TimerWheel::_splice(TimerNode &from, TimerNode &to) noexcept {
+  if (from._next == &from) {
+    return;
+  }
+
+  to._next = from._next;
+  to._prev = from._prev;
+  to._next->_prev = &to;
+  to._prev->_next = &to;
+  from._next = &from;
+  from._prev = &from;
+}
+
+}  // namespace webserver::core
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace webserver::core {
+
+class TimerWheel;
+
+// Intrusive timer: embed (or derive from) it in the object that owns the
+// deadline. A node sits in at most one wheel slot; destroying an armed node
+// cancels it.
+class TimerNode {
+ public:
+  TimerNode() = default;
+  TimerNode(const TimerNode &) = delete;
+  TimerNode(TimerNode &&) = delete;
+  TimerNode &operator=(const TimerNode &) = delete;
+  TimerNode &operator=(TimerNode &&) = delete;
+  ~TimerNode();
+
+  [[nodiscard]] bool isArmed() const noexcept;
+
+ private:
+  friend class TimerWheel;
+
+  void _unlink() noexcept;
+
+  TimerNode *_prev{this};
+  TimerNode *_next{this};
+  TimerWheel *_wheel{nullptr};
+  std::uint64_t _expiryTick{0};
+};
+
+// Hierarchical timing wheel (Varghese & Lauck) with a 256-slot first level
+// and three 64-slot levels above it. arm() and cancel() are O(1); far
+// timers are cascaded down one level at a time as the wheel turns. Not
+// thread-safe: each event loop owns its own wheel.
+class TimerWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using ExpiryCallback = std::function<void(TimerNode &)>;
+
+  explicit TimerWheel(std::chrono::milliseconds tick,
+                      Clock::time_point start = Clock::now());
+  TimerWheel(const TimerWheel &) = delete;
+  TimerWheel(TimerWheel &&) = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+  TimerWheel &operator=(TimerWheel &&) = delete;
+  ~TimerWheel();
+
+  // (Re)arms `node` to expire `timeout` after `now`, at most one tick late.
+  // Timeouts beyond the wheel range are clamped to it.
+  void arm(TimerNode &node, std::chrono::milliseconds timeout,
+           Clock::time_point now = Clock::now());
+  void cancel(TimerNode &node) noexcept;
+
+  // Turns the wheel up to `now` and hands every expired node to `onExpired`
+  // after unlinking it, so the callback may re-arm or destroy it (but must
+  // not throw). Returns the number of expired timers.
+  std::size_t advance(Clock::time_point now, const ExpiryCallback &onExpired);
+
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+  [[nodiscard]] std::chrono::milliseconds tick() const noexcept;
+
+ private:
+  static constexpr unsigned kRootBits = 8;
+  static constexpr unsigned kLevelBits = 6;
+  static constexpr std::size_t kRootSlots = 1U << kRootBits;
+  static constexpr std::size_t kLevelSlots = 1U << kLevelBits;
+  static constexpr std::size_t kUpperLevels = 3;
+  static constexpr std::uint64_t kMaxTicks =
+      std::uint64_t{1} << (kRootBits + (kLevelBits * kUpperLevels));
+
+  [[nodiscard]] std::uint64_t _tickAt(Clock::time_point time) const noexcept;
+  void _place(TimerNode &node) noexcept;
+  void _cascade(std::size_t level, std::size_t slot) noexcept;
+  static void _pushBack(TimerNode &head, TimerNode &node) noexcept;
+  static void _splice(TimerNode &from, TimerNode &to) noexcept;
+
+  const std::chrono::milliseconds _tick;
+  const Clock::time_point _start;
+  std::uint64_t _currentTick{0};  // next tick to be processed
+  std::size_t _size{0};
+
+  // Slot heads are sentinels of circular doubly linked lists.
+  std::array<TimerNode, kRootSlots> _root;
+  std::array<std::array<TimerNode, kLevelSlots>, kUpperLevels> _levels;
+};
+
+}  // namespace webserver::core
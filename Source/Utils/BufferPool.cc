@@ -0,0 +1,66 @@
+#include "BufferPool.h"
+
+#include <algorithm>
+
+#include "Utils.h"
+
+namespace webserver::utils {
+
+BufferPool::BufferPool(const std::size_t bufferSize,
+                       const std::size_t maxIdleBuffers)
+    : _bufferSize{bufferSize}, _maxIdleBuffers{maxIdleBuffers} {
+}
+
+BufferPool &BufferPool::shared() {
+  static const auto pools{[] {
+    std::vector<std::unique_ptr<BufferPool>> nodePools(
+        std::max<std::size_t>(1, getNumaNodes().size()));
+
+    for (auto &pool : nodePools) {
+      pool = std::make_unique<BufferPool>(kDefaultBufferSize,
+                                          kDefaultMaxIdleBuffers);
+    }
+
+    return nodePools;
+  }()};
+
+  const auto node{static_cast<std::size_t>(getCurrentNumaNode())};
+  return *pools.at(std::min(node, pools.size() - 1));
+}
+
+BufferPool::Buffer BufferPool::acquire() {
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    if (!_idle.empty()) {
+      auto buffer{std::move(_idle.back())};
+      _idle.pop_back();
+      return buffer;
+    }
+  }
+
+  return std::make_unique_for_overwrite<char[]>(_bufferSize);  // NOLINT
+}
+
+void BufferPool::release(Buffer buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{_mutex};
+
+  if (_idle.size() < _maxIdleBuffers) {
+    _idle.push_back(std::move(buffer));
+  }
+}
+
+std::size_t BufferPool::bufferSize() const noexcept {
+  return _bufferSize;
+}
+
+std::size_t BufferPool::idleCount() {
+  std::lock_guard<std::mutex> lock{_mutex};
+  return _idle.size();
+}
+
+}  // namespace webserver::utils
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace webserver::utils {
+
+// Free list of fixed-size byte buffers shared by all connections. Buffers are
+// handed out uninitialized; at most `maxIdleBuffers` are kept around, the rest
+// go back to the allocator on release.
+//
+// shared() keeps one pool per NUMA node and returns the caller's. Memory is
+// placed on the node of the thread that first touches it, so a buffer
+// recycled through its node's pool stays local to the threads using it.
+class BufferPool {
+ public:
+  using Buffer = std::unique_ptr<char[]>;  // NOLINT
+
+  static constexpr std::size_t kDefaultBufferSize = 8 * 1024;
+  static constexpr std::size_t kDefaultMaxIdleBuffers = 1024;
+
+  BufferPool(std::size_t bufferSize, std::size_t maxIdleBuffers);
+  BufferPool(const BufferPool &) = delete;
+  BufferPool(BufferPool &&) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+  BufferPool &operator=(BufferPool &&) = delete;
+  ~BufferPool() = default;
+
+  // Pool of the NUMA node the calling thread runs on.
+  [[nodiscard]] static BufferPool &shared();
+
+  [[nodiscard]] Buffer acquire();
+  void release(Buffer buffer);
+
+  [[nodiscard]] std::size_t bufferSize() const noexcept;
+  [[nodiscard]] std::size_t idleCount();
+
+ private:
+  const std::size_t _bufferSize;
+  const std::size_t _maxIdleBuffers;
+
+  std::mutex _mutex;
+  std::vector<Buffer> _idle;
+};
+
+}  // namespace webserver::utils
@@ -2,6 +2,7 @@
 
 #include <fmt/core.h>
 
+#include <charconv>
 #include <stdexcept>
 
 namespace webserver::utils {
@@ -27,4 +28,24 @@ bool isAsciiUppercase(const char chr) {
   return chr >= 'A' && chr <= 'Z';
 }
 
+std::size_t parseContentLength(std::string_view value) {
+  while (!value.empty() && isSpaceOrTab(value.front())) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && isSpaceOrTab(value.back())) {
+    value.remove_suffix(1);
+  }
+
+  std::size_t length{};
+  const auto *const end{value.data() + value.size()};
+  const auto [parsedEnd, error]{std::from_chars(value.data(), end, length)};
+
+  if (value.empty() || error != std::errc{} || parsedEnd != end) {
+    throw std::runtime_error(
+        fmt::format("invalid Content-Length: '{}'", value));
+  }
+
+  return length;
+}
+
 }  // namespace webserver::utils
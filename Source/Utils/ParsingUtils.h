@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+
 namespace webserver::utils {
 
 void expect(char realChar, char expected);
 void expectDigit(char chr);
 bool isSpaceOrTab(char chr);
 bool isAsciiUppercase(char chr);
+// Parses a Content-Length value (surrounding spaces allowed), throws on
+// anything but a non-negative decimal number that fits std::size_t.
+std::size_t parseContentLength(std::string_view value);
 
 }  // namespace webserver::utils
@@ -1,9 +1,19 @@
 #include "Utils.h"
 
+#ifdef __linux__
+  #include <sched.h>
+#endif
+
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <filesystem>
 #include <iomanip>
+#include <stdexcept>
 #include <thread>
 
+#include "FileSystemUtils.h"
+
 namespace webserver::utils {
 
 std::string getCurrentDate() {
@@ -41,4 +51,143 @@ int getNativeThreadsCount() noexcept {
   return count == 0 ? 4 : static_cast<int>(count);
 }
 
+std::vector<int> getAllowedCpus() {
+  std::vector<int> cpus;
+
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+
+  return cpus;
+}
+
+bool pinCurrentThreadToCpus(const std::vector<int> &cpus) noexcept {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  for (const auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpus);
+  return false;
+#endif
+}
+
+std::vector<int> parseCpuList(const std::string_view list) {
+  const auto parseCpu{[list](const std::string_view token) {
+    int cpu{-1};
+    const auto [end, error]{
+        std::from_chars(token.data(), token.data() + token.size(), cpu)};
+
+    if (error != std::errc{} || end != token.data() + token.size() ||
+        cpu < 0) {
+      throw std::invalid_argument("Invalid CPU list: " + std::string{list});
+    }
+
+    return cpu;
+  }};
+
+  std::vector<int> cpus;
+  std::size_t position{0};
+
+  while (position <= list.size()) {
+    const auto comma{std::min(list.find(',', position), list.size())};
+    const auto range{
+        trim(std::string{list.substr(position, comma - position)})};
+    position = comma + 1;
+
+    if (range.empty()) {
+      continue;
+    }
+
+    const auto dash{range.find('-')};
+    const auto first{parseCpu(std::string_view{range}.substr(0, dash))};
+    const auto last{dash == std::string::npos
+                        ? first
+                        : parseCpu(std::string_view{range}.substr(dash + 1))};
+
+    if (last < first) {
+      throw std::invalid_argument("Invalid CPU list: " + std::string{list});
+    }
+
+    for (auto cpu{first}; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  std::ranges::sort(cpus);
+  const auto duplicates{std::ranges::unique(cpus)};
+  cpus.erase(duplicates.begin(), duplicates.end());
+  return cpus;
+}
+
+std::vector<std::vector<int>> getNumaNodes() {
+  std::vector<std::vector<int>> nodes;
+
+#ifdef __linux__
+  const std::filesystem::path nodesDirectory{"/sys/devices/system/node"};
+  std::error_code error;
+
+  for (const auto &entry :
+       std::filesystem::directory_iterator{nodesDirectory, error}) {
+    const auto name{entry.path().filename().string()};
+    int node{-1};
+
+    if (!name.starts_with("node") ||
+        std::from_chars(name.data() + 4, name.data() + name.size(), node).ec !=
+            std::errc{}) {
+      continue;
+    }
+
+    const auto cpuList{readFile(entry.path() / "cpulist")};
+
+    if (!cpuList.has_value()) {
+      continue;
+    }
+
+    if (static_cast<std::size_t>(node) >= nodes.size()) {
+      nodes.resize(static_cast<std::size_t>(node) + 1);
+    }
+
+    try {
+      nodes.at(static_cast<std::size_t>(node)) = parseCpuList(*cpuList);
+    } catch (const std::invalid_argument &) {
+      return {};
+    }
+  }
+#endif
+
+  return nodes;
+}
+
+int getCurrentNumaNode() noexcept {
+#ifdef __linux__
+  unsigned cpu{0};
+  unsigned node{0};
+
+  if (getcpu(&cpu, &node) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+
+  return 0;
+}
+
 }  // namespace webserver::utils
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace webserver::utils {
 
@@ -8,4 +10,17 @@ namespace webserver::utils {
 [[nodiscard]] std::string trim(std::string str);
 [[nodiscard]] int getNativeThreadsCount() noexcept;
 
+// CPUs the process may run on; empty where affinity is not supported.
+[[nodiscard]] std::vector<int> getAllowedCpus();
+// Restricts the calling thread to `cpus`. Returns false if unsupported.
+bool pinCurrentThreadToCpus(const std::vector<int> &cpus) noexcept;
+// Parses a kernel style CPU list such as "0-3,8,10-11" into sorted, unique
+// CPU ids. Throws std::invalid_argument on malformed input.
+[[nodiscard]] std::vector<int> parseCpuList(std::string_view list);
+// CPUs of every NUMA node, indexed by node id, as listed in sysfs. Empty
+// where the topology is unknown (no NUMA support or not Linux).
+[[nodiscard]] std::vector<std::vector<int>> getNumaNodes();
+// NUMA node the calling thread currently runs on, 0 if unknown.
+[[nodiscard]] int getCurrentNumaNode() noexcept;
+
 }  // namespace webserver::utils
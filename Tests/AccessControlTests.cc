@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "AccessControl.h"
+#include "IpAddress.h"
+#include "PrefixTrie.h"
+
+using namespace webserver::core;
+using webserver::config::AccessRule;
+using webserver::net::IpAddress;
+
+namespace {
+
+IpAddress address(const char *text) {
+  return IpAddress::parse(text).value();
+}
+
+constexpr unsigned kV4Offset = 96;
+
+}  // namespace
+
+TEST(PrefixTrie, LongestPrefixWins) {
+  PrefixTrie trie;
+  trie.insert(address("10.0.0.0"), kV4Offset + 8, true);
+  trie.insert(address("10.6.0.0"), kV4Offset + 16, false);
+  trie.insert(address("10.6.6.6"), kV4Offset + 32, true);
+
+  EXPECT_EQ(trie.match(address("10.1.2.3")), true);
+  EXPECT_EQ(trie.match(address("10.6.2.3")), false);
+  EXPECT_EQ(trie.match(address("10.6.6.6")), true);
+  EXPECT_EQ(trie.match(address("11.0.0.1")), std::nullopt);
+  EXPECT_EQ(trie.size(), 3U);
+}
+
+TEST(PrefixTrie, ShorterPrefixInsertedLaterSplitsPath) {
+  PrefixTrie trie;
+  trie.insert(address("2001:db8:1::"), 48, false);
+  trie.insert(address("2001:db8:2::"), 48, false);
+  trie.insert(address("2001:db8::"), 32, true);
+  trie.insert(address("::"), 0, false);
+
+  EXPECT_EQ(trie.match(address("2001:db8:1::5")), false);
+  EXPECT_EQ(trie.match(address("2001:db8:3::5")), true);
+  EXPECT_EQ(trie.match(address("2001:db9::1")), false);
+  EXPECT_EQ(trie.match(address("192.0.2.1")), false);  // ::/0 covers IPv4
+}
+
+TEST(PrefixTrie, MatchesBruteForceOnRandomPrefixes) {
+  struct Entry {
+    std::uint32_t network;
+    unsigned length;
+    bool allowed;
+  };
+
+  std::mt19937 random{42};
+  std::vector<Entry> entries;
+  PrefixTrie trie;
+
+  const auto mask{[](const unsigned length) {
+    return length == 0 ? 0U : ~std::uint32_t{0} << (32 - length);
+  }};
+
+  for (int i = 0; i < 2000; ++i) {
+    const auto length{static_cast<unsigned>(random() % 33)};
+    const auto network{static_cast<std::uint32_t>(random()) & mask(length)};
+    const auto allowed{random() % 2 == 0};
+    entries.push_back({network, length, allowed});
+    trie.insert(IpAddress::fromV4(network), kV4Offset + length, allowed);
+  }
+
+  for (int i = 0; i < 20000; ++i) {
+    const auto probe{static_cast<std::uint32_t>(random())};
+    std::optional<bool> expected;
+    int bestLength{-1};
+
+    // Later inserts of the same prefix overwrite earlier ones.
+    for (const auto &entry : entries) {
+      if ((probe & mask(entry.length)) == entry.network &&
+          static_cast<int>(entry.length) >= bestLength) {
+        bestLength = static_cast<int>(entry.length);
+        expected = entry.allowed;
+      }
+    }
+
+    ASSERT_EQ(trie.match(IpAddress::fromV4(probe)), expected) << probe;
+  }
+}
+
+TEST(AccessControl, AllowlistDeniesUnlistedClients) {
+  const AccessControl acl{{AccessRule{.pathPrefix = "/internal/",
+                                      .allow = {"10.0.0.0/8", "::1"},
+                                      .deny = {"10.6.0.0/16"}}}};
+
+  EXPECT_TRUE(acl.isAllowed("/internal/a", address("10.1.1.1")));
+  EXPECT_TRUE(acl.isAllowed("/internal/a", address("::1")));
+  EXPECT_FALSE(acl.isAllowed("/internal/a", address("10.6.1.1")));
+  EXPECT_FALSE(acl.isAllowed("/internal/a", address("192.0.2.1")));
+  // Other paths are not covered, neither are peers without an address.
+  EXPECT_TRUE(acl.isAllowed("/index.html", address("192.0.2.1")));
+  EXPECT_TRUE(acl.isAllowed("/internal/a", std::nullopt));
+}
+
+TEST(AccessControl, NormalisesPathBeforeMatching) {
+  const AccessControl acl{
+      {AccessRule{.pathPrefix = "/internal/", .allow = {}, .deny = {"all"}}}};
+  const auto client{address("192.0.2.1")};
+
+  EXPECT_FALSE(acl.isAllowed("/internal/x?y=1", client));
+  EXPECT_FALSE(acl.isAllowed("/./internal/x", client));
+  EXPECT_FALSE(acl.isAllowed("//internal/x", client));
+  EXPECT_FALSE(acl.isAllowed("/public/../internal/x", client));
+  EXPECT_TRUE(acl.isAllowed("/internals", client));
+}
+
+TEST(AccessControl, LongestPathRuleApplies) {
+  const AccessControl acl{
+      {AccessRule{.pathPrefix = "/", .allow = {}, .deny = {"203.0.113.0/24"}},
+       AccessRule{
+           .pathPrefix = "/admin/", .allow = {"127.0.0.1"}, .deny = {}}}};
+
+  EXPECT_FALSE(acl.isAllowed("/index.html", address("203.0.113.9")));
+  EXPECT_TRUE(acl.isAllowed("/index.html", address("198.51.100.1")));
+  EXPECT_TRUE(acl.isAllowed("/admin/x", address("127.0.0.1")));
+  EXPECT_FALSE(acl.isAllowed("/admin/x", address("198.51.100.1")));
+}
+
+TEST(AccessControl, RejectsMalformedPrefixes) {
+  for (const auto *bad : {"10.0.0.0/33", "10.0.0.0/", "nonsense", "::1/129",
+                          "10.0.0.0/8x"}) {
+    const std::vector<AccessRule> rules{
+        {.pathPrefix = "/", .allow = {bad}, .deny = {}}};
+    EXPECT_THROW(AccessControl{rules}, std::invalid_argument) << bad;
+  }
+}
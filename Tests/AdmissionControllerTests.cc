@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include "AdmissionController.h"
+
+using namespace webserver::core;
+using namespace std::chrono_literals;
+
+namespace {
+
+const auto kNow{AdmissionController::Clock::time_point{} + 1h};
+
+}  // namespace
+
+TEST(AdmissionController, ShedsBeyondLimitUntilPermitIsReleased) {
+  AdmissionController controller{{.minLimit = 1, .maxLimit = 2}};
+
+  auto first{controller.tryAcquire(kNow)};
+  auto second{controller.tryAcquire(kNow)};
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+
+  EXPECT_FALSE(controller.tryAcquire(kNow).has_value());
+  EXPECT_EQ(controller.shedCount(), 1U);
+  EXPECT_EQ(controller.inFlight(), 2U);
+
+  first.reset();
+  EXPECT_EQ(controller.inFlight(), 1U);
+  EXPECT_TRUE(controller.tryAcquire(kNow).has_value());
+}
+
+TEST(AdmissionController, BacksOffOncePerIntervalOnLateStarts) {
+  AdmissionController controller{
+      {.minLimit = 1, .maxLimit = 100, .targetDelay = 10ms}};
+
+  auto late{controller.tryAcquire(kNow)};
+  auto alsoLate{controller.tryAcquire(kNow)};
+  late->start(kNow + 50ms);
+  alsoLate->start(kNow + 51ms);  // same interval, no second backoff
+
+  EXPECT_EQ(controller.limit(), 90U);
+
+  auto next{controller.tryAcquire(kNow + 60ms)};
+  next->start(kNow + 100ms);
+  EXPECT_EQ(controller.limit(), 81U);
+}
+
+TEST(AdmissionController, NeverDropsBelowMinLimit) {
+  AdmissionController controller{
+      {.minLimit = 4, .maxLimit = 5, .targetDelay = 1ms}};
+
+  for (int i = 0; i < 10; ++i) {
+    const auto at{kNow + std::chrono::seconds{i}};
+    auto permit{controller.tryAcquire(at)};
+    permit->start(at + 1s);
+  }
+
+  EXPECT_EQ(controller.limit(), 4U);
+}
+
+TEST(AdmissionController, GrowsWhileSaturatedAndOnTime) {
+  AdmissionController controller{
+      {.minLimit = 1, .maxLimit = 10, .targetDelay = 10ms}};
+
+  auto late{controller.tryAcquire(kNow)};
+  late->start(kNow + 20ms);
+  late.reset();
+  ASSERT_EQ(controller.limit(), 9U);
+
+  std::vector<AdmissionController::Permit> permits;
+
+  for (int i = 0; i < 5; ++i) {
+    permits.push_back(controller.tryAcquire(kNow).value());
+  }
+
+  permits.front().start(kNow + 1ms);
+  EXPECT_EQ(controller.limit(), 10U);
+}
+
+TEST(AdmissionController, IdleLimitDoesNotGrow) {
+  AdmissionController controller{
+      {.minLimit = 1, .maxLimit = 10, .targetDelay = 10ms}};
+
+  auto late{controller.tryAcquire(kNow)};
+  late->start(kNow + 20ms);
+  late.reset();
+
+  auto onTime{controller.tryAcquire(kNow)};
+  onTime->start(kNow + 1ms);
+
+  EXPECT_EQ(controller.limit(), 9U);
+}
+
+TEST(AdmissionController, DisabledControllerAdmitsEverything) {
+  AdmissionController controller{
+      {.enabled = false, .minLimit = 1, .maxLimit = 1}};
+
+  std::vector<AdmissionController::Permit> permits;
+
+  for (int i = 0; i < 10; ++i) {
+    auto permit{controller.tryAcquire(kNow)};
+    ASSERT_TRUE(permit.has_value());
+    permits.push_back(std::move(permit.value()));
+  }
+
+  EXPECT_EQ(controller.shedCount(), 0U);
+}
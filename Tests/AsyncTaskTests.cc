@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <coroutine>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "AsyncTask.h"
+#include "ThreadPool.h"
+
+using webserver::core::AsyncTask;
+using webserver::core::spawn;
+using webserver::core::syncWait;
+using webserver::core::ThreadPool;
+
+namespace {
+
+// Suspends the awaiting coroutine and resumes it on a pool worker.
+struct ResumeOn {
+  ThreadPool &pool;
+
+  [[nodiscard]] bool await_ready() const noexcept {
+    return false;
+  }
+  void await_suspend(const std::coroutine_handle<> handle) const {
+    pool.submit([handle] { handle.resume(); });
+  }
+  void await_resume() const noexcept {
+  }
+};
+
+AsyncTask<int> answer() {
+  co_return 42;
+}
+
+AsyncTask<int> addOne(AsyncTask<int> task) {
+  co_return co_await std::move(task) + 1;
+}
+
+AsyncTask<int> fail() {
+  throw std::runtime_error("upstream failed");
+  co_return 0;
+}
+
+AsyncTask<std::thread::id> hopTo(ThreadPool &pool) {
+  co_await ResumeOn{pool};
+  co_return std::this_thread::get_id();
+}
+
+}  // namespace
+
+TEST(AsyncTask, StartsOnlyWhenAwaited) {
+  auto started{false};
+  auto task{[](bool &started) -> AsyncTask<> {
+    started = true;
+    co_return;
+  }(started)};
+
+  EXPECT_FALSE(started);
+  syncWait(std::move(task));
+  EXPECT_TRUE(started);
+}
+
+TEST(AsyncTask, ChainsResults) {
+  EXPECT_EQ(syncWait(addOne(addOne(answer()))), 44);
+}
+
+TEST(AsyncTask, PropagatesExceptionsToTheAwaiter) {
+  EXPECT_THROW(static_cast<void>(syncWait(addOne(fail()))),
+               std::runtime_error);
+}
+
+TEST(AsyncTask, ContinuesOnTheThreadThatResumedIt) {
+  ThreadPool pool{1};
+
+  EXPECT_NE(syncWait(hopTo(pool)), std::this_thread::get_id());
+}
+
+TEST(AsyncTask, SpawnReturnsAtTheFirstSuspension) {
+  ThreadPool pool{1};
+  std::promise<void> release;
+  std::promise<int> result;
+  auto resultFuture{result.get_future()};
+
+  spawn([](ThreadPool &pool, std::shared_future<void> release,
+           std::promise<int> result) -> AsyncTask<> {
+    co_await ResumeOn{pool};
+    release.wait();
+    result.set_value(co_await answer());
+  }(pool, release.get_future().share(), std::move(result)));
+
+  // The coroutine is parked on the pool, not running on this thread.
+  release.set_value();
+  EXPECT_EQ(resultFuture.get(), 42);
+}
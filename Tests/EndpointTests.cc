@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "Endpoint.h"
+#include "IpAddress.h"
+
+using webserver::net::Endpoint;
+using webserver::net::IpAddress;
+
+TEST(Endpoint, BarePortListensOnEveryAddress) {
+  for (const auto *text : {"8000", "*:8000", "[::]:8000"}) {
+    const auto endpoint{Endpoint::parse(text)};
+
+    EXPECT_FALSE(endpoint.isUnix()) << text;
+    EXPECT_EQ(endpoint.address, IpAddress{}) << text;
+    EXPECT_EQ(endpoint.port, 8000) << text;
+  }
+
+  EXPECT_EQ(Endpoint::anyAddress(8000).toString(), "[::]:8000");
+}
+
+TEST(Endpoint, ParsesBothAddressFamilies) {
+  const auto v4{Endpoint::parse("127.0.0.1:8080")};
+  EXPECT_TRUE(v4.address.isV4());
+  EXPECT_EQ(v4.address, IpAddress::fromV4(0x7f000001));
+  EXPECT_EQ(v4.toString(), "127.0.0.1:8080");
+
+  const auto v6{Endpoint::parse("[::1]:8080")};
+  EXPECT_FALSE(v6.address.isV4());
+  EXPECT_EQ(v6.port, 8080);
+  EXPECT_EQ(v6.toString(), "[::1]:8080");
+}
+
+TEST(Endpoint, ParsesUnixSocketPath) {
+  const auto endpoint{Endpoint::parse("unix:/run/ws.sock")};
+
+  EXPECT_TRUE(endpoint.isUnix());
+  EXPECT_EQ(endpoint.path, "/run/ws.sock");
+  EXPECT_EQ(endpoint.toString(), "unix:/run/ws.sock");
+}
+
+TEST(Endpoint, RejectsMalformedEntries) {
+  for (const auto *bad : {"", "unix:", "0", "65536", "localhost:80", "::1:80",
+                          "[::1]80", "[::1]:", "1.2.3.4:8x"}) {
+    EXPECT_THROW(static_cast<void>(Endpoint::parse(bad)),
+                 std::invalid_argument)
+        << bad;
+  }
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "HttpScanner.h"
+
+using namespace webserver::http;
+
+namespace {
+
+std::vector<ScanLevel> supportedLevels() {
+  std::vector<ScanLevel> levels{ScanLevel::SCALAR};
+
+  for (const auto level : {ScanLevel::SSE42, ScanLevel::AVX2}) {
+    if (level <= supportedScanLevel()) {
+      levels.push_back(level);
+    }
+  }
+
+  return levels;
+}
+
+void expectSameAsScalar(const std::string_view data) {
+  const auto &scalar{scannerFor(ScanLevel::SCALAR)};
+
+  for (const auto level : supportedLevels()) {
+    const auto &vector{scannerFor(level)};
+
+    EXPECT_EQ(vector.findCrlf(data), scalar.findCrlf(data)) << data.size();
+    EXPECT_EQ(vector.findNonToken(data), scalar.findNonToken(data));
+    EXPECT_EQ(vector.findNonFieldValue(data), scalar.findNonFieldValue(data));
+    EXPECT_EQ(vector.findNonUriChar(data), scalar.findNonUriChar(data));
+  }
+}
+
+}  // namespace
+
+TEST(HttpScanner, FindsCrlf) {
+  for (const auto level : supportedLevels()) {
+    const auto &scanner{scannerFor(level)};
+
+    EXPECT_EQ(scanner.findCrlf(""), std::string_view::npos);
+    EXPECT_EQ(scanner.findCrlf("\r"), std::string_view::npos);
+    EXPECT_EQ(scanner.findCrlf("abc\r\n"), 3);
+    EXPECT_EQ(scanner.findCrlf("a\rb\n\r\r\n"), 5);
+  }
+}
+
+TEST(HttpScanner, ClassifiesHeaderBytes) {
+  const std::string name{"X-Forwarded-For!#$%&'*+.^_`|~09azAZ"};
+
+  for (const auto level : supportedLevels()) {
+    const auto &scanner{scannerFor(level)};
+
+    EXPECT_EQ(scanner.findNonToken(name), name.size());
+    EXPECT_EQ(scanner.findNonToken(name + ": value"), name.size());
+    EXPECT_EQ(scanner.findNonToken(name + "\x80"), name.size());
+    EXPECT_EQ(scanner.findNonFieldValue(name + " \t\x80\xFF"), name.size() + 4);
+    EXPECT_EQ(scanner.findNonFieldValue(name + "\x7F"), name.size());
+    EXPECT_EQ(scanner.findNonFieldValue(name + "\r\n"), name.size());
+  }
+}
+
+TEST(HttpScanner, ClassifiesUriBytes) {
+  const std::string uri{"/static/app-1.2_~x.js?v=3&q=a+b;c,d:e@f!$'()*"};
+
+  for (const auto level : supportedLevels()) {
+    const auto &scanner{scannerFor(level)};
+
+    EXPECT_EQ(scanner.findNonUriChar(uri), uri.size());
+    EXPECT_EQ(scanner.findNonUriChar(uri + " HTTP/1.1"), uri.size());
+    EXPECT_EQ(scanner.findNonUriChar(uri + "%20"), uri.size());
+    EXPECT_EQ(scanner.findNonUriChar(uri + "\xC3"), uri.size());
+  }
+}
+
+TEST(HttpScanner, VectorLevelsMatchScalarAtBlockBoundaries) {
+  for (std::size_t size = 0; size <= 70; ++size) {
+    for (std::size_t position = 0; position < size; ++position) {
+      std::string data(size, 'a');
+
+      // A CRLF, a lone CR and a CR whose LF starts the next block.
+      data[position] = '\r';
+      expectSameAsScalar(data);
+      if (position + 1 < size) {
+        data[position + 1] = '\n';
+        expectSameAsScalar(data);
+      }
+      data[position] = '\x85';
+      expectSameAsScalar(data);
+    }
+  }
+}
+
+TEST(HttpScanner, VectorLevelsMatchScalarOnRandomInput) {
+  std::mt19937 random{42};
+  // Mostly header-like bytes so matches are not always at the start.
+  const std::string_view common{"abcXYZ019-_:. \t\r\n"};
+  std::uniform_int_distribution<int> pick{0, 99};
+  std::uniform_int_distribution<int> byte{0, 255};
+
+  for (int iteration = 0; iteration < 2000; ++iteration) {
+    std::string data(static_cast<std::size_t>(pick(random)), '\0');
+
+    for (auto &chr : data) {
+      chr = pick(random) < 95
+                ? common[static_cast<std::size_t>(pick(random)) %
+                         common.size()]
+                : static_cast<char>(static_cast<std::uint8_t>(byte(random)));
+    }
+    expectSameAsScalar(data);
+  }
+}
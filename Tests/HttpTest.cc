@@ -21,6 +21,29 @@ TEST(HttpResponseTest, ToStringGeneratesCorrectHttpResponse) {
   EXPECT_NE(result.find("\r\n\r\nHello, world!"), std::string::npos);
 }
 
+TEST(HttpResponseTest, SerializeHeadStopsBeforeBody) {
+  HttpResponse response;
+  response.headers["Content-Length"] = "5";
+
+  const auto head{response.serializeHead()};
+
+  EXPECT_TRUE(head.starts_with("HTTP/1.1 200 OK\r\n"));
+  EXPECT_TRUE(head.ends_with("Content-Length: 5\r\n\r\n"));
+
+  response.body = "hello";
+  EXPECT_TRUE(response.serialize().ends_with("\r\n\r\nhello"));
+}
+
+TEST(HttpResponseTest, PrebuiltResponseIsSharedAndClosesConnection) {
+  constexpr auto kStatus{StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE};
+  const auto& response{HttpResponse::prebuilt(kStatus)};
+
+  EXPECT_EQ(response,
+            "HTTP/1.1 431 Request Header Fields Too Large\r\n"
+            "Content-Length: 0\r\nConnection: close\r\n\r\n");
+  EXPECT_EQ(&response, &HttpResponse::prebuilt(kStatus));
+}
+
 TEST(HttpParserTest, ParsesSimpleGetRequest) {
   const std::string rawRequest =
       "GET /index.html HTTP/1.1\r\n"
@@ -56,6 +79,31 @@ TEST(HttpParserTest, ParsesPostRequestWithBody) {
   EXPECT_EQ(req.body, "Hello world");
 }
 
+TEST(HttpParserTest, BodyEndsAtContentLength) {
+  const std::string rawRequest =
+      "POST /submit HTTP/1.1\r\n"
+      "Content-Length: 5\r\n"
+      "\r\n"
+      "HelloGET /next HTTP/1.1\r\n\r\n";
+
+  const HttpRequest req = HttpParser{rawRequest}.parse();
+
+  EXPECT_EQ(req.body, "Hello");
+}
+
+TEST(HttpParserTest, IgnoresBytesAfterHeadersWithoutContentLength) {
+  const std::string rawRequest =
+      "GET /first HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "\r\n"
+      "GET /second HTTP/1.1\r\n\r\n";
+
+  const HttpRequest req = HttpParser{rawRequest}.parse();
+
+  EXPECT_EQ(req.uri, "/first");
+  EXPECT_TRUE(req.body.empty());
+}
+
 TEST(HttpParserTest, ParsesHeadersWithExtraSpaces) {
   const std::string rawRequest =
       "GET /test HTTP/1.1\r\n"
@@ -253,3 +301,80 @@ TEST(HttpParserTest, GarbadgeAfterHttpVersion) {
   EXPECT_THROW(const auto t = HttpParser{rawRequest}.parse(),
                std::runtime_error);
 }
+
+TEST(HttpParserTest, KeepsSpacesInsideHeaderValue) {
+  const std::string rawRequest =
+      "GET / HTTP/1.1\r\n"
+      "User-Agent:  Mozilla/5.0 (X11; Linux x86_64)\t \r\n"
+      "\r\n";
+
+  const HttpRequest req = HttpParser{rawRequest}.parse();
+
+  EXPECT_EQ(req.headers.at("user-agent"), "Mozilla/5.0 (X11; Linux x86_64)");
+}
+
+TEST(HttpParserTest, InvalidCharacterInHeaderName) {
+  for (const std::string name : {"X(Bad)", "X/Bad", "", "X\x80"}) {
+    const std::string rawRequest =
+        "GET / HTTP/1.1\r\n" + name + ": value\r\n\r\n";
+    EXPECT_THROW(const auto t = HttpParser{rawRequest}.parse(),
+                 std::runtime_error);
+  }
+}
+
+TEST(HttpParserTest, ControlCharacterInHeaderValue) {
+  const std::string rawRequest =
+      "GET / HTTP/1.1\r\n"
+      "X-Test: one\rtwo\r\n"
+      "\r\n";
+
+  EXPECT_THROW(const auto t = HttpParser{rawRequest}.parse(),
+               std::runtime_error);
+}
+
+TEST(HttpParserTest, RequestWithoutHeaders) {
+  const std::string rawRequest = "GET /plain HTTP/1.0\r\n\r\n";
+
+  const HttpRequest req = HttpParser{rawRequest}.parse();
+
+  EXPECT_EQ(req.uri, "/plain");
+  EXPECT_TRUE(req.headers.empty());
+}
+
+TEST(HttpParserTest, CommonRequestLines) {
+  const HttpRequest get =
+      HttpParser{"GET /static/app.js?v=2 HTTP/1.1\r\nHost: x\r\n\r\n"}
+          .parse();
+  const HttpRequest head =
+      HttpParser{"HEAD /index.html HTTP/1.1\r\n\r\n"}.parse();
+
+  EXPECT_EQ(get.method, HttpMethod::GET);
+  EXPECT_EQ(get.uri, "/static/app.js?v=2");
+  EXPECT_EQ(get.httpVersion, HttpVersion::HTTP_1_1);
+  EXPECT_EQ(head.method, HttpMethod::HEAD);
+  EXPECT_EQ(head.uri, "/index.html");
+  EXPECT_EQ(head.httpVersion, HttpVersion::HTTP_1_1);
+}
+
+TEST(HttpParserTest, UncommonRequestLinesStillParse) {
+  const std::array<std::string, 4> requestLines = {
+      "GET  /a HTTP/1.1", "GET /a HTTP/1.1  ", "HEAD\t/a HTTP/1.1",
+      "GET /a  HTTP/1.1"};
+
+  for (const auto& line : requestLines) {
+    const HttpRequest req = HttpParser{line + "\r\n\r\n"}.parse();
+
+    EXPECT_EQ(req.uri, "/a") << line;
+    EXPECT_EQ(req.httpVersion, HttpVersion::HTTP_1_1) << line;
+  }
+}
+
+TEST(HttpParserTest, InvalidUriCharacters) {
+  const std::array<std::string, 2> uris = {"/a#b", "/caf\xC3\xA9"};
+
+  for (const auto& uri : uris) {
+    const std::string rawRequest = "GET " + uri + " HTTP/1.1\r\n\r\n";
+    EXPECT_THROW(const auto t = HttpParser{rawRequest}.parse(),
+                 std::runtime_error);
+  }
+}
@@ -0,0 +1,197 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "LingeringCloser.h"
+
+using namespace webserver::net;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Server end of a socket pair; only what the closer uses does anything.
+class PairSocket final : public ISocket {
+ public:
+  explicit PairSocket(int fd) : _fd{fd} {
+  }
+  PairSocket(const PairSocket &) = delete;
+  PairSocket(PairSocket &&) = delete;
+  PairSocket &operator=(const PairSocket &) = delete;
+  PairSocket &operator=(PairSocket &&) = delete;
+  ~PairSocket() override {
+    ::close(_fd);
+  }
+
+  void send(const std::string & /*data*/) override {
+    throw std::logic_error("blocking send used");
+  }
+  std::string receive() override {
+    throw std::logic_error("blocking receive used");
+  }
+  void sendZeroCopyFile(std::filesystem::path /*filePath*/) override {
+  }
+  void sendVectored(std::span<const std::string_view> /*parts*/) override {
+  }
+  void sendFileWithHead(std::string_view /*head*/,
+                        std::filesystem::path /*filePath*/) override {
+  }
+  void close() override {
+  }
+  void setTimeouts(const SocketTimeouts & /*timeouts*/) override {
+  }
+  void setRequestLimits(
+      const webserver::http::RequestLimits & /*limits*/) override {
+  }
+  int nativeHandle() const noexcept override {
+    return _fd;
+  }
+  void setNonBlocking() override {
+    ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) | O_NONBLOCK);
+  }
+  std::optional<std::size_t> receiveSome(std::span<char> buffer) override {
+    const auto bytesRead{::recv(_fd, buffer.data(), buffer.size(), 0)};
+
+    if (bytesRead < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return std::nullopt;
+      }
+
+      throw std::runtime_error("recv() failed");
+    }
+
+    return static_cast<std::size_t>(bytesRead);
+  }
+  std::optional<std::size_t> sendSome(std::span<const char> data,
+                                      bool /*moreFollows*/) override {
+    const auto bytesSent{::send(_fd, data.data(), data.size(), MSG_NOSIGNAL)};
+
+    if (bytesSent < 0) {
+      return std::nullopt;
+    }
+
+    return static_cast<std::size_t>(bytesSent);
+  }
+  std::optional<std::size_t> sendFileSome(int /*fileFd*/,
+                                          std::int64_t & /*offset*/,
+                                          std::size_t /*count*/) override {
+    return std::nullopt;
+  }
+  std::uint32_t zeroCopyIssued() const noexcept override {
+    return 0;
+  }
+  std::uint32_t reapZeroCopyCompletions() override {
+    return 0;
+  }
+  std::optional<int> incomingCpu() const noexcept override {
+    return std::nullopt;
+  }
+  std::optional<IpAddress> peerAddress() const noexcept override {
+    return std::nullopt;
+  }
+
+ private:
+  int _fd;
+};
+
+// Connected pair: the server end wrapped for the closer, the client end raw.
+std::pair<std::unique_ptr<ISocket>, int> connectedPair() {
+  std::array<int, 2> fds{};
+
+  if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) != 0) {
+    throw std::runtime_error("socketpair() failed");
+  }
+
+  return {std::make_unique<PairSocket>(fds[0]), fds[1]};
+}
+
+// Everything the client receives until the server's end is shut down.
+std::string readAll(const int fd) {
+  std::string result;
+  std::array<char, 256> buffer{};
+
+  while (true) {
+    const auto bytesRead{::recv(fd, buffer.data(), buffer.size(), 0)};
+
+    if (bytesRead <= 0) {
+      return result;
+    }
+
+    result.append(buffer.data(), static_cast<std::size_t>(bytesRead));
+  }
+}
+
+bool waitUntilEmpty(const LingeringCloser &closer) {
+  const auto deadline{std::chrono::steady_clock::now() + 2s};
+
+  while (closer.size() > 0) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+
+    std::this_thread::sleep_for(10ms);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+TEST(LingeringCloserTest, AnswersAndClosesOnceTheClientDoes) {
+  LingeringCloser closer{{.timeout = 10s}};
+  auto [socket, clientFd] = connectedPair();
+
+  closer.close(std::move(socket), "HTTP/1.1 429 Too Many Requests\r\n\r\n");
+  EXPECT_EQ(readAll(clientFd), "HTTP/1.1 429 Too Many Requests\r\n\r\n");
+  EXPECT_EQ(closer.size(), 1);
+
+  // The request arrives late and is read and dropped.
+  const std::string request{"GET / HTTP/1.1\r\n\r\n"};
+  ASSERT_EQ(::send(clientFd, request.data(), request.size(), 0),
+            static_cast<ssize_t>(request.size()));
+  std::this_thread::sleep_for(200ms);
+  EXPECT_EQ(closer.size(), 1);
+
+  ::shutdown(clientFd, SHUT_WR);
+  EXPECT_TRUE(waitUntilEmpty(closer));
+  ::close(clientFd);
+}
+
+TEST(LingeringCloserTest, ClosesSilentClientsAfterTimeout) {
+  LingeringCloser closer{{.timeout = 100ms}};
+  auto [socket, clientFd] = connectedPair();
+
+  closer.close(std::move(socket), "response");
+  EXPECT_EQ(closer.size(), 1);
+  EXPECT_TRUE(waitUntilEmpty(closer));
+  ::close(clientFd);
+}
+
+TEST(LingeringCloserTest, StopsReadingAtByteLimit) {
+  LingeringCloser closer{{.timeout = 10s, .maxBytes = 1024}};
+  auto [socket, clientFd] = connectedPair();
+
+  closer.close(std::move(socket), "response");
+  const std::string upload(4096, 'x');
+  ::send(clientFd, upload.data(), upload.size(), MSG_DONTWAIT);
+
+  EXPECT_TRUE(waitUntilEmpty(closer));
+  ::close(clientFd);
+}
+
+TEST(LingeringCloserTest, ClosesRightAwayWhenFull) {
+  LingeringCloser closer{{.maxSockets = 0}};
+  auto [socket, clientFd] = connectedPair();
+
+  closer.close(std::move(socket), "response");
+  EXPECT_EQ(closer.size(), 0);
+  EXPECT_EQ(readAll(clientFd), "response");
+  ::close(clientFd);
+}
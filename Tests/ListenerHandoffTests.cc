@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <string>
+
+#include "ListenerHandoff.h"
+
+using webserver::net::ListenerHandoff;
+
+namespace {
+
+std::filesystem::path controlPath(const std::string &name) {
+  return std::filesystem::temp_directory_path() /
+         (name + "." + std::to_string(::getpid()) + ".handoff");
+}
+
+// Whether two descriptors refer to the same open socket.
+bool sameSocket(const int first, const int second) {
+  struct stat firstStat{};
+  struct stat secondStat{};
+  return ::fstat(first, &firstStat) == 0 && ::fstat(second, &secondStat) == 0 &&
+         firstStat.st_ino == secondStat.st_ino;
+}
+
+}  // namespace
+
+TEST(ListenerHandoff, FirstInstanceReceivesNothing) {
+  const auto path{controlPath("first")};
+  ListenerHandoff handoff{path};
+
+  EXPECT_TRUE(handoff.takeOver().empty());
+  EXPECT_TRUE(std::filesystem::exists(path));
+
+  handoff.confirmTakeOver();  // no predecessor to notify
+  EXPECT_FALSE(handoff.serve({}, std::chrono::milliseconds{10}));
+
+  std::filesystem::remove(path);
+}
+
+TEST(ListenerHandoff, PassesListenersToSuccessor) {
+  const auto path{controlPath("pass")};
+  const auto listenerFd{::socket(AF_INET, SOCK_STREAM, 0)};
+  ASSERT_GE(listenerFd, 0);
+
+  ListenerHandoff current{path};
+  ASSERT_TRUE(current.takeOver().empty());
+
+  auto served{std::async(std::launch::async, [&current, listenerFd] {
+    return current.serve({{"0 [::]:8000", listenerFd}},
+                         std::chrono::seconds{5});
+  })};
+
+  ListenerHandoff successor{path};
+  auto listeners{successor.takeOver()};
+
+  ASSERT_EQ(listeners.size(), 1U);
+  ASSERT_TRUE(listeners.contains("0 [::]:8000"));
+  EXPECT_NE(listeners.at("0 [::]:8000"), listenerFd);
+  EXPECT_TRUE(sameSocket(listeners.at("0 [::]:8000"), listenerFd));
+
+  successor.confirmTakeOver();
+  EXPECT_TRUE(served.get());
+
+  ListenerHandoff::closeAll(listeners);
+  EXPECT_TRUE(listeners.empty());
+  ::close(listenerFd);
+  std::filesystem::remove(path);
+}
+
+TEST(ListenerHandoff, UnconfirmedSuccessorLeavesListenersInPlace) {
+  const auto path{controlPath("abort")};
+  const auto listenerFd{::socket(AF_INET, SOCK_STREAM, 0)};
+  ASSERT_GE(listenerFd, 0);
+
+  ListenerHandoff current{path};
+  ASSERT_TRUE(current.takeOver().empty());
+
+  auto served{std::async(std::launch::async, [&current, listenerFd] {
+    return current.serve({{"0 [::]:8000", listenerFd}},
+                         std::chrono::seconds{5});
+  })};
+
+  {
+    // Gives up before confirming, e.g. because its configuration is broken.
+    ListenerHandoff successor{path};
+    auto listeners{successor.takeOver()};
+    ListenerHandoff::closeAll(listeners);
+  }
+
+  EXPECT_FALSE(served.get());
+
+  ::close(listenerFd);
+  std::filesystem::remove(path);
+}
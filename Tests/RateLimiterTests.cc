@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include "IpAddress.h"
+#include "RateLimiter.h"
+
+using namespace webserver::core;
+using webserver::net::IpAddress;
+using namespace std::chrono_literals;
+
+namespace {
+
+const auto kNow{RateLimiter::Clock::time_point{} + 1h};
+const auto kClient{IpAddress::fromV4(0x0a000001)};  // 10.0.0.1
+const auto kOtherClient{IpAddress::fromV4(0x0a000002)};
+
+}  // namespace
+
+TEST(RateLimiter, AllowsBurstThenRejects) {
+  RateLimiter limiter{{.enabled = true, .ratePerSecond = 1, .burst = 3}};
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(limiter.tryAcquire(kClient, kNow)) << i;
+  }
+
+  EXPECT_FALSE(limiter.tryAcquire(kClient, kNow));
+  EXPECT_EQ(limiter.rejectedCount(), 1U);
+}
+
+TEST(RateLimiter, RefillsAtConfiguredRate) {
+  RateLimiter limiter{{.enabled = true, .ratePerSecond = 10, .burst = 1}};
+
+  EXPECT_TRUE(limiter.tryAcquire(kClient, kNow));
+  EXPECT_FALSE(limiter.tryAcquire(kClient, kNow + 50ms));
+  EXPECT_TRUE(limiter.tryAcquire(kClient, kNow + 100ms));
+  // Idle time never builds up more than the burst.
+  EXPECT_TRUE(limiter.tryAcquire(kClient, kNow + 10s));
+  EXPECT_FALSE(limiter.tryAcquire(kClient, kNow + 10s));
+}
+
+TEST(RateLimiter, ClientsHaveSeparateBuckets) {
+  RateLimiter limiter{{.enabled = true, .ratePerSecond = 1, .burst = 1}};
+
+  EXPECT_TRUE(limiter.tryAcquire(kClient, kNow));
+  EXPECT_FALSE(limiter.tryAcquire(kClient, kNow));
+  EXPECT_TRUE(limiter.tryAcquire(kOtherClient, kNow));
+}
+
+TEST(RateLimiter, EvictsLeastRecentlySeenClients) {
+  constexpr std::size_t kMaxClients = 128;
+  RateLimiter limiter{{.enabled = true,
+                       .ratePerSecond = 1,
+                       .burst = 1,
+                       .maxClients = kMaxClients}};
+
+  for (std::uint32_t i = 0; i < 10 * kMaxClients; ++i) {
+    static_cast<void>(limiter.tryAcquire(IpAddress::fromV4(i), kNow));
+  }
+
+  EXPECT_LE(limiter.trackedClients(), kMaxClients);
+  // The first client was evicted long ago and starts over with a full bucket.
+  EXPECT_TRUE(limiter.tryAcquire(IpAddress::fromV4(0), kNow));
+}
+
+TEST(RateLimiter, DisabledLimiterAllowsEverything) {
+  RateLimiter limiter{{.enabled = false, .ratePerSecond = 1, .burst = 1}};
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(limiter.tryAcquire(kClient, kNow));
+  }
+
+  EXPECT_EQ(limiter.trackedClients(), 0U);
+}
+
+TEST(IpAddress, ParsesAndFormatsBothFamilies) {
+  const auto v4{IpAddress::parse("192.168.1.20")};
+  ASSERT_TRUE(v4.has_value());
+  EXPECT_TRUE(v4->isV4());
+  EXPECT_EQ(v4->toString(), "192.168.1.20");
+  EXPECT_EQ(*v4, IpAddress::fromV4(0xc0a80114));
+
+  const auto v6{IpAddress::parse("2001:db8::1")};
+  ASSERT_TRUE(v6.has_value());
+  EXPECT_FALSE(v6->isV4());
+  EXPECT_EQ(v6->toString(), "2001:db8::1");
+
+  // IPv4-mapped IPv6 is the same peer as plain IPv4.
+  EXPECT_EQ(IpAddress::parse("::ffff:192.168.1.20"), v4);
+  EXPECT_FALSE(IpAddress::parse("not an address").has_value());
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "BufferPool.h"
+#include "RequestBuffer.h"
+
+using namespace webserver;
+using namespace webserver::http;
+
+TEST(RequestBufferTest, FindsTerminatorSplitAcrossReads) {
+  utils::BufferPool pool{64, 4};
+  RequestBuffer buffer{pool};
+
+  buffer.append("GET / HTTP/1.1\r\nHost: x\r\n\r");
+  EXPECT_FALSE(buffer.hasCompleteHeaders());
+
+  buffer.append("\n");
+  EXPECT_TRUE(buffer.hasCompleteHeaders());
+  EXPECT_EQ(buffer.takeRequest(), "GET / HTTP/1.1\r\nHost: x\r\n\r\n");
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(RequestBufferTest, WritesIntoPreparedSpace) {
+  utils::BufferPool pool{64, 4};
+  RequestBuffer buffer{pool};
+
+  const std::string data{"GET / HTTP/1.1\r\n\r\n"};
+  const auto space{buffer.prepareWrite(data.size())};
+  ASSERT_GE(space.size(), data.size());
+
+  std::memcpy(space.data(), data.data(), data.size());
+  buffer.commitWrite(data.size());
+
+  EXPECT_TRUE(buffer.hasCompleteHeaders());
+  EXPECT_EQ(buffer.view(), data);
+}
+
+TEST(RequestBufferTest, GrowsBeyondPoolBufferSize) {
+  utils::BufferPool pool{16, 4};
+  RequestBuffer buffer{pool};
+
+  const std::string header(100, 'a');
+  buffer.append("GET / HTTP/1.1\r\nX: ");
+  buffer.append(header);
+  buffer.append("\r\n\r\n");
+
+  EXPECT_GT(buffer.capacity(), pool.bufferSize());
+  EXPECT_TRUE(buffer.hasCompleteHeaders());
+  EXPECT_EQ(buffer.takeRequest(), "GET / HTTP/1.1\r\nX: " + header + "\r\n\r\n");
+}
+
+TEST(RequestBufferTest, ReturnsStorageToPoolWhenIdle) {
+  utils::BufferPool pool{64, 4};
+  RequestBuffer buffer{pool};
+
+  buffer.append("GET /");
+  EXPECT_EQ(pool.idleCount(), 0);
+
+  buffer.release();  // still holds a partial request
+  EXPECT_EQ(buffer.capacity(), 64);
+
+  static_cast<void>(buffer.takeRequest());
+  buffer.release();
+  EXPECT_EQ(buffer.capacity(), 0);
+  EXPECT_EQ(pool.idleCount(), 1);
+
+  buffer.append("GET /");  // reuses the pooled buffer
+  EXPECT_EQ(pool.idleCount(), 0);
+}
+
+TEST(BufferPoolTest, KeepsAtMostMaxIdleBuffers) {
+  utils::BufferPool pool{32, 1};
+
+  auto first{pool.acquire()};
+  auto second{pool.acquire()};
+  pool.release(std::move(first));
+  pool.release(std::move(second));
+
+  EXPECT_EQ(pool.idleCount(), 1);
+}
+
+TEST(RequestBufferTest, KeepsPipelinedRequestsApart) {
+  utils::BufferPool pool{64, 4};
+  RequestBuffer buffer{pool};
+
+  buffer.append(
+      "GET /a HTTP/1.1\r\n\r\n"
+      "POST /b HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+      "GET /c");
+
+  ASSERT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.takeRequest(), "GET /a HTTP/1.1\r\n\r\n");
+
+  ASSERT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.takeRequest(),
+            "POST /b HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello");
+
+  EXPECT_FALSE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.view(), "GET /c");
+
+  buffer.append(" HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.takeRequest(), "GET /c HTTP/1.1\r\n\r\n");
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(RequestBufferTest, WaitsForWholeBody) {
+  utils::BufferPool pool{64, 4};
+  RequestBuffer buffer{pool};
+
+  buffer.append("POST / HTTP/1.1\r\ncontent-length:  4\r\n\r\nab");
+  EXPECT_TRUE(buffer.hasCompleteHeaders());
+  EXPECT_FALSE(buffer.hasCompleteRequest());
+
+  buffer.append("cd");
+  EXPECT_TRUE(buffer.hasCompleteRequest());
+}
+
+TEST(RequestBufferTest, RejectsConflictingContentLength) {
+  utils::BufferPool pool{128, 4};
+  RequestBuffer buffer{pool};
+
+  buffer.append(
+      "POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n");
+
+  EXPECT_THROW(static_cast<void>(buffer.hasCompleteRequest()),
+               std::runtime_error);
+}
+
+TEST(RequestBufferTest, RejectsTransferEncoding) {
+  utils::BufferPool pool{128, 4};
+  RequestBuffer buffer{pool};
+
+  // Without the rejection the chunked body would be served as a second,
+  // smuggled request.
+  buffer.append(
+      "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+      "1c\r\nGET /admin HTTP/1.1\r\n\r\n\r\n0\r\n\r\n");
+
+  EXPECT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.rejection(), StatusCode::HTTP_501_NOT_IMPLEMENTED);
+  EXPECT_THROW(static_cast<void>(buffer.takeRequest()), RequestRejected);
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(RequestBufferTest, RejectsLongRequestLineBeforeItEnds) {
+  utils::BufferPool pool{64, 4};
+  RequestBuffer buffer{pool};
+  buffer.setLimits({.maxRequestLineSize = 32});
+
+  buffer.append("GET /" + std::string(40, 'a'));
+
+  EXPECT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.rejection(), StatusCode::HTTP_414_URI_TOO_LONG);
+  EXPECT_THROW(static_cast<void>(buffer.takeRequest()), RequestRejected);
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(RequestBufferTest, RejectsTooManyHeaders) {
+  utils::BufferPool pool{256, 4};
+  RequestBuffer buffer{pool};
+  buffer.setLimits({.maxHeaderCount = 2});
+
+  buffer.append("GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\n");
+  EXPECT_FALSE(buffer.hasCompleteRequest());
+
+  buffer.append("C: 3\r\n\r\n");
+  EXPECT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.rejection(),
+            StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE);
+}
+
+TEST(RequestBufferTest, RejectsOversizedHeaderLineAndHead) {
+  utils::BufferPool pool{256, 4};
+  RequestBuffer lineBuffer{pool};
+  lineBuffer.setLimits({.maxHeaderLineSize = 16});
+
+  lineBuffer.append("GET / HTTP/1.1\r\nX: " + std::string(20, 'x'));
+  EXPECT_TRUE(lineBuffer.hasCompleteRequest());
+  EXPECT_EQ(lineBuffer.rejection(),
+            StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE);
+
+  RequestBuffer headBuffer{pool};
+  headBuffer.setLimits({.maxHeadersSize = 40});
+
+  headBuffer.append("GET / HTTP/1.1\r\nA: 1234567890\r\nB: 1234567890\r\n");
+  EXPECT_TRUE(headBuffer.hasCompleteRequest());
+  EXPECT_EQ(headBuffer.rejection(),
+            StatusCode::HTTP_431_REQUEST_HEADER_FIELDS_TOO_LARGE);
+}
+
+TEST(RequestBufferTest, RejectsBodyOverLimitBeforeItArrives) {
+  utils::BufferPool pool{128, 4};
+  RequestBuffer buffer{pool};
+  buffer.setLimits({.maxBodySize = 10});
+
+  buffer.append("POST / HTTP/1.1\r\nContent-Length: 11\r\n\r\n");
+
+  EXPECT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_EQ(buffer.rejection(), StatusCode::HTTP_413_PAYLOAD_TOO_LARGE);
+}
+
+TEST(RequestBufferTest, AcceptsRequestAtTheLimits) {
+  utils::BufferPool pool{128, 4};
+  RequestBuffer buffer{pool};
+  const std::string request{"GET / HTTP/1.1\r\nHost: x\r\n\r\n"};
+  buffer.setLimits({.maxRequestLineSize = 16,
+                    .maxHeaderLineSize = 9,
+                    .maxHeadersSize = request.size(),
+                    .maxHeaderCount = 1});
+
+  buffer.append(request);
+
+  EXPECT_TRUE(buffer.hasCompleteRequest());
+  EXPECT_FALSE(buffer.rejection().has_value());
+  EXPECT_EQ(buffer.takeRequest(), request);
+}
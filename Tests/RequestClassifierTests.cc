@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "RequestClassifier.h"
+
+using namespace webserver::core;
+
+TEST(RequestClassifier, EverythingIsInteractiveWithoutRules) {
+  const RequestClassifier classifier{{}};
+
+  EXPECT_TRUE(classifier.empty());
+  EXPECT_EQ(classifier.classify("GET /iso/big.img HTTP/1.1\r\n\r\n"),
+            Lane::INTERACTIVE);
+}
+
+TEST(RequestClassifier, MatchesPathPrefixesAfterNormalising) {
+  const RequestClassifier classifier{
+      {.pathPrefixes = {"/downloads/", "/iso/"}, .methods = {}}};
+
+  EXPECT_EQ(classifier.classify("GET /downloads/a.tar HTTP/1.1\r\n\r\n"),
+            Lane::BULK);
+  EXPECT_EQ(classifier.classify("GET /./iso/b.img?x=1 HTTP/1.1\r\n\r\n"),
+            Lane::BULK);
+  EXPECT_EQ(classifier.classify("GET /index.html HTTP/1.1\r\n\r\n"),
+            Lane::INTERACTIVE);
+  EXPECT_EQ(classifier.classify("GET /downloads"), Lane::INTERACTIVE);
+}
+
+TEST(RequestClassifier, MatchesMethods) {
+  const RequestClassifier classifier{
+      {.pathPrefixes = {}, .methods = {"PUT", "POST"}}};
+
+  EXPECT_EQ(classifier.classify("PUT /upload HTTP/1.1\r\n\r\n"), Lane::BULK);
+  EXPECT_EQ(classifier.classify("GET /upload HTTP/1.1\r\n\r\n"),
+            Lane::INTERACTIVE);
+  EXPECT_THROW(RequestClassifier({.pathPrefixes = {}, .methods = {"FETCH"}}),
+               std::invalid_argument);
+}
+
+TEST(RequestClassifier, MatchesLargeFiles) {
+  const auto directory{std::filesystem::temp_directory_path() /
+                       "request_classifier_test"};
+  std::filesystem::create_directories(directory);
+  std::ofstream{directory / "small.html"} << "<p>hi</p>";
+  std::ofstream{directory / "large.bin"} << std::string(4096, 'x');
+
+  const RequestClassifier classifier{{.pathPrefixes = {},
+                                      .methods = {},
+                                      .minFileSize = 1024,
+                                      .contentDirectory = directory}};
+
+  EXPECT_EQ(classifier.classify("GET /large.bin HTTP/1.1\r\n\r\n"),
+            Lane::BULK);
+  EXPECT_EQ(classifier.classify("GET /small.html HTTP/1.1\r\n\r\n"),
+            Lane::INTERACTIVE);
+  EXPECT_EQ(classifier.classify("GET /missing HTTP/1.1\r\n\r\n"),
+            Lane::INTERACTIVE);
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "Task.h"
+#include "ThreadPool.h"
+
+using webserver::core::Task;
+using webserver::core::ThreadPool;
+
+namespace {
+
+// Counts live instances to check that moves neither leak nor double-free.
+struct Tracked {
+  explicit Tracked(int &live) : live{&live} {
+    ++live;
+  }
+  Tracked(Tracked &&other) noexcept : live{other.live} {
+    ++*live;
+  }
+  Tracked(const Tracked &) = delete;
+  Tracked &operator=(const Tracked &) = delete;
+  Tracked &operator=(Tracked &&) = delete;
+  ~Tracked() {
+    --*live;
+  }
+
+  int *live;
+};
+
+}  // namespace
+
+TEST(Task, HoldsMoveOnlyCapturesInline) {
+  auto value{std::make_unique<int>(41)};
+  int result{0};
+  auto func{[value = std::move(value), &result] { result = *value + 1; }};
+
+  static_assert(Task::storesInline<decltype(func)>());
+  Task task{std::move(func)};
+
+  ASSERT_TRUE(task);
+  task();
+  EXPECT_EQ(result, 42);
+}
+
+TEST(Task, FallsBackToHeapForLargeCallables) {
+  std::array<char, Task::kInlineSize + 1> payload{};
+  payload.back() = 'x';
+  char seen{0};
+  auto func{[payload, &seen] { seen = payload.back(); }};
+
+  static_assert(!Task::storesInline<decltype(func)>());
+  Task task{func};
+  Task moved{std::move(task)};
+
+  EXPECT_FALSE(task);  // NOLINT(bugprone-use-after-move)
+  moved();
+  EXPECT_EQ(seen, 'x');
+}
+
+TEST(Task, DestroysCallableExactlyOnce) {
+  int live{0};
+
+  {
+    Task task{[tracked = Tracked{live}] {}};
+    EXPECT_EQ(live, 1);
+
+    Task other{std::move(task)};
+    EXPECT_EQ(live, 1);
+
+    Task assigned;
+    assigned = std::move(other);
+    EXPECT_EQ(live, 1);
+
+    assigned = Task{[tracked = Tracked{live}] {}};
+    EXPECT_EQ(live, 1);
+  }
+
+  EXPECT_EQ(live, 0);
+}
+
+TEST(Task, InvokingEmptyTaskThrows) {
+  Task task;
+  EXPECT_FALSE(task);
+  EXPECT_THROW(task(), std::logic_error);
+}
+
+TEST(ThreadPool, SubmitRunsMoveOnlyTasks) {
+  std::atomic<int> sum{0};
+
+  {
+    ThreadPool pool{2};
+
+    for (int i = 1; i <= 100; ++i) {
+      pool.submit([value = std::make_unique<int>(i), &sum] {
+        sum.fetch_add(*value);
+      });
+    }
+  }
+
+  EXPECT_EQ(sum.load(), 5050);
+}
@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "WorkQueue.h"
+
+using namespace webserver::core;
+
+TEST(WorkQueue, PopsInFifoOrderAndReportsFull) {
+  WorkQueue<int> queue{3};  // rounded up to 4
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.tryPush(int{i}));
+  }
+
+  auto rejected{42};
+  EXPECT_FALSE(queue.tryPush(std::move(rejected)));
+  EXPECT_TRUE(queue.hasWork());
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(queue.tryPop(), i);
+  }
+
+  EXPECT_FALSE(queue.tryPop().has_value());
+  EXPECT_FALSE(queue.hasWork());
+}
+
+TEST(WorkQueue, DeliversEveryItemOnceAcrossThreads) {
+  constexpr int kProducers = 4;
+  constexpr int kItemsPerProducer = 20000;
+
+  WorkQueue<int> queue{64};
+  std::atomic<long long> sum{0};
+  std::atomic<int> popped{0};
+  std::vector<std::jthread> threads;
+
+  for (int p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&queue, p] {
+      for (int i = 1; i <= kItemsPerProducer; ++i) {
+        auto item{(p * kItemsPerProducer) + i};
+        while (!queue.tryPush(std::move(item))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&] {
+      while (popped.load() < kProducers * kItemsPerProducer) {
+        if (const auto item{queue.tryPop()}) {
+          sum.fetch_add(*item);
+          popped.fetch_add(1);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  threads.clear();
+
+  const long long total{static_cast<long long>(kProducers) * kItemsPerProducer};
+  EXPECT_EQ(popped.load(), total);
+  EXPECT_EQ(sum.load(), total * (total + 1) / 2);
+}
+
+TEST(ThreadPool, RunsTasksAndReturnsResults) {
+  ThreadPool pool{4};
+  std::vector<std::future<int>> results;
+
+  for (int i = 0; i < 1000; ++i) {
+    results.push_back(pool.enqueue([](int value) { return value * 2; }, i));
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(results[i].get(), i * 2);
+  }
+}
+
+TEST(ThreadPool, IdleWorkersStealFromBusyOne) {
+  constexpr int kWorkers = 4;
+  ThreadPool pool{kWorkers};
+
+  // Every task is submitted from one worker, so all of them land in its
+  // queue; they can only finish together if other workers steal them.
+  std::latch allRunning{kWorkers};
+  std::mutex idsMutex;
+  std::set<std::thread::id> ids;
+
+  pool.enqueue([&] {
+        for (int i = 0; i < kWorkers; ++i) {
+          pool.enqueue([&] {
+            {
+              std::lock_guard<std::mutex> lock{idsMutex};
+              ids.insert(std::this_thread::get_id());
+            }
+            allRunning.arrive_and_wait();
+          });
+        }
+      })
+      .get();
+
+  pool.stop();
+  EXPECT_EQ(ids.size(), static_cast<std::size_t>(kWorkers));
+}
+
+TEST(ThreadPool, QueuesBeyondCapacityWhileWorkersAreBusy) {
+  ThreadPool pool{2};
+  std::promise<void> release;
+  const auto released{release.get_future().share()};
+  std::atomic<int> done{0};
+
+  for (int i = 0; i < 2; ++i) {
+    pool.enqueue([released] { released.wait(); });
+  }
+
+  // More than the per-worker queues hold: the rest spills over.
+  for (int i = 0; i < 5000; ++i) {
+    pool.enqueue([&done] { done.fetch_add(1); });
+  }
+
+  release.set_value();
+  pool.stop();
+  EXPECT_EQ(done.load(), 5000);
+}
+
+TEST(ThreadPool, StopRunsQueuedTasksThenRejectsNewOnes) {
+  std::atomic<int> done{0};
+  ThreadPool pool{1};
+
+  for (int i = 0; i < 100; ++i) {
+    pool.enqueue([&done] { done.fetch_add(1); });
+  }
+
+  pool.stop();
+  EXPECT_EQ(done.load(), 100);
+  EXPECT_THROW(pool.enqueue([] {}), std::runtime_error);
+}
+
+TEST(ThreadPool, RunsStartHookOnEveryWorkerBeforeReturning) {
+  std::mutex mutex;
+  std::set<int> started;
+
+  ThreadPool pool{4, [&](const int workerIndex) {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    started.insert(workerIndex);
+                  }};
+
+  std::lock_guard<std::mutex> lock{mutex};
+  EXPECT_EQ(started, (std::set<int>{0, 1, 2, 3}));
+}
+
+TEST(ThreadPool, ElasticPoolGrowsWhileWorkersAreBlocked) {
+  constexpr int kWorkers = 3;
+  ThreadPool pool{ThreadPool::Options{.minThreads = 1,
+                                      .maxThreads = kWorkers,
+                                      .growDelay = std::chrono::milliseconds{5},
+                                      .shrinkDelay = std::chrono::minutes{1}}};
+  std::latch allRunning{kWorkers};
+  std::vector<std::future<void>> results;
+
+  // These only finish once all of them run at the same time.
+  for (int i = 0; i < kWorkers; ++i) {
+    results.push_back(pool.enqueue([&allRunning] {
+      allRunning.arrive_and_wait();
+    }));
+  }
+  for (auto &result : results) {
+    result.get();
+  }
+
+  EXPECT_EQ(pool.size(), static_cast<std::size_t>(kWorkers));
+  EXPECT_EQ(pool.grownCount(), 2U);
+  EXPECT_EQ(pool.retiredCount(), 0U);
+}
+
+TEST(ThreadPool, ElasticPoolRetiresIdleWorkersDownToMinimum) {
+  ThreadPool pool{ThreadPool::Options{.minThreads = 1,
+                                      .maxThreads = 2,
+                                      .growDelay = std::chrono::milliseconds{5},
+                                      .shrinkDelay =
+                                          std::chrono::milliseconds{20}}};
+  std::latch bothRunning{2};
+
+  auto first{pool.enqueue([&bothRunning] { bothRunning.arrive_and_wait(); })};
+  auto second{pool.enqueue([&bothRunning] { bothRunning.arrive_and_wait(); })};
+  first.get();
+  second.get();
+  ASSERT_EQ(pool.size(), 2U);
+
+  const auto deadline{std::chrono::steady_clock::now() +
+                      std::chrono::seconds{10}};
+  while (pool.size() > 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  }
+
+  EXPECT_EQ(pool.size(), 1U);
+  EXPECT_EQ(pool.retiredCount(), 1U);
+  // The remaining worker also picks up what lands in the retired one's queue.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(pool.enqueue([i] { return i; }).get(), i);
+  }
+}
+
+TEST(ThreadPool, RejectsInvalidBounds) {
+  EXPECT_THROW(ThreadPool{0}, std::invalid_argument);
+  EXPECT_THROW(
+      (ThreadPool{ThreadPool::Options{.minThreads = 2, .maxThreads = 1}}),
+      std::invalid_argument);
+}
+
+TEST(ThreadPool, BulkTasksLeaveReservedWorkersToInteractiveOnes) {
+  ThreadPool pool{ThreadPool::Options{.minThreads = 2, .maxThreads = 2}};
+  std::promise<void> release;
+  const auto released{release.get_future().share()};
+  std::atomic<int> runningBulk{0};
+  std::atomic<int> maxRunningBulk{0};
+  std::atomic<int> bulkDone{0};
+
+  for (int i = 0; i < 3; ++i) {
+    pool.submit(Lane::BULK, [&, released] {
+      maxRunningBulk.store(std::max(maxRunningBulk.load(), ++runningBulk));
+      released.wait();
+      --runningBulk;
+      ++bulkDone;
+    });
+  }
+
+  // One worker is kept for interactive tasks even with bulk ones queued.
+  auto interactive{pool.enqueue([] { return 42; })};
+  ASSERT_EQ(interactive.wait_for(std::chrono::seconds{10}),
+            std::future_status::ready);
+  EXPECT_EQ(interactive.get(), 42);
+
+  release.set_value();
+  pool.stop();
+  EXPECT_EQ(bulkDone.load(), 3);
+  EXPECT_EQ(maxRunningBulk.load(), 1);
+}
+
+TEST(ThreadPool, SharesWorkersBetweenLanesByWeight) {
+  ThreadPool pool{ThreadPool::Options{.minThreads = 1,
+                                      .maxThreads = 1,
+                                      .interactiveWeight = 2,
+                                      .bulkWeight = 1,
+                                      .interactiveReserve = 0}};
+  std::promise<void> release;
+  std::vector<Lane> order;
+
+  pool.submit([released = release.get_future().share()] { released.wait(); });
+
+  for (int i = 0; i < 6; ++i) {
+    pool.submit(Lane::BULK, [&order] { order.push_back(Lane::BULK); });
+    pool.submit([&order] { order.push_back(Lane::INTERACTIVE); });
+  }
+
+  release.set_value();
+  pool.stop();
+
+  // Interactive tasks go first two to one, but bulk ones still get turns.
+  ASSERT_EQ(order.size(), 12U);
+  EXPECT_EQ(std::ranges::count(order.begin(), order.begin() + 6, Lane::BULK),
+            2);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "TimerWheel.h"
+
+using namespace webserver::core;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Timer : TimerNode {
+  int id{};
+};
+
+const auto kStart{TimerWheel::Clock::time_point{} + 1h};
+
+std::vector<int> advanceTo(TimerWheel &wheel,
+                           std::chrono::milliseconds elapsed) {
+  std::vector<int> expired;
+  wheel.advance(kStart + elapsed, [&](TimerNode &node) {
+    expired.push_back(static_cast<Timer &>(node).id);
+  });
+  return expired;
+}
+
+}  // namespace
+
+TEST(TimerWheel, FiresOnlyOnceDeadlineHasPassed) {
+  TimerWheel wheel{10ms, kStart};
+  Timer timer;
+  timer.id = 1;
+
+  wheel.arm(timer, 100ms, kStart);
+
+  EXPECT_TRUE(advanceTo(wheel, 99ms).empty());
+  EXPECT_TRUE(timer.isArmed());
+  EXPECT_EQ(advanceTo(wheel, 110ms), std::vector<int>{1});
+  EXPECT_FALSE(timer.isArmed());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, CancelledTimerDoesNotFire) {
+  TimerWheel wheel{10ms, kStart};
+  Timer timer;
+
+  wheel.arm(timer, 50ms, kStart);
+  wheel.cancel(timer);
+
+  EXPECT_FALSE(timer.isArmed());
+  EXPECT_EQ(wheel.size(), 0U);
+  EXPECT_TRUE(advanceTo(wheel, 1s).empty());
+}
+
+TEST(TimerWheel, RearmMovesDeadline) {
+  TimerWheel wheel{10ms, kStart};
+  Timer timer;
+  timer.id = 7;
+
+  wheel.arm(timer, 50ms, kStart);
+  wheel.arm(timer, 200ms, kStart + 40ms);
+
+  EXPECT_EQ(wheel.size(), 1U);
+  EXPECT_TRUE(advanceTo(wheel, 100ms).empty());
+  EXPECT_EQ(advanceTo(wheel, 250ms), std::vector<int>{7});
+}
+
+TEST(TimerWheel, CascadesFarTimersThroughAllLevels) {
+  TimerWheel wheel{1ms, kStart};
+  // One timer per level: root (< 256 ticks), then 64-slot levels above.
+  std::vector<Timer> timers(4);
+  const std::vector<std::chrono::milliseconds> timeouts{
+      200ms, 5'000ms, 300'000ms, 20'000'000ms};
+
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    timers.at(i).id = static_cast<int>(i);
+    wheel.arm(timers.at(i), timeouts.at(i), kStart);
+  }
+
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    EXPECT_TRUE(advanceTo(wheel, timeouts.at(i) - 1ms).empty()) << i;
+    EXPECT_EQ(advanceTo(wheel, timeouts.at(i) + 1ms),
+              std::vector<int>{static_cast<int>(i)})
+        << i;
+  }
+}
+
+TEST(TimerWheel, ExpiresBatchInOneAdvance) {
+  TimerWheel wheel{10ms, kStart};
+  std::vector<Timer> timers(100);
+
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    timers.at(i).id = static_cast<int>(i);
+    wheel.arm(timers.at(i), std::chrono::milliseconds{10 * (i % 5)}, kStart);
+  }
+
+  EXPECT_EQ(advanceTo(wheel, 100ms).size(), timers.size());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, CallbackMayCancelPendingTimer) {
+  TimerWheel wheel{10ms, kStart};
+  Timer first;
+  Timer second;
+  first.id = 1;
+  second.id = 2;
+
+  wheel.arm(first, 20ms, kStart);
+  wheel.arm(second, 20ms, kStart);
+
+  std::vector<int> expired;
+  wheel.advance(kStart + 50ms, [&](TimerNode &node) {
+    auto &timer{static_cast<Timer &>(node)};
+    expired.push_back(timer.id);
+    wheel.cancel(timer.id == 1 ? second : first);
+  });
+
+  EXPECT_EQ(expired, std::vector<int>{1});
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, DestroyedNodeLeavesWheel) {
+  TimerWheel wheel{10ms, kStart};
+
+  {
+    Timer timer;
+    wheel.arm(timer, 20ms, kStart);
+    EXPECT_EQ(wheel.size(), 1U);
+  }
+
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_TRUE(advanceTo(wheel, 1s).empty());
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "BufferPool.h"
+#include "Utils.h"
+
+using namespace webserver::utils;
+
+TEST(CpuListTest, ParsesRangesAndSingleCpus) {
+  EXPECT_EQ(parseCpuList("0-3,8,10-11"),
+            (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(parseCpuList("5"), (std::vector<int>{5}));
+}
+
+TEST(CpuListTest, SortsMergesOverlapsAndIgnoresBlanks) {
+  EXPECT_EQ(parseCpuList(" 6-7 , 2-3,3, ,7\n"),
+            (std::vector<int>{2, 3, 6, 7}));
+  EXPECT_TRUE(parseCpuList("").empty());
+}
+
+TEST(CpuListTest, RejectsMalformedLists) {
+  EXPECT_THROW(static_cast<void>(parseCpuList("3-1")), std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(parseCpuList("a")), std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(parseCpuList("1-")), std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(parseCpuList("-1")), std::invalid_argument);
+}
+
+TEST(NumaTest, CurrentNodeIsKnownToTheTopology) {
+  const auto nodes{getNumaNodes()};
+  const auto node{getCurrentNumaNode()};
+
+  EXPECT_GE(node, 0);
+  if (!nodes.empty()) {
+    EXPECT_LT(static_cast<std::size_t>(node), nodes.size());
+  }
+}
+
+TEST(NumaTest, SharedPoolRecyclesBuffersOnTheSameNode) {
+  auto &pool{BufferPool::shared()};
+  EXPECT_EQ(&pool, &BufferPool::shared());
+
+  auto buffer{pool.acquire()};
+  const auto *const storage{buffer.get()};
+  pool.release(std::move(buffer));
+
+  EXPECT_EQ(pool.acquire().get(), storage);
+}
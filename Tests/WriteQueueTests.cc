@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "WriteQueue.h"
+
+using namespace webserver::net;
+
+namespace {
+
+// Socket whose send buffer takes at most `capacity` bytes between drains.
+class FakeSocket final : public ISocket {
+ public:
+  explicit FakeSocket(std::size_t capacity) : _capacity{capacity} {
+  }
+
+  void send(const std::string & /*data*/) override {
+    throw std::logic_error("blocking send used");
+  }
+  std::string receive() override {
+    return {};
+  }
+  void sendZeroCopyFile(std::filesystem::path /*filePath*/) override {
+    throw std::logic_error("blocking sendfile used");
+  }
+  void sendVectored(std::span<const std::string_view> /*parts*/) override {
+    throw std::logic_error("blocking writev used");
+  }
+  void sendFileWithHead(std::string_view /*head*/,
+                        std::filesystem::path /*filePath*/) override {
+    throw std::logic_error("blocking sendfile used");
+  }
+  void close() override {
+  }
+  void setTimeouts(const SocketTimeouts & /*timeouts*/) override {
+  }
+  void setRequestLimits(
+      const webserver::http::RequestLimits & /*limits*/) override {
+  }
+  int nativeHandle() const noexcept override {
+    return -1;
+  }
+  void setNonBlocking() override {
+  }
+  std::optional<std::size_t> receiveSome(std::span<char> /*buffer*/) override {
+    return std::nullopt;
+  }
+  std::uint32_t zeroCopyIssued() const noexcept override {
+    return _zeroCopyIssued;
+  }
+  std::uint32_t reapZeroCopyCompletions() override {
+    return zeroCopyCompleted;
+  }
+  std::optional<int> incomingCpu() const noexcept override {
+    return std::nullopt;
+  }
+  std::optional<IpAddress> peerAddress() const noexcept override {
+    return std::nullopt;
+  }
+
+  std::optional<std::size_t> sendSome(std::span<const char> data,
+                                      bool moreFollows) override {
+    const auto count{std::min(data.size(), _room())};
+    corkedSends += moreFollows ? 1 : 0;
+
+    if (count == 0) {
+      return std::nullopt;
+    }
+
+    sendStarts.push_back(data.data());
+    written.append(data.data(), count);
+    _zeroCopyIssued += _zeroCopyThreshold > 0 && count >= _zeroCopyThreshold;
+    return count;
+  }
+
+  std::optional<std::size_t> sendFileSome(int fileFd, std::int64_t &offset,
+                                          std::size_t count) override {
+    std::string chunk(std::min(count, _room()), '\0');
+
+    if (chunk.empty()) {
+      return std::nullopt;
+    }
+
+    const auto bytesRead{::pread(fileFd, chunk.data(), chunk.size(), offset)};
+    written.append(chunk.data(), bytesRead);
+    offset += bytesRead;
+    return static_cast<std::size_t>(bytesRead);
+  }
+
+  // Sends of at least `minSize` bytes count as zero-copy sends.
+  void enableZeroCopy(std::size_t minSize) {
+    _zeroCopyThreshold = minSize;
+  }
+
+  // Simulates the peer reading everything sent so far.
+  void drain() {
+    _drained = written.size();
+  }
+
+  std::string written;
+  std::vector<const char *> sendStarts;
+  int corkedSends{0};
+  std::uint32_t zeroCopyCompleted{0};
+
+ private:
+  [[nodiscard]] std::size_t _room() const {
+    return _capacity - (written.size() - _drained);
+  }
+
+  std::size_t _capacity;
+  std::size_t _drained{0};
+  std::size_t _zeroCopyThreshold{0};
+  std::uint32_t _zeroCopyIssued{0};
+};
+
+}  // namespace
+
+TEST(WriteQueueTest, FlushesEverythingWhenSocketHasRoom) {
+  FakeSocket socket{1024};
+  WriteQueue queue;
+
+  queue.pushBuffer("HTTP/1.1 200 OK\r\n\r\n");
+  queue.pushBuffer("body");
+
+  EXPECT_TRUE(queue.flush(socket));
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(socket.written, "HTTP/1.1 200 OK\r\n\r\nbody");
+}
+
+TEST(WriteQueueTest, ResumesAfterShortWrites) {
+  FakeSocket socket{4};
+  WriteQueue queue;
+
+  queue.pushBuffer("0123456789");
+
+  EXPECT_FALSE(queue.flush(socket));
+  EXPECT_EQ(queue.pendingBytes(), 6);
+
+  socket.drain();
+  EXPECT_FALSE(queue.flush(socket));
+  socket.drain();
+  EXPECT_TRUE(queue.flush(socket));
+
+  EXPECT_EQ(socket.written, "0123456789");
+  EXPECT_EQ(queue.pendingBytes(), 0);
+}
+
+TEST(WriteQueueTest, SendsBuffersAndFilesInOrder) {
+  const auto filePath{std::filesystem::temp_directory_path() /
+                      "write_queue_test.txt"};
+  std::ofstream{filePath} << "file contents";
+
+  FakeSocket socket{5};
+  WriteQueue queue;
+
+  queue.pushBuffer("head|");
+  queue.pushFile(filePath);
+  queue.pushBuffer("|tail");
+
+  while (!queue.flush(socket)) {
+    socket.drain();
+  }
+
+  EXPECT_EQ(socket.written, "head|file contents|tail");
+  EXPECT_GT(socket.corkedSends, 0);  // the head waited for the file
+  std::filesystem::remove(filePath);
+}
+
+TEST(WriteQueueTest, CountsOnlyInMemoryDataAsBuffered) {
+  const auto filePath{std::filesystem::temp_directory_path() /
+                      "write_queue_buffered_test.txt"};
+  std::ofstream{filePath} << "file contents";
+
+  FakeSocket socket{3};
+  WriteQueue queue;
+
+  queue.pushBuffer("head|");
+  queue.pushFile(filePath);
+
+  EXPECT_EQ(queue.pendingBytes(), 18);
+  EXPECT_EQ(queue.bufferedBytes(), 5);
+
+  EXPECT_FALSE(queue.flush(socket));
+  EXPECT_EQ(queue.bufferedBytes(), 2);
+
+  while (!queue.flush(socket)) {
+    socket.drain();
+  }
+
+  EXPECT_EQ(queue.pendingBytes(), 0);
+  EXPECT_EQ(queue.bufferedBytes(), 0);
+  std::filesystem::remove(filePath);
+}
+
+TEST(WriteQueueTest, HoldsZeroCopyBuffersUntilCompletion) {
+  FakeSocket socket{1024};
+  socket.enableZeroCopy(8);
+  WriteQueue queue;
+
+  queue.pushBuffer(std::string(64, 'x'));
+
+  EXPECT_FALSE(queue.flush(socket));  // sent, but still referenced
+  EXPECT_EQ(socket.written.size(), 64);
+  EXPECT_FALSE(queue.empty());
+
+  socket.zeroCopyCompleted = 1;
+  EXPECT_TRUE(queue.flush(socket));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(WriteQueueTest, DoesNotAppendToPartlySentZeroCopyBuffer) {
+  FakeSocket socket{16};
+  socket.enableZeroCopy(8);
+  WriteQueue queue;
+
+  queue.pushBuffer(std::string(64, 'x'));
+  EXPECT_FALSE(queue.flush(socket));
+
+  // Queued behind the stalled send; the first buffer must stay where the
+  // kernel is reading it.
+  queue.pushBuffer("tail");
+  socket.drain();
+  EXPECT_FALSE(queue.flush(socket));
+
+  ASSERT_EQ(socket.sendStarts.size(), 2);
+  EXPECT_EQ(socket.sendStarts[1], socket.sendStarts[0] + 16);
+
+  while (!queue.flush(socket)) {
+    socket.drain();
+    socket.zeroCopyCompleted = socket.zeroCopyIssued();
+  }
+
+  EXPECT_EQ(socket.written, std::string(64, 'x') + "tail");
+}
+
+TEST(WriteQueueTest, ClearKeepsBuffersOfZeroCopySendsInFlight) {
+  FakeSocket socket{16};
+  socket.enableZeroCopy(8);
+  WriteQueue queue;
+
+  queue.pushBuffer(std::string(64, 'x'));
+  queue.pushBuffer(std::string(4, 'y'));
+  EXPECT_FALSE(queue.flush(socket));
+
+  // The unsent rest is dropped, the partly sent buffer is still read.
+  queue.clear();
+  EXPECT_EQ(queue.pendingBytes(), 0);
+  EXPECT_FALSE(queue.empty());
+  EXPECT_FALSE(queue.releaseCompleted(socket));
+
+  socket.zeroCopyCompleted = socket.zeroCopyIssued();
+  EXPECT_TRUE(queue.releaseCompleted(socket));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(WriteQueueTest, ThrowsOnMissingFile) {
+  WriteQueue queue;
+
+  EXPECT_THROW(queue.pushFile("/nonexistent/file.txt"), std::runtime_error);
+  EXPECT_TRUE(queue.empty());
+}